@@ -1,4 +1,5 @@
 include (CMakeFindDependencyMacro)
 find_dependency (Boost 1.76.0)
 find_dependency (nlohmann_json)
+find_dependency (ZLIB)
 include ("${CMAKE_CURRENT_LIST_DIR}/RestServerTargets.cmake")
@@ -0,0 +1,62 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <cstdint>
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/filesystem.hpp>
+
+#include <rgpaul/AccessLog.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// what a session adds to every response - the record is queued, the drain thread writes it
+void logRecord(State& state)
+{
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+    {
+        AccessLog log(path.string());
+
+        AccessLog::Record record {};
+        record.address = AccessLog::addressBytes(boost::asio::ip::make_address("127.0.0.1"));
+        record.status = 200;
+
+        while (state.keepRunning())
+        {
+            ++record.timestamp;
+            log.log(record);
+        }
+
+        log.flush();
+        state.setCounter("dropped", static_cast<double>(log.metrics().dropped));
+    }
+
+    boost::filesystem::remove(path);
+}
+
+const bool registered = registerBenchmark("AccessLog/log", logRecord);
+}  // namespace
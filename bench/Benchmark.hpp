@@ -0,0 +1,88 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rgpaul
+{
+namespace bench
+{
+//! passed to every benchmark - the code inside of the keepRunning() loop is measured
+class State
+{
+  public:
+    State(std::size_t iterations, std::int64_t argument);
+
+    //! returns true as long as the measured loop should run - the time measurement starts with the first call
+    bool keepRunning();
+
+    //! the argument the benchmark was registered with (0 if there are none)
+    std::int64_t argument() const;
+
+    std::size_t iterations() const;
+    std::chrono::nanoseconds elapsed() const;
+
+    //! the number of bytes that were processed by all iterations - enables the throughput in the report
+    void setBytesProcessed(std::int64_t bytes);
+    std::int64_t bytesProcessed() const;
+
+    //! an additional value that is reported with the results (e.g. the cpu time per processed unit)
+    void setCounter(const std::string& name, double value);
+    const std::vector<std::pair<std::string, double>>& counters() const;
+
+  private:
+    std::size_t _iterations;
+    std::size_t _remaining;
+    std::int64_t _argument;
+    std::int64_t _bytesProcessed {0};
+    std::vector<std::pair<std::string, double>> _counters;
+    bool _started {false};
+
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _end;
+};
+
+using BenchmarkFunction = std::function<void(State&)>;
+
+//! registers a benchmark - with arguments the benchmark runs once per argument and "/<argument>" is added to the name
+bool registerBenchmark(const std::string& name, BenchmarkFunction function, std::vector<std::int64_t> arguments = {});
+
+//! prevents the compiler from optimizing away the computation of the given value
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+}  // namespace bench
+}  // namespace rgpaul
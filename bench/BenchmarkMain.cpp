@@ -0,0 +1,314 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <boost/log/core/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
+
+#include <rgpaul/UrlCodec.hpp>
+
+using namespace rgpaul::bench;
+
+namespace
+{
+struct RegisteredBenchmark
+{
+    std::string name;
+    BenchmarkFunction function;
+    std::int64_t argument;
+};
+
+std::vector<RegisteredBenchmark>& registry()
+{
+    static std::vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Result
+{
+    std::string name;
+    std::size_t iterations {0};
+    std::chrono::nanoseconds elapsed {0};
+    std::int64_t bytesProcessed {0};
+    std::vector<std::pair<std::string, double>> counters;
+
+    double nsPerOp() const
+    {
+        return static_cast<double>(elapsed.count()) / std::max<std::size_t>(iterations, 1);
+    }
+
+    double bytesPerSecond() const
+    {
+        if (elapsed.count() == 0)
+            return 0.0;
+
+        return static_cast<double>(bytesProcessed) * 1e9 / elapsed.count();
+    }
+};
+
+// runs the benchmark with a growing number of iterations until it took at least minTime
+Result runBenchmark(const RegisteredBenchmark& benchmark, std::chrono::nanoseconds minTime)
+{
+    Result result;
+    result.name = benchmark.name;
+    std::size_t iterations = 1;
+
+    while (true)
+    {
+        State state(iterations, benchmark.argument);
+        benchmark.function(state);
+
+        result.iterations = state.iterations();
+        result.elapsed = state.elapsed();
+        result.bytesProcessed = state.bytesProcessed();
+        result.counters = state.counters();
+
+        if (result.elapsed >= minTime || iterations >= 1000000000)
+            break;
+
+        // estimate the iterations we need - but grow at most by factor 10 for each run
+        double factor = 10.0;
+        if (result.elapsed.count() > 0)
+            factor = std::min(10.0, std::max(1.5, 1.4 * minTime.count() / result.elapsed.count()));
+
+        iterations = static_cast<std::size_t>(iterations * factor);
+    }
+
+    return result;
+}
+
+// the same layout google benchmark uses, so existing tooling for comparing runs can be used
+nlohmann::json toJson(const std::vector<Result>& results)
+{
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    const char* kernels[] = {"scalar", "sse2", "avx2"};
+
+    nlohmann::json json;
+    json["context"] = {{"date", date},
+                       {"library_version", APP_VERSION},
+                       {"num_cpus", std::thread::hardware_concurrency()},
+                       {"url_codec_kernel", kernels[static_cast<int>(rgpaul::UrlCodec::activeKernel())]}};
+
+    json["benchmarks"] = nlohmann::json::array();
+    for (const auto& result : results)
+    {
+        nlohmann::json entry = {{"name", result.name},
+                                {"iterations", result.iterations},
+                                {"real_time", result.nsPerOp()},
+                                {"time_unit", "ns"}};
+
+        if (result.bytesProcessed > 0)
+            entry["bytes_per_second"] = result.bytesPerSecond();
+
+        // user counters are stored next to the other values, like google benchmark does
+        for (const auto& counter : result.counters) entry[counter.first] = counter.second;
+
+        json["benchmarks"].push_back(entry);
+    }
+
+    return json;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// State
+// ---------------------------------------------------------------------------------------------------------------------
+
+State::State(std::size_t iterations, std::int64_t argument)
+    : _iterations(iterations), _remaining(iterations), _argument(argument)
+{
+}
+
+bool State::keepRunning()
+{
+    if (!_started)
+    {
+        _started = true;
+        _start = std::chrono::steady_clock::now();
+    }
+
+    if (_remaining > 0)
+    {
+        --_remaining;
+        return true;
+    }
+
+    _end = std::chrono::steady_clock::now();
+    return false;
+}
+
+std::int64_t State::argument() const
+{
+    return _argument;
+}
+
+std::size_t State::iterations() const
+{
+    return _iterations;
+}
+
+std::chrono::nanoseconds State::elapsed() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(_end - _start);
+}
+
+void State::setBytesProcessed(std::int64_t bytes)
+{
+    _bytesProcessed = bytes;
+}
+
+std::int64_t State::bytesProcessed() const
+{
+    return _bytesProcessed;
+}
+
+void State::setCounter(const std::string& name, double value)
+{
+    for (auto& counter : _counters)
+    {
+        if (counter.first == name)
+        {
+            counter.second = value;
+            return;
+        }
+    }
+
+    _counters.emplace_back(name, value);
+}
+
+const std::vector<std::pair<std::string, double>>& State::counters() const
+{
+    return _counters;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Registration
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool rgpaul::bench::registerBenchmark(const std::string& name, BenchmarkFunction function,
+                                      std::vector<std::int64_t> arguments)
+{
+    if (arguments.empty())
+    {
+        registry().push_back({name, std::move(function), 0});
+        return true;
+    }
+
+    for (std::int64_t argument : arguments)
+        registry().push_back({name + "/" + std::to_string(argument), function, argument});
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, const char** argv)
+{
+    boost::program_options::options_description description("The following parameters are available");
+    description.add_options()("filter", boost::program_options::value<std::string>(),
+                              "Only run benchmarks whose name contains the given string.")(
+        "min-time", boost::program_options::value<double>()->default_value(0.5),
+        "Minimum time in seconds every benchmark is measured.")(
+        "json", boost::program_options::value<std::string>(),
+        "Write the results as JSON to the given file (\"-\" for stdout).")("help", "Show all available options.");
+
+    boost::program_options::variables_map map;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, description), map);
+    boost::program_options::notify(map);
+
+    if (map.count("help"))
+    {
+        std::cout << description << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // the server benchmarks open and close many connections - only problems are logged
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+    std::string filter = map.count("filter") ? map["filter"].as<std::string>() : std::string();
+    auto minTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(map["min-time"].as<double>()));
+
+    std::string jsonFile = map.count("json") ? map["json"].as<std::string>() : std::string();
+
+    // with JSON on stdout the table goes to stderr
+    std::ostream& table = jsonFile == "-" ? std::cerr : std::cout;
+
+    table << std::left << std::setw(56) << "Benchmark" << std::right << std::setw(16) << "ns/op" << std::setw(14)
+          << "iterations" << std::setw(14) << "MB/s" << std::endl;
+
+    std::vector<Result> results;
+
+    for (const auto& benchmark : registry())
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+            continue;
+
+        Result result = runBenchmark(benchmark, minTime);
+
+        table << std::left << std::setw(56) << result.name << std::right << std::setw(16) << std::fixed
+              << std::setprecision(2) << result.nsPerOp() << std::setw(14) << result.iterations << std::setw(14);
+
+        if (result.bytesProcessed > 0)
+            table << result.bytesPerSecond() / 1e6;
+        else
+            table << "-";
+
+        for (const auto& counter : result.counters) table << "  " << counter.first << "=" << counter.second;
+        table << std::endl;
+
+        results.push_back(std::move(result));
+    }
+
+    if (jsonFile == "-")
+        std::cout << toJson(results).dump(2) << std::endl;
+    else if (!jsonFile.empty())
+    {
+        std::ofstream file(jsonFile);
+        if (!file)
+        {
+            std::cerr << "can't open " << jsonFile << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        file << toJson(results).dump(2) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <rgpaul/RestServer.hpp>
+#include <rgpaul/UrlCodec.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+const std::vector<std::int64_t> kSizes {16, 64, 256, 4096};
+
+// query string like input - mostly unreserved characters with some spaces, separators and utf-8
+std::string makePlainInput(std::int64_t size)
+{
+    static const std::string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_.~";
+    static const std::string special[] = {" ", "&", "=", "/", "\xc3\xa4", "?"};
+
+    std::mt19937 random(4711);
+    std::string input;
+
+    while (input.size() < static_cast<std::size_t>(size))
+    {
+        if (random() % 10 == 0)
+            input += special[random() % 6];
+        else
+            input += alphabet[random() % alphabet.size()];
+    }
+
+    input.resize(static_cast<std::size_t>(size));
+    return input;
+}
+
+std::string makeEncodedInput(std::int64_t size)
+{
+    return RestServer::urlEncode(makePlainInput(size));
+}
+
+void urlEncode(State& state)
+{
+    std::string input = makePlainInput(state.argument());
+
+    while (state.keepRunning())
+    {
+        std::string output = RestServer::urlEncode(input);
+        doNotOptimize(output);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.size()));
+}
+
+void urlDecode(State& state)
+{
+    std::string input = makeEncodedInput(state.argument());
+
+    while (state.keepRunning())
+    {
+        std::string output = RestServer::urlDecode(input);
+        doNotOptimize(output);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.size()));
+}
+
+// the buffer overloads reuse the capacity of the output string
+void urlEncodeBuffer(State& state)
+{
+    std::string input = makePlainInput(state.argument());
+    std::string output;
+
+    while (state.keepRunning())
+    {
+        RestServer::urlEncode(input, output);
+        doNotOptimize(output);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.size()));
+}
+
+void urlDecodeBuffer(State& state)
+{
+    std::string input = makeEncodedInput(state.argument());
+    std::string output;
+
+    while (state.keepRunning())
+    {
+        RestServer::urlDecode(input, output);
+        doNotOptimize(output);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.size()));
+}
+
+template <UrlCodec::Kernel kernel>
+void encodeKernel(State& state)
+{
+    std::string input = makePlainInput(state.argument());
+    std::vector<char> output(input.size() * 3);
+
+    while (state.keepRunning())
+    {
+        std::size_t length = UrlCodec::encode(input.data(), input.size(), output.data(), kernel);
+        doNotOptimize(length);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.size()));
+}
+
+template <UrlCodec::Kernel kernel>
+void decodeKernel(State& state)
+{
+    std::string input = makeEncodedInput(state.argument());
+    std::vector<char> output(input.size());
+
+    while (state.keepRunning())
+    {
+        std::size_t length = UrlCodec::decode(input.data(), input.size(), output.data(), kernel);
+        doNotOptimize(length);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.size()));
+}
+
+template <UrlCodec::Kernel kernel>
+bool registerKernel(const std::string& name)
+{
+    // kernels the cpu can't execute are skipped
+    if (!UrlCodec::isSupported(kernel))
+        return true;
+
+    return registerBenchmark("UrlCodec/encode/" + name, encodeKernel<kernel>, kSizes)
+           && registerBenchmark("UrlCodec/decode/" + name, decodeKernel<kernel>, kSizes);
+}
+
+const bool registered = registerBenchmark("RestServer/urlEncode", urlEncode, kSizes)
+                        && registerBenchmark("RestServer/urlDecode", urlDecode, kSizes)
+                        && registerBenchmark("RestServer/urlEncode/buffer", urlEncodeBuffer, kSizes)
+                        && registerBenchmark("RestServer/urlDecode/buffer", urlDecodeBuffer, kSizes)
+                        && registerKernel<UrlCodec::Kernel::scalar>("scalar")
+                        && registerKernel<UrlCodec::Kernel::sse2>("sse2")
+                        && registerKernel<UrlCodec::Kernel::avx2>("avx2");
+}  // namespace
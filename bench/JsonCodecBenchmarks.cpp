@@ -0,0 +1,122 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <rgpaul/JsonBody.hpp>
+#include <rgpaul/JsonCodec.hpp>
+#include <rgpaul/JsonOutput.hpp>
+#include <rgpaul/SessionArena.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// a document with about the given size as JSON text - mostly numbers, which the binary formats store compactly
+nlohmann::json makeDocument(std::int64_t size)
+{
+    nlohmann::json document = {{"user", {{"id", 42}, {"name", "test"}}}, {"items", nlohmann::json::array()}};
+    for (int i = 0; document.dump().size() < static_cast<std::size_t>(size); i += 16)
+    {
+        for (int j = i; j < i + 16; ++j)
+            document["items"].push_back({{"id", j}, {"name", "item " + std::to_string(j)}, {"price", j * 0.25}});
+    }
+
+    return document;
+}
+
+std::string encode(const nlohmann::json& document, JsonCodec::Format format)
+{
+    std::string output;
+    JsonOutput<std::string>::serialize(document, output, format);
+    return output;
+}
+
+// what sendResponse does: the document is serialized into an arena string
+void encodeDocument(State& state, JsonCodec::Format format)
+{
+    nlohmann::json document = makeDocument(state.argument());
+    SessionArena arena;
+    std::size_t size = 0;
+
+    while (state.keepRunning())
+    {
+        {
+            ArenaStringBody::value_type body {ArenaAllocator(&arena)};
+            JsonOutput<ArenaStringBody::value_type>::serialize(document, body, format);
+            size = body.size();
+            doNotOptimize(body.data());
+        }
+
+        arena.reset();
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    state.setCounter("bytes", static_cast<double>(size));
+}
+
+// what Request::json does: the body is parsed into the arena and a handler reads two fields of it
+void decodeDocument(State& state, JsonCodec::Format format)
+{
+    std::string data = encode(makeDocument(state.argument()), format);
+    SessionArena arena;
+
+    while (state.keepRunning())
+    {
+        {
+            JsonBody json(data, &arena, format);
+            std::optional<std::int64_t> id = json.at("/user/id").integer();
+            std::size_t items = json.at("/items").size();
+            doNotOptimize(id);
+            doNotOptimize(items);
+        }
+
+        arena.reset();
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * data.size()));
+    state.setCounter("bytes", static_cast<double>(data.size()));
+}
+
+const std::vector<std::int64_t> kSizes {1024, 64 * 1024, 1024 * 1024};
+
+const bool registered =
+    registerBenchmark("JsonCodec/encode/json", [](State& state) { encodeDocument(state, JsonCodec::Format::Json); },
+                      kSizes)
+    && registerBenchmark("JsonCodec/encode/cbor", [](State& state) { encodeDocument(state, JsonCodec::Format::Cbor); },
+                         kSizes)
+    && registerBenchmark("JsonCodec/encode/msgpack",
+                         [](State& state) { encodeDocument(state, JsonCodec::Format::MessagePack); }, kSizes)
+    && registerBenchmark("JsonCodec/decode/json", [](State& state) { decodeDocument(state, JsonCodec::Format::Json); },
+                         kSizes)
+    && registerBenchmark("JsonCodec/decode/cbor", [](State& state) { decodeDocument(state, JsonCodec::Format::Cbor); },
+                         kSizes)
+    && registerBenchmark("JsonCodec/decode/msgpack",
+                         [](State& state) { decodeDocument(state, JsonCodec::Format::MessagePack); }, kSizes);
+}  // namespace
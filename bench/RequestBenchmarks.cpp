@@ -0,0 +1,95 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <rgpaul/JsonBody.hpp>
+#include <rgpaul/SessionArena.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// a request body of about the given size - a handler reads two fields of it
+std::string makeBody(std::int64_t size)
+{
+    nlohmann::json body = {{"user", {{"id", 42}, {"name", "test"}}}, {"items", nlohmann::json::array()}};
+    for (int i = 0; body.dump().size() < static_cast<std::size_t>(size); i += 16)
+    {
+        for (int j = i; j < i + 16; ++j)
+            body["items"].push_back({{"id", j}, {"name", "item " + std::to_string(j)}, {"price", j * 0.25}});
+    }
+
+    return body.dump();
+}
+
+// the full DOM: nlohmann::json::parse
+void parseDom(State& state)
+{
+    std::string text = makeBody(state.argument());
+
+    while (state.keepRunning())
+    {
+        nlohmann::json json = nlohmann::json::parse(text);
+        std::int64_t id = json["/user/id"_json_pointer].get<std::int64_t>();
+        std::size_t items = json["items"].size();
+        doNotOptimize(id);
+        doNotOptimize(items);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+// the SAX pass of Request::json into the arena of a session
+void parseJsonBody(State& state)
+{
+    std::string text = makeBody(state.argument());
+    SessionArena arena;
+
+    while (state.keepRunning())
+    {
+        {
+            JsonBody json(text, &arena);
+            std::optional<std::int64_t> id = json.at("/user/id").integer();
+            std::size_t items = json.at("/items").size();
+            doNotOptimize(id);
+            doNotOptimize(items);
+        }
+
+        arena.reset();
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+const std::vector<std::int64_t> kSizes {1024, 64 * 1024, 1024 * 1024};
+
+const bool registered = registerBenchmark("Request/json/dom", parseDom, kSizes)
+                        && registerBenchmark("Request/json/lazy", parseJsonBody, kSizes);
+}  // namespace
@@ -0,0 +1,222 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rgpaul/RestServer.hpp>
+#include <rgpaul/Router.hpp>
+#include <rgpaul/UriNode.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+struct RouteSet
+{
+    std::vector<std::string> patterns;
+    std::vector<std::string> targets;
+};
+
+using RouteGenerator = RouteSet (*)(std::int64_t);
+
+// a mix of static and placeholder routes together with a matching target for each of them
+RouteSet makeMixedRoutes(std::int64_t count)
+{
+    RouteSet routes;
+
+    for (std::int64_t i = 0; i < count; ++i)
+    {
+        std::string id = std::to_string(i);
+        std::string service = "/svc" + std::to_string(i % 16);
+
+        switch (i % 4)
+        {
+            case 0:
+                routes.patterns.push_back(service + "/resource" + id);
+                routes.targets.push_back(service + "/resource" + id);
+                break;
+            case 1:
+                routes.patterns.push_back(service + "/resource" + id + "/$");
+                routes.targets.push_back(service + "/resource" + id + "/8a2f61c4");
+                break;
+            case 2:
+                routes.patterns.push_back(service + "/resource" + id + "/$/detail");
+                routes.targets.push_back(service + "/resource" + id + "/12345/detail?verbose=1");
+                break;
+            default:
+                routes.patterns.push_back("/api/v1/$/resource" + id + "/items");
+                routes.targets.push_back("/api/v1/tenant42/resource" + id + "/items");
+                break;
+        }
+    }
+
+    return routes;
+}
+
+// one static segment per route - the root has a huge fan-out
+RouteSet makeShallowRoutes(std::int64_t count)
+{
+    RouteSet routes;
+
+    for (std::int64_t i = 0; i < count; ++i)
+    {
+        routes.patterns.push_back("/resource" + std::to_string(i));
+        routes.targets.push_back(routes.patterns.back());
+    }
+
+    return routes;
+}
+
+// long static prefixes with the distinguishing segment in the middle
+RouteSet makeDeepRoutes(std::int64_t count)
+{
+    RouteSet routes;
+
+    for (std::int64_t i = 0; i < count; ++i)
+    {
+        std::string group = std::to_string(i % 8);
+        routes.patterns.push_back("/api/v2/organizations/group" + group + "/projects/p" + std::to_string(i)
+                                  + "/repositories/branches/commits/files");
+        routes.targets.push_back(routes.patterns.back());
+    }
+
+    return routes;
+}
+
+// most segments are placeholders, so lookups have to capture and sometimes backtrack
+RouteSet makeWildcardRoutes(std::int64_t count)
+{
+    RouteSet routes;
+
+    for (std::int64_t i = 0; i < count; ++i)
+    {
+        std::string id = std::to_string(i);
+        routes.patterns.push_back("/tenants/$/users/$/r" + id + "/$");
+        routes.targets.push_back("/tenants/acme/users/4711/r" + id + "/0x1f");
+    }
+
+    return routes;
+}
+
+// the mixed routes - but none of the targets leads to an endpoint
+RouteSet makeMissRoutes(std::int64_t count)
+{
+    RouteSet routes = makeMixedRoutes(count);
+
+    for (auto& target : routes.targets)
+    {
+        std::size_t pos = target.find('?');
+        target.insert(pos == std::string::npos ? target.size() : pos, "/missing");
+    }
+
+    return routes;
+}
+
+std::shared_ptr<UriNode> createUriNodes(const RouteSet& routes)
+{
+    std::shared_ptr<UriNode> rootNode = UriNode::createRootNode();
+    for (const auto& pattern : routes.patterns)
+        rootNode->createNodeForPath(RestServer::splitUri(pattern))->setCallback([](auto, const auto&) {});
+
+    return rootNode;
+}
+
+// the way RestServer looked up endpoints before the router existed
+template <RouteGenerator generator>
+void uriNodeFind(State& state)
+{
+    RouteSet routes = generator(state.argument());
+    std::shared_ptr<UriNode> rootNode = createUriNodes(routes);
+
+    std::size_t index = 0;
+    while (state.keepRunning())
+    {
+        std::string target = routes.targets[index];
+        std::shared_ptr<UriNode> node = rootNode->findNodeForPath(RestServer::splitUri(target));
+        doNotOptimize(node);
+
+        if (++index == routes.targets.size())
+            index = 0;
+    }
+}
+
+template <RouteGenerator generator>
+void uriNodeCreate(State& state)
+{
+    RouteSet routes = generator(state.argument());
+
+    while (state.keepRunning())
+    {
+        std::shared_ptr<UriNode> rootNode = createUriNodes(routes);
+        doNotOptimize(rootNode);
+    }
+}
+
+template <RouteGenerator generator>
+void routerFind(State& state)
+{
+    RouteSet routes = generator(state.argument());
+    Router router(routes.patterns);
+
+    PathParameters parameters;
+    std::size_t index = 0;
+    while (state.keepRunning())
+    {
+        std::size_t route = router.findRoute(routes.targets[index], parameters);
+        doNotOptimize(route);
+
+        if (++index == routes.targets.size())
+            index = 0;
+    }
+}
+
+template <RouteGenerator generator>
+void routerBuild(State& state)
+{
+    RouteSet routes = generator(state.argument());
+
+    while (state.keepRunning())
+    {
+        Router router(routes.patterns);
+        doNotOptimize(router);
+    }
+}
+
+template <RouteGenerator generator>
+bool registerScenario(const std::string& scenario)
+{
+    std::vector<std::int64_t> sizes {10, 1000, 10000};
+
+    return registerBenchmark("UriNode/create/" + scenario, uriNodeCreate<generator>, sizes)
+           && registerBenchmark("UriNode/find/" + scenario, uriNodeFind<generator>, sizes)
+           && registerBenchmark("Router/build/" + scenario, routerBuild<generator>, sizes)
+           && registerBenchmark("Router/find/" + scenario, routerFind<generator>, sizes);
+}
+
+const bool registered = registerScenario<makeMixedRoutes>("mixed") && registerScenario<makeShallowRoutes>("shallow")
+                        && registerScenario<makeDeepRoutes>("deep") && registerScenario<makeWildcardRoutes>("wildcard")
+                        && registerScenario<makeMissRoutes>("miss");
+}  // namespace
@@ -0,0 +1,238 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/filesystem.hpp>
+
+#include <rgpaul/RestServer.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// keep-alive connections per server thread - every connection is driven by a client thread of its own
+constexpr std::int64_t kConnectionsPerThread = 2;
+
+// requests every client sends before it reads the responses
+constexpr std::size_t kPipelineDepth = 4;
+
+// sends the given number of requests over one keep-alive connection
+void runClient(unsigned short port, std::size_t requests)
+{
+    boost::asio::io_context ioc;
+    boost::beast::tcp_stream stream(ioc);
+    stream.connect({boost::asio::ip::make_address("127.0.0.1"), port});
+    stream.socket().set_option(boost::asio::ip::tcp::no_delay(true));
+
+    std::string batch;
+    for (std::size_t i = 0; i < kPipelineDepth; ++i)
+        batch += "GET /items/42 HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+
+    boost::beast::flat_buffer buffer;
+
+    while (requests > 0)
+    {
+        std::size_t count = std::min(requests, kPipelineDepth);
+        boost::asio::write(stream, boost::asio::buffer(batch.data(), count * batch.size() / kPipelineDepth));
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            boost::beast::http::response<boost::beast::http::string_body> response;
+            boost::beast::http::read(stream, buffer, response);
+            doNotOptimize(response);
+        }
+
+        requests -= count;
+    }
+}
+
+// every iteration is one request - the clients share the iterations
+void serve(State& state, RestServer::ExecutionModel model)
+{
+    auto threads = static_cast<unsigned short>(state.argument());
+
+    auto restServer = std::make_shared<RestServer>("127.0.0.1", 0);
+    restServer->setExecutionModel(model);
+    restServer->registerEndpoint("/items/{id}", [](std::shared_ptr<Session> session, const Request& request) {
+        session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+    });
+    restServer->startListening(threads);
+
+    std::size_t connections = std::min<std::size_t>(threads * kConnectionsPerThread, state.iterations());
+
+    // starts the time measurement - the remaining iterations are counted down after the clients are done
+    state.keepRunning();
+
+    std::vector<std::thread> clients;
+    for (std::size_t i = 0; i < connections; ++i)
+    {
+        std::size_t requests = state.iterations() / connections + (i < state.iterations() % connections ? 1 : 0);
+        clients.emplace_back(runClient, restServer->port(), requests);
+    }
+
+    for (auto& client : clients) client.join();
+
+    while (state.keepRunning())
+    {
+    }
+
+    restServer->stop();
+}
+
+void sharedContext(State& state)
+{
+    serve(state, RestServer::ExecutionModel::SharedContext);
+}
+
+void contextPerThread(State& state)
+{
+    serve(state, RestServer::ExecutionModel::ContextPerThread);
+}
+
+// the cpu time of the process or the calling thread in nanoseconds (0 where it can't be measured)
+std::int64_t cpuTime(bool thread)
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec time {};
+    clock_gettime(thread ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID, &time);
+    return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+// downloads the file the given number of times over one keep-alive connection - returns the cpu time of the client
+std::int64_t downloadFile(unsigned short port, std::size_t downloads)
+{
+    std::int64_t start = cpuTime(true);
+
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::socket socket(ioc);
+    socket.connect({boost::asio::ip::make_address("127.0.0.1"), port});
+
+    const std::string request = "GET /file HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    boost::beast::flat_buffer buffer;
+    std::vector<char> body(256 * 1024);
+
+    for (std::size_t i = 0; i < downloads; ++i)
+    {
+        boost::asio::write(socket, boost::asio::buffer(request));
+
+        boost::beast::http::response_parser<boost::beast::http::buffer_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        boost::beast::http::read_header(socket, buffer, parser);
+
+        // the start of the body may have been read with the header
+        std::uint64_t remaining = parser.content_length().value_or(0);
+        std::size_t buffered = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(), remaining));
+        buffer.consume(buffered);
+        remaining -= buffered;
+
+        while (remaining > 0)
+        {
+            std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, body.size()));
+            remaining -= socket.read_some(boost::asio::buffer(body.data(), chunk));
+        }
+    }
+
+    return cpuTime(true) - start;
+}
+
+// every iteration downloads a file of <argument> MiB - reports the cpu time the server needs for every GB it sends
+void sendFile(State& state, bool zeroCopy)
+{
+    auto size = static_cast<std::size_t>(state.argument()) * 1024 * 1024;
+
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("rgp-bench-%%%%-%%%%.bin");
+    {
+        boost::beast::error_code ec;
+        boost::beast::file file;
+        file.open(path.string().c_str(), boost::beast::file_mode::write, ec);
+
+        std::string block(1024 * 1024, 'x');
+        for (std::size_t written = 0; written < size; written += block.size())
+            file.write(block.data(), block.size(), ec);
+    }
+
+    auto restServer = std::make_shared<RestServer>("127.0.0.1", 0);
+    restServer->setZeroCopyFiles(zeroCopy);
+    restServer->registerEndpoint("/file", [&path](std::shared_ptr<Session> session, const Request&) {
+        session->sendFile(path.string());
+    });
+    restServer->startListening(1);
+
+    // the cpu time of the client is the same for both variants - it is subtracted
+    std::int64_t processStart = cpuTime(false);
+    state.keepRunning();
+
+    std::int64_t clientTime = 0;
+    std::thread client([&] { clientTime = downloadFile(restServer->port(), state.iterations()); });
+    client.join();
+
+    while (state.keepRunning())
+    {
+    }
+
+    std::int64_t serverTime = cpuTime(false) - processStart - clientTime;
+
+    restServer->stop();
+
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+
+    double gigabytes = static_cast<double>(state.iterations()) * size / 1e9;
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    state.setCounter("server_cpu_ms_per_GB", serverTime / 1e6 / gigabytes);
+}
+
+void sendFileZeroCopy(State& state)
+{
+    sendFile(state, true);
+}
+
+void sendFileBuffered(State& state)
+{
+    sendFile(state, false);
+}
+
+const std::vector<std::int64_t> kThreads {1, 2, 4, 8, 16};
+const std::vector<std::int64_t> kFileSizes {1, 64};
+
+const bool registered = registerBenchmark("ExecutionModel/sharedContext", sharedContext, kThreads) &&
+                        registerBenchmark("ExecutionModel/contextPerThread", contextPerThread, kThreads) &&
+                        registerBenchmark("SendFile/zeroCopy", sendFileZeroCopy, kFileSizes) &&
+                        registerBenchmark("SendFile/buffered", sendFileBuffered, kFileSizes);
+}  // namespace
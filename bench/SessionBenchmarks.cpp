@@ -0,0 +1,165 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/beast/version.hpp>
+#include <nlohmann/json.hpp>
+
+#include <rgpaul/HeaderTemplates.hpp>
+#include <rgpaul/JsonOutput.hpp>
+#include <rgpaul/Session.hpp>
+#include <rgpaul/SessionArena.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// typical static file requests - the last ones need the whole extension table
+const std::vector<std::string> kPaths {"/index.html", "/js/app.min.js",  "/css/style.css", "/img/logo.png",
+                                       "/data.json",  "/fonts/font.svg", "/downloads/file.tar",
+                                       "/README"};
+
+void mimeType(State& state)
+{
+    std::size_t index = 0;
+    while (state.keepRunning())
+    {
+        boost::beast::string_view type = Session::mimeType(kPaths[index]);
+        doNotOptimize(type);
+
+        if (++index == kPaths.size())
+            index = 0;
+    }
+}
+
+// the header of a small JSON response built and serialized by beast
+void serializeHeader(State& state)
+{
+    SessionArena arena;
+    const std::string body = "{\"id\":\"42\"}";
+
+    while (state.keepRunning())
+    {
+        {
+            ArenaAllocator allocator(&arena);
+            boost::beast::http::response<ArenaStringBody, ArenaFields> response(boost::beast::http::status::ok, 11,
+                                                                                allocator, allocator);
+            response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
+            response.set(boost::beast::http::field::content_type, "application/json");
+            response.keep_alive(true);
+            response.body().assign(body.data(), body.size());
+            response.prepare_payload();
+
+            boost::beast::http::response_serializer<ArenaStringBody, ArenaFields> serializer(response);
+            serializer.split(true);
+
+            std::size_t size = 0;
+            boost::beast::error_code ec;
+            serializer.next(ec, [&size](boost::beast::error_code&, const auto& buffers) {
+                size = boost::asio::buffer_size(buffers);
+            });
+            doNotOptimize(size);
+        }
+
+        arena.reset();
+    }
+}
+
+// the same header from a pre-serialized block
+void headerTemplate(State& state)
+{
+    const std::string body = "{\"id\":\"42\"}";
+    char fields[HeaderTemplates::kMaxFieldsSize];
+
+    while (state.keepRunning())
+    {
+        std::string_view prefix = HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json");
+        std::size_t size = prefix.size() + HeaderTemplates::writeFields(fields, body.size(), 11, true);
+        doNotOptimize(size);
+    }
+}
+
+// a JSON array with the given number of small objects
+nlohmann::json makeItems(std::int64_t count)
+{
+    nlohmann::json items = nlohmann::json::array();
+    for (std::int64_t i = 0; i < count; ++i) items.push_back({{"id", i}, {"name", "item"}, {"active", i % 2 == 0}});
+    return items;
+}
+
+// the JSON body as it was built before: dump into a temporary string that is copied into the body
+void dumpBody(State& state)
+{
+    nlohmann::json items = makeItems(state.argument());
+    SessionArena arena;
+    std::size_t size = 0;
+
+    while (state.keepRunning())
+    {
+        {
+            ArenaStringBody::value_type body {ArenaAllocator(&arena)};
+            std::string dumped = items.dump();
+            body.assign(dumped.data(), dumped.size());
+            size = body.size();
+            doNotOptimize(body.data());
+        }
+
+        arena.reset();
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+// the JSON body as sendResponse builds it: serialized directly into the memory of the session
+void serializeBody(State& state)
+{
+    nlohmann::json items = makeItems(state.argument());
+    SessionArena arena;
+    std::size_t size = 0;
+
+    while (state.keepRunning())
+    {
+        {
+            ArenaStringBody::value_type body {ArenaAllocator(&arena)};
+            body.reserve(size);
+            JsonOutput<ArenaStringBody::value_type>::serialize(items, body);
+            size = body.size();
+            doNotOptimize(body.data());
+        }
+
+        arena.reset();
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+const bool registered = registerBenchmark("Session/mimeType", mimeType)
+                        && registerBenchmark("Session/serializeHeader", serializeHeader)
+                        && registerBenchmark("Session/headerTemplate", headerTemplate)
+                        && registerBenchmark("Session/jsonBody/dump", dumpBody, {10, 1000, 100000})
+                        && registerBenchmark("Session/jsonBody/serialize", serializeBody, {10, 1000, 100000});
+}  // namespace
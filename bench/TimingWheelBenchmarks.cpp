@@ -0,0 +1,90 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <rgpaul/TimingWheel.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// what a keep-alive connection does for every request: its deadline is moved (the argument is the number of open
+// connections on the thread)
+void wheelRearm(State& state)
+{
+    boost::asio::io_context context;
+    std::vector<std::unique_ptr<TimingWheel::Deadline>> deadlines;
+
+    for (std::int64_t i = 0; i < state.argument(); ++i)
+    {
+        deadlines.push_back(std::make_unique<TimingWheel::Deadline>());
+        deadlines.back()->expiresAfter(context, std::chrono::seconds(30));
+    }
+
+    std::size_t index = 0;
+    while (state.keepRunning())
+    {
+        deadlines[index]->expiresNever();
+        deadlines[index]->expiresAfter(context, std::chrono::seconds(30));
+        index = (index + 1) % deadlines.size();
+    }
+}
+
+// the same with a timer per connection that is canceled and started again
+void timerRearm(State& state)
+{
+    boost::asio::io_context context;
+    std::vector<std::unique_ptr<boost::asio::steady_timer>> timers;
+
+    for (std::int64_t i = 0; i < state.argument(); ++i)
+    {
+        timers.push_back(std::make_unique<boost::asio::steady_timer>(context));
+        timers.back()->expires_after(std::chrono::seconds(30));
+        timers.back()->async_wait([](auto) {});
+    }
+
+    std::size_t index = 0;
+    while (state.keepRunning())
+    {
+        timers[index]->expires_after(std::chrono::seconds(30));
+        timers[index]->async_wait([](auto) {});
+        index = (index + 1) % timers.size();
+
+        // the canceled waits are completed
+        context.poll();
+    }
+}
+
+const std::vector<std::int64_t> kConnections {16, 1024, 16384};
+
+const bool registered = registerBenchmark("TimingWheel/rearm/wheel", wheelRearm, kConnections)
+                        && registerBenchmark("TimingWheel/rearm/steady_timer", timerRearm, kConnections);
+}  // namespace
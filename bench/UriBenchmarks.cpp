@@ -0,0 +1,57 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include "Benchmark.hpp"
+
+#include <string>
+#include <vector>
+
+#include <rgpaul/RestServer.hpp>
+
+using namespace rgpaul;
+using namespace rgpaul::bench;
+
+namespace
+{
+// targets with the given number of segments (the last one with a query)
+std::string makeTarget(std::int64_t segments)
+{
+    std::string target;
+    for (std::int64_t i = 0; i < segments; ++i) target += "/segment" + std::to_string(i);
+
+    return target + "/?sort=asc&limit=20";
+}
+
+void splitUri(State& state)
+{
+    std::string target = makeTarget(state.argument());
+
+    while (state.keepRunning())
+    {
+        std::vector<std::string> segments = RestServer::splitUri(target);
+        doNotOptimize(segments);
+    }
+
+    state.setBytesProcessed(static_cast<std::int64_t>(state.iterations() * target.size()));
+}
+
+const bool registered = registerBenchmark("RestServer/splitUri", splitUri, {1, 4, 16});
+}  // namespace
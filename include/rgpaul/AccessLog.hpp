@@ -0,0 +1,154 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+
+namespace rgpaul
+{
+//! An access log that keeps the i/o threads off the file.
+//! Every thread that logs writes fixed-size binary records into a lock-free ring of its own, a background thread
+//! drains the rings to the file every 100 ms. A record that doesn't fit into the ring of its thread is dropped and
+//! counted. The file starts with a header followed by the records in the byte order of the machine - read and format
+//! it with read and format (e.g. `sample --format-access-log <file>`).
+class AccessLog
+{
+  public:
+    //! the records a thread can queue between two drains (1 MiB per thread)
+    static constexpr std::size_t kRingSize = 16384;
+
+    //! how often the rings are drained
+    static constexpr std::chrono::milliseconds kDrainInterval {100};
+
+    //! one answered request
+    struct Record
+    {
+        //! microseconds since the unix epoch when the response was written
+        std::uint64_t timestamp;
+
+        //! microseconds from the first byte of the request until the response was written
+        std::uint64_t latency;
+
+        //! the bytes of the response (header and body)
+        std::uint64_t bytes;
+
+        //! the address of the client as IPv6 (IPv4 addresses are mapped)
+        std::array<std::uint8_t, 16> address;
+
+        //! the index of the endpoint in the route table (Request::kNoRoute if no endpoint was found)
+        std::uint32_t route;
+
+        std::uint16_t port;
+        std::uint16_t status;
+
+        //! boost::beast::http::verb
+        std::uint8_t method;
+
+        std::array<std::uint8_t, 15> reserved;
+    };
+
+    static_assert(sizeof(Record) == 64, "a record fills a cache line");
+
+    struct Metrics
+    {
+        //! records that were written to the file
+        std::uint64_t written;
+
+        //! records that were dropped because the ring of their thread was full
+        std::uint64_t dropped;
+    };
+
+    //! opens the file for appending and starts the drain thread - the records are discarded if the file can't be
+    //! opened
+    explicit AccessLog(const std::string& path);
+
+    //! drains the rings a last time
+    ~AccessLog();
+
+    AccessLog(const AccessLog&) = delete;
+    AccessLog& operator=(const AccessLog&) = delete;
+
+    //! queues the record in the ring of the calling thread - it never blocks
+    void log(const Record& record);
+
+    //! writes the queued records to the file right away
+    void flush();
+
+    bool isOpen() const;
+    Metrics metrics() const;
+
+    //! reads the records of a log file (empty if it isn't one)
+    static std::vector<Record> read(const std::string& path);
+
+    //! a line of text, e.g. "2020-05-01T12:00:00.000123Z 127.0.0.1:54321 GET /3 200 128 B 52 us"
+    //! (the route is "-" if no endpoint was found)
+    static std::string format(const Record& record);
+
+    static std::array<std::uint8_t, 16> addressBytes(const boost::asio::ip::address& address);
+    static boost::asio::ip::address address(const Record& record);
+
+  private:
+    // a single producer single consumer queue - the thread of the ring pushes, the drain thread pops
+    struct Ring
+    {
+        std::array<Record, kRingSize> records;
+        alignas(64) std::atomic<std::uint64_t> head {0};
+        alignas(64) std::atomic<std::uint64_t> tail {0};
+    };
+
+    // identifies the log in the cache of the threads (an address could be reused by the next log)
+    std::uint64_t _id;
+
+    std::ofstream _file;
+
+    std::mutex _ringsMutex;
+    std::map<std::thread::id, std::shared_ptr<Ring>> _rings;
+
+    // serializes the drains of the drain thread and flush
+    std::mutex _drainMutex;
+    std::condition_variable _wakeup;
+    bool _stopping {false};
+    std::thread _drainer;
+
+    std::atomic<std::uint64_t> _written {0};
+    std::atomic<std::uint64_t> _dropped {0};
+
+    Ring& localRing();
+
+    // called with the drain mutex locked
+    void drain();
+};
+}  // namespace rgpaul
@@ -0,0 +1,73 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rgpaul
+{
+//! The byte ranges of a Range header ("bytes=0-499, 1000-, -500") resolved against the size of a representation.
+//! Overlapping and adjacent ranges are merged, so the ranges are sorted and disjoint.
+class ByteRanges
+{
+  public:
+    //! the first and the last byte of a range (both inclusive)
+    struct Range
+    {
+        std::uint64_t first;
+        std::uint64_t last;
+
+        std::uint64_t size() const { return last - first + 1; }
+    };
+
+    enum class Result
+    {
+        //! no valid byte ranges - the whole representation is sent
+        Ignored,
+
+        //! ranges contains the parts that are sent with "206 Partial Content"
+        Satisfiable,
+
+        //! none of the ranges overlaps the representation - "416 Range Not Satisfiable"
+        Unsatisfiable
+    };
+
+    //! requests with more ranges get the whole representation (there is no use in many small ranges, but they are
+    //! expensive to send)
+    static constexpr std::size_t kMaxRanges = 16;
+
+    static Result parse(std::string_view header, std::uint64_t size, std::vector<Range>& ranges);
+
+    //! true if the ranges of a request can be applied - If-Range has to match the entity tag (strong comparison) or
+    //! the modification date of the representation exactly (an empty If-Range always matches)
+    static bool ifRangeMatches(std::string_view ifRange, std::string_view etag, std::time_t modified);
+
+    //! the value of a Content-Range header - "bytes 0-499/1234" or "bytes */1234" without a range
+    static std::string contentRange(const Range& range, std::uint64_t size);
+    static std::string contentRange(std::uint64_t size);
+};
+}  // namespace rgpaul
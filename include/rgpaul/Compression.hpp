@@ -0,0 +1,86 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace rgpaul
+{
+//! Content codings of responses (RestServer::setCompression).
+//! Bodies are compressed with gzip or deflate (zlib) - brotli and zstd are only sent as precompressed files that lie
+//! next to the requested one ("<path>.br", "<path>.zst", "<path>.gz").
+class Compression
+{
+  public:
+    enum class Encoding
+    {
+        Identity,
+        Gzip,
+        Deflate,
+        Brotli,
+        Zstd
+    };
+
+    struct Settings
+    {
+        //! the zlib level from 1 (fastest) to 9 (smallest) - 0 disables the compression of responses
+        int level {0};
+
+        //! smaller bodies are sent as they are
+        std::size_t minSize {1024};
+
+        //! larger bodies are compressed on the worker pool instead of the i/o thread
+        std::size_t offloadSize {256 * 1024};
+
+        //! sendFile looks for precompressed siblings of a file if the client accepts their encoding
+        bool precompressed {true};
+    };
+
+    //! the encodings of precompressed files in the order they are preferred if the client accepts several equally
+    static constexpr Encoding kPrecompressed[] = {Encoding::Brotli, Encoding::Zstd, Encoding::Gzip};
+
+    //! the token of the encoding in Accept-Encoding and Content-Encoding
+    static std::string_view name(Encoding encoding);
+
+    //! the extension of a precompressed file - empty for identity and deflate
+    static std::string_view extension(Encoding encoding);
+
+    //! the quality the client assigned to the encoding in Accept-Encoding from 0 (not acceptable) to 1000 -
+    //! identity is acceptable unless it is excluded explicitly
+    static int quality(std::string_view acceptEncoding, Encoding encoding);
+
+    //! the quality an encoding needs to be sent instead of identity - the weight of identity if the client names it
+    //! (or *), 0 otherwise
+    static int minimumQuality(std::string_view acceptEncoding);
+
+    //! returns the candidate with the highest quality (the first one on ties) or Identity if none is acceptable or
+    //! the client prefers identity
+    static Encoding negotiate(std::string_view acceptEncoding, std::initializer_list<Encoding> candidates);
+
+    //! compresses the data with gzip or deflate (zlib format) into output - false if it failed or the encoding isn't
+    //! supported (the zlib streams are reused by every thread)
+    static bool compress(std::string_view data, Encoding encoding, int level, std::string& output);
+};
+}  // namespace rgpaul
@@ -0,0 +1,125 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+
+namespace rgpaul
+{
+//! Admission control for incoming connections.
+//! An acceptor reserves a connection before it accepts the next one. At the global limit the reservation fails and the
+//! acceptor pauses - the connections wait in the backlog of the kernel until a session is closed and the acceptor is
+//! resumed. Connections from an address that already has the maximum number of connections are rejected after the
+//! accept (the address isn't known before).
+class ConnectionLimiter : public std::enable_shared_from_this<ConnectionLimiter>
+{
+  public:
+    //! 0 means unlimited
+    struct Limits
+    {
+        std::size_t connections {0};
+        std::size_t connectionsPerAddress {0};
+    };
+
+    struct Metrics
+    {
+        //! the connections that are currently open
+        std::size_t connections {0};
+
+        //! connections that were closed right after the accept because their address had too many connections
+        std::uint64_t rejected {0};
+
+        //! how often an acceptor was paused at the global limit (the connections waited in the backlog meanwhile)
+        std::uint64_t deferred {0};
+    };
+
+    //! an admitted connection - it is released when the ticket is destroyed (together with its session)
+    class Ticket
+    {
+      public:
+        Ticket() = default;
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&& other) noexcept;
+        ~Ticket();
+
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        //! false if the connection was rejected
+        explicit operator bool() const;
+
+      private:
+        friend ConnectionLimiter;
+
+        std::shared_ptr<ConnectionLimiter> _limiter;
+        boost::asio::ip::address _address;
+    };
+
+    //! without limits the connections are only counted
+    ConnectionLimiter();
+    explicit ConnectionLimiter(Limits limits);
+
+    //! reserves a connection for the next accept - at the global limit false is returned and resume is called once
+    //! (from the thread that releases a connection) when the acceptor should try again
+    bool reserve(std::function<void()> resume);
+
+    //! gives back a reservation that didn't lead to a connection (e.g. the accept failed)
+    void cancel();
+
+    //! turns the reservation into a connection from the given address - the ticket is empty if the address has too
+    //! many connections (the reservation is given back then)
+    Ticket admit(const boost::asio::ip::address& address);
+
+    const Limits& limits() const;
+    Metrics metrics() const;
+
+  private:
+    const Limits _limits;
+
+    mutable std::mutex _mutex;
+
+    // connections and reservations of the acceptors
+    std::size_t _reserved {0};
+    std::size_t _connections {0};
+    std::uint64_t _rejected {0};
+    std::uint64_t _deferred {0};
+
+    // only maintained with a limit per address
+    std::map<boost::asio::ip::address, std::size_t> _addressConnections;
+
+    // the acceptors that wait for a free connection
+    std::vector<std::function<void()>> _paused;
+
+    void release(const boost::asio::ip::address& address);
+
+    // gives back a reservation - returns the acceptor that should be resumed (if there is one)
+    std::function<void()> freeReservation();
+};
+}  // namespace rgpaul
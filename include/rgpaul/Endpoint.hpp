@@ -0,0 +1,83 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <rgpaul/Request.hpp>
+
+namespace rgpaul
+{
+class Session;
+
+using RestServerCallback = std::function<void(std::shared_ptr<Session>, const Request&)>;
+
+//! the callbacks of an endpoint that receives the body of its requests in chunks
+//! (RestServer::registerStreamingEndpoint)
+struct StreamCallbacks
+{
+    //! called with the header of the request (the body of the request is empty) - returns false if the request is
+    //! rejected, the callback has to answer it then and the connection is closed after the response
+    //! (a client that sent "Expect: 100-continue" never transmits the body of a rejected request)
+    std::function<bool(std::shared_ptr<Session>, const Request&)> header;
+
+    //! called for every chunk of the body - the chunk is only valid during the call and the last call has last set
+    //! (the request can be answered at any time, an answer before the last chunk closes the connection)
+    std::function<void(std::shared_ptr<Session>, const Request&, std::string_view chunk, bool last)> body;
+};
+
+//! per endpoint settings for RestServer::registerEndpoint
+struct EndpointOptions
+{
+    //! runs the callback on the worker pool instead of the i/o thread that read the request (for callbacks that take
+    //! long or block) - the response is sent from the i/o thread of the session again (not for streaming endpoints)
+    bool offload {false};
+
+    //! the maximum size of a request body in bytes - larger requests are answered with "413 Payload Too Large" before
+    //! their body is read (0: the limit of the server)
+    std::uint64_t bodyLimit {0};
+
+    //! false keeps the responses of the endpoint uncompressed (e.g. if they are compressed already or contain secrets
+    //! that must not be exposed to compression side channels)
+    bool compress {true};
+
+    //! the time the body of a request may take to arrive - for every chunk of a streaming endpoint (0: the body
+    //! timeout of the server)
+    std::chrono::milliseconds bodyTimeout {0};
+};
+
+//! an endpoint as it was registered with RestServer::registerEndpoint or RestServer::registerStreamingEndpoint
+struct Endpoint
+{
+    std::string target;
+    RestServerCallback callback;
+    EndpointOptions options {};
+
+    //! only set for streaming endpoints - they don't have a callback
+    StreamCallbacks stream {};
+};
+}  // namespace rgpaul
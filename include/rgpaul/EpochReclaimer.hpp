@@ -0,0 +1,129 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rgpaul
+{
+//! Epoch based reclamation for data that is read without locks (read-copy-update).
+//! Readers pin the current epoch with a ReadGuard - this is a single store into a per thread slot. Writers publish a
+//! new version and retire the old one, which is deleted as soon as every reader that could still see it has left.
+class EpochReclaimer
+{
+  public:
+    //! pins the current epoch for the calling thread - guards can be nested
+    class ReadGuard
+    {
+      public:
+        ReadGuard();
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    //! the process wide domain that is used by all readers and writers
+    static EpochReclaimer& instance();
+
+    //! deletes the object once no reader that entered before this call is left
+    void retire(std::shared_ptr<const void> object);
+
+    //! deletes all retired objects that can't be seen by a reader anymore
+    void collect();
+
+    //! number of retired objects that are not deleted yet
+    std::size_t pendingCount() const;
+
+  private:
+    static constexpr std::size_t kSlotCount = 256;
+
+    struct alignas(64) Slot
+    {
+        // the epoch the reader entered with - 0 if the thread is not reading
+        std::atomic<std::uint64_t> epoch {0};
+        std::atomic<bool> used {false};
+    };
+
+    struct Retired
+    {
+        std::uint64_t epoch;
+        std::shared_ptr<const void> object;
+    };
+
+    std::atomic<std::uint64_t> _epoch {1};
+    std::array<Slot, kSlotCount> _slots;
+
+    // readers of threads that didn't get a slot - while there are any, nothing is deleted
+    std::atomic<std::size_t> _overflowReaders {0};
+
+    mutable std::mutex _retiredMutex;
+    std::vector<Retired> _retired;
+
+    EpochReclaimer() = default;
+
+    int acquireSlot();
+    void releaseSlot(int slot);
+    void enter();
+    void leave();
+
+    friend struct EpochReclaimerThreadState;
+};
+
+//! A pointer to an immutable value that readers access without locks while writers replace it.
+//! Writers have to be serialized by the caller.
+template <class T>
+class RcuPointer
+{
+  public:
+    RcuPointer() = default;
+    explicit RcuPointer(std::unique_ptr<const T> value) : _pointer(value.release()) {}
+    ~RcuPointer() { delete _pointer.load(); }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    //! the returned value stays valid as long as the given guard exists
+    const T* load(const EpochReclaimer::ReadGuard&) const { return _pointer.load(std::memory_order_seq_cst); }
+
+    //! publishes the new value - the old one is deleted when the last reader that could see it has left
+    void store(std::unique_ptr<const T> value)
+    {
+        const T* old = _pointer.exchange(value.release(), std::memory_order_seq_cst);
+
+        if (old)
+            EpochReclaimer::instance().retire(std::shared_ptr<const void>(old));
+
+        EpochReclaimer::instance().collect();
+    }
+
+  private:
+    std::atomic<const T*> _pointer {nullptr};
+};
+}  // namespace rgpaul
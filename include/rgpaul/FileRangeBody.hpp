@@ -0,0 +1,109 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/optional.hpp>
+
+namespace rgpaul
+{
+//! A beast body that sends ranges of a file: the whole file, a single range or several ranges as multipart/byteranges.
+//! Unlike http::file_body it can start at an offset. The file is read in blocks of 64 KiB - if the body is one range of
+//! the file the session lets the kernel send it instead (FileTransfer).
+struct FileRangeBody
+{
+    //! a part of the body - the text in front of it (e.g. the header of a multipart part) and a range of the file
+    struct Part
+    {
+        std::string prefix;
+        std::uint64_t offset {0};
+        std::uint64_t size {0};
+    };
+
+    class value_type
+    {
+      public:
+        //! opens the file - the body is the whole file until setParts is called
+        void open(const char* path, boost::beast::file_mode mode, boost::beast::error_code& ec);
+        bool is_open() const;
+        boost::beast::file& file();
+
+        std::uint64_t fileSize() const;
+
+        //! replaces the body with the given parts of the file and the text after them
+        void setParts(std::vector<Part> parts, std::string suffix = {});
+        const std::vector<Part>& parts() const;
+        const std::string& suffix() const;
+
+        //! true if the body is one range of the file without any text
+        bool contiguous() const;
+
+        //! the size of the body
+        std::uint64_t size() const;
+
+      private:
+        boost::beast::file _file;
+        std::uint64_t _fileSize {0};
+        std::vector<Part> _parts;
+        std::string _suffix;
+        std::uint64_t _size {0};
+    };
+
+    static std::uint64_t size(const value_type& body);
+
+    class writer
+    {
+      public:
+        using const_buffers_type = boost::asio::const_buffer;
+
+        template <bool isRequest, class Fields>
+        writer(const boost::beast::http::header<isRequest, Fields>&, value_type& body) : _body(body)
+        {
+        }
+
+        void init(boost::beast::error_code& ec);
+        boost::optional<std::pair<const_buffers_type, bool>> get(boost::beast::error_code& ec);
+
+      private:
+        value_type& _body;
+
+        // the part that is written and the bytes of its range that were read
+        std::size_t _part {0};
+        bool _prefixWritten {false};
+        std::uint64_t _position {0};
+        bool _suffixWritten {false};
+
+        std::unique_ptr<char[]> _buffer;
+        std::size_t _bufferSize {0};
+    };
+};
+}  // namespace rgpaul
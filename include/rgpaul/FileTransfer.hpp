@@ -0,0 +1,85 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/file.hpp>
+#include <boost/system/error_code.hpp>
+
+namespace rgpaul
+{
+//! Copies a range of a file to a socket inside of the kernel.
+//! The data never reaches user space: sendfile(2) is used where it is available, splice(2) through a pipe where the
+//! file system doesn't support sendfile. The socket has to be non-blocking - send() transfers as much as the socket
+//! accepts and the caller waits until the socket is writable again. Only supported on Linux, on other platforms (and
+//! for files that can't be spliced either) send() fails before anything was sent, so the caller can fall back to
+//! reading the file. Unlike send(2) sendfile and splice raise SIGPIPE if the peer closed the connection - the calling
+//! thread has to block the signal (the I/O threads of RestServer do), the transfer fails with EPIPE then.
+class FileTransfer
+{
+  public:
+    enum class Method
+    {
+        SendFile,
+        Splice,
+
+        //! the file can't be sent without copying it
+        None
+    };
+
+    FileTransfer(boost::beast::file::native_handle_type file, std::uint64_t offset, std::uint64_t size);
+    ~FileTransfer();
+
+    FileTransfer(const FileTransfer&) = delete;
+    FileTransfer& operator=(const FileTransfer&) = delete;
+
+    //! sends until the socket would block or the range was sent - returns the number of bytes that were sent
+    //! ec is would_block if the socket is full and operation_not_supported if the file can't be sent by the kernel
+    //! (nothing was sent then)
+    std::size_t send(boost::asio::ip::tcp::socket::native_handle_type socket, boost::system::error_code& ec);
+
+    //! true if the whole range was sent
+    bool done() const;
+
+    std::uint64_t remaining() const;
+    Method method() const;
+
+  private:
+    boost::beast::file::native_handle_type _file;
+    std::uint64_t _offset;
+    std::uint64_t _remaining;
+    Method _method {Method::SendFile};
+
+    // the method can only be changed as long as nothing was sent
+    bool _started {false};
+
+    // the pipe of splice and the bytes that are still in it
+    int _pipe[2] {-1, -1};
+    std::size_t _inPipe {0};
+
+    std::size_t sendFile(boost::asio::ip::tcp::socket::native_handle_type socket, boost::system::error_code& ec);
+    std::size_t splice(boost::asio::ip::tcp::socket::native_handle_type socket, boost::system::error_code& ec);
+};
+}  // namespace rgpaul
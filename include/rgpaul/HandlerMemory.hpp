@@ -0,0 +1,118 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace rgpaul
+{
+//! Memory for the asynchronous operations of one chain of completion handlers (e.g. the reads of a session).
+//! Only one operation of a chain is pending at a time, so a single block is handed out again and again. If it is in
+//! use or too small, the global heap is used instead.
+class HandlerMemory
+{
+  public:
+    HandlerMemory() = default;
+
+    HandlerMemory(const HandlerMemory&) = delete;
+    HandlerMemory& operator=(const HandlerMemory&) = delete;
+
+    void* allocate(std::size_t size);
+    void deallocate(void* pointer);
+
+    //! the number of allocations that didn't fit into the block (mainly for diagnostics)
+    std::size_t heapAllocations() const;
+
+  private:
+    static constexpr std::size_t kSize = 1024;
+
+    std::aligned_storage_t<kSize> _storage;
+    bool _inUse {false};
+    std::size_t _heapAllocations {0};
+};
+
+//! the allocator asio uses for the operations of a handler that was bound with bindHandlerMemory
+template <class T>
+class HandlerAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit HandlerAllocator(HandlerMemory& memory) : _memory(&memory) {}
+
+    template <class U>
+    HandlerAllocator(const HandlerAllocator<U>& other) noexcept : _memory(other._memory)
+    {
+    }
+
+    T* allocate(std::size_t n) { return static_cast<T*>(_memory->allocate(sizeof(T) * n)); }
+    void deallocate(T* pointer, std::size_t) { _memory->deallocate(pointer); }
+
+    template <class U>
+    bool operator==(const HandlerAllocator<U>& other) const noexcept
+    {
+        return _memory == other._memory;
+    }
+
+    template <class U>
+    bool operator!=(const HandlerAllocator<U>& other) const noexcept
+    {
+        return _memory != other._memory;
+    }
+
+  private:
+    template <class>
+    friend class HandlerAllocator;
+
+    HandlerMemory* _memory;
+};
+
+//! a completion handler whose associated allocator uses the given memory
+template <class Handler>
+class MemoryBoundHandler
+{
+  public:
+    using allocator_type = HandlerAllocator<Handler>;
+
+    MemoryBoundHandler(HandlerMemory& memory, Handler handler) : _memory(memory), _handler(std::move(handler)) {}
+
+    allocator_type get_allocator() const noexcept { return allocator_type(_memory); }
+
+    template <class... Args>
+    void operator()(Args&&... args)
+    {
+        _handler(std::forward<Args>(args)...);
+    }
+
+  private:
+    HandlerMemory& _memory;
+    Handler _handler;
+};
+
+template <class Handler>
+MemoryBoundHandler<std::decay_t<Handler>> bindHandlerMemory(HandlerMemory& memory, Handler&& handler)
+{
+    return MemoryBoundHandler<std::decay_t<Handler>>(memory, std::forward<Handler>(handler));
+}
+}  // namespace rgpaul
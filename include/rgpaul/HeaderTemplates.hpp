@@ -0,0 +1,78 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <boost/beast/http.hpp>
+
+#include <rgpaul/Compression.hpp>
+
+namespace rgpaul
+{
+//! Pre-serialized header blocks of responses.
+//! The status line and the fields that are the same for every response with a status, an HTTP version and a content
+//! type (Server and Content-Type) are serialized once - a response only adds the fields that differ (Date,
+//! Content-Length, ...) with writeFields. The Date is formatted once per second and thread.
+class HeaderTemplates
+{
+  public:
+    //! the size of the Date field including its CRLF
+    static constexpr std::size_t kDateFieldSize = 37;
+
+    //! the maximum number of bytes writeFields writes
+    static constexpr std::size_t kMaxFieldsSize = 192;
+
+    //! the request fields the representation of a response depends on - combined into the Vary field
+    static constexpr unsigned kVaryAccept = 1;
+    static constexpr unsigned kVaryAcceptEncoding = 2;
+
+    //! the number of prefixes that are kept - status, version and content type combined
+    static constexpr std::size_t kMaxPrefixes = 64;
+
+    //! the status line, the Server and the Content-Type field - the view stays valid as long as the process runs
+    //! (meant for the few content types a server sends - the view is empty once kMaxPrefixes combinations are kept,
+    //! the response serializes its own prefix then)
+    static std::string_view prefix(boost::beast::http::status status, unsigned version, std::string_view contentType);
+
+    //! the same block as prefix without keeping it
+    static std::string serializePrefix(boost::beast::http::status status, unsigned version,
+                                       std::string_view contentType);
+
+    //! the current date in the format of the Date field ("Sun, 06 Nov 1994 08:49:37 GMT") - the view is only valid
+    //! until the thread formats the next second
+    static std::string_view date();
+
+    //! writes the Date field with its CRLF - returns kDateFieldSize
+    static std::size_t writeDate(char* output);
+
+    //! writes the fields that follow the prefix and the empty line that ends the header - the Connection field is only
+    //! written if keepAlive differs from the default of the version
+    //! returns the number of written bytes (at most kMaxFieldsSize)
+    static std::size_t writeFields(char* output, std::uint64_t contentLength, unsigned version, bool keepAlive,
+                                   Compression::Encoding encoding = Compression::Encoding::Identity,
+                                   unsigned vary = 0);
+};
+}  // namespace rgpaul
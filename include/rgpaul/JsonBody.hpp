@@ -0,0 +1,163 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <rgpaul/JsonCodec.hpp>
+
+namespace rgpaul
+{
+//! A JSON document that is parsed without building a DOM (from text, CBOR or MessagePack).
+//! A single pass with the SAX interface of nlohmann::json stores all values in one flat array - every container knows
+//! where its children end, so a lookup skips the members it doesn't need. Values are addressed with JSON pointers
+//! ("/items/0/name") and a subtree is only turned into an nlohmann::json if that is requested. Documents may nest up
+//! to kMaxDepth levels. If a name occurs more than once in an object, the first member is used.
+class JsonBody
+{
+  public:
+    static constexpr std::size_t kMaxDepth = 1024;
+
+    enum class Type : std::uint8_t
+    {
+        Null,
+        Boolean,
+        Integer,
+        Unsigned,
+        Float,
+        String,
+        Binary,
+        Array,
+        Object
+    };
+
+    //! a value of the document - it is only valid as long as the document exists
+    class Value
+    {
+      public:
+        Value() = default;
+
+        //! false if the value doesn't exist (e.g. a pointer that didn't match)
+        bool exists() const;
+        explicit operator bool() const;
+
+        //! the type of the value - Null if it doesn't exist
+        Type type() const;
+        bool isNull() const;
+        bool isObject() const;
+        bool isArray() const;
+
+        //! the value if it has the type - integer() and number() convert between the numeric types if possible
+        std::optional<bool> boolean() const;
+        std::optional<std::int64_t> integer() const;
+        std::optional<double> number() const;
+        std::optional<std::string_view> string() const;
+
+        //! the number of elements or members - 0 for other values
+        std::size_t size() const;
+
+        //! the member with the given name or the element at the given index
+        Value member(std::string_view name) const;
+        Value element(std::size_t index) const;
+
+        //! the name of the value if it is the member of an object - empty otherwise
+        std::string_view name() const;
+
+        //! the value the JSON pointer addresses, relative to this value ("" is the value itself)
+        Value at(std::string_view pointer) const;
+
+        //! builds the DOM of the value
+        nlohmann::json toJson() const;
+
+      private:
+        friend JsonBody;
+
+        const JsonBody* _body {nullptr};
+        std::uint32_t _index {0};
+
+        Value(const JsonBody* body, std::uint32_t index);
+    };
+
+    //! parses the document - the values are stored in memory of the given resource (e.g. the arena of a session)
+    explicit JsonBody(std::string_view data, std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                      JsonCodec::Format format = JsonCodec::Format::Json);
+
+    //! false if the data isn't a valid document - error() describes the problem then
+    bool valid() const;
+    const std::string& error() const;
+
+    //! the top level value - it doesn't exist if the document isn't valid
+    Value root() const;
+
+    //! the value the JSON pointer addresses ("/user/name", "" is the root) - it doesn't exist if nothing matches
+    Value at(std::string_view pointer) const;
+
+  private:
+    struct Builder;
+
+    // a string in _strings
+    struct Span
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct Node
+    {
+        Type type;
+        bool boolean;
+
+        // the index after the last node of the subtree and the number of children of a container
+        std::uint32_t end;
+        std::uint32_t size;
+
+        // the name of a member of an object
+        Span name;
+
+        union
+        {
+            std::int64_t integer;
+            std::uint64_t unsignedInteger;
+            double number;
+            Span string;
+        };
+    };
+
+    // the nodes in document order - the children of a container follow it
+    std::pmr::vector<Node> _nodes;
+
+    // all names and string values in one block
+    std::pmr::string _strings;
+
+    std::string _error;
+
+    std::string_view text(Span span) const;
+};
+}  // namespace rgpaul
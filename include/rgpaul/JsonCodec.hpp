@@ -0,0 +1,55 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <string_view>
+
+namespace rgpaul
+{
+//! The representations of JSON data - text and the binary formats CBOR and MessagePack.
+//! Session::sendResponse encodes JSON in the format the client prefers (Accept) and Request::json decodes a body
+//! according to its Content-Type.
+class JsonCodec
+{
+  public:
+    enum class Format
+    {
+        Json,
+        Cbor,
+        MessagePack
+    };
+
+    //! the media type of the format
+    static std::string_view contentType(Format format);
+
+    //! the format of a Content-Type value - JSON for media types that aren't CBOR or MessagePack
+    //! ("application/x-msgpack" and "application/vnd.msgpack" are MessagePack as well)
+    static Format fromContentType(std::string_view contentType);
+
+    //! the quality the client assigned to the format in Accept from 0 (not acceptable) to 1000 - the most specific
+    //! media range that matches counts, without an Accept field every format is acceptable
+    static int quality(std::string_view accept, Format format);
+
+    //! the format with the highest quality - JSON on ties and if none is acceptable
+    static Format negotiate(std::string_view accept);
+};
+}  // namespace rgpaul
@@ -0,0 +1,98 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+#include <nlohmann/json.hpp>
+
+#include <rgpaul/JsonCodec.hpp>
+
+namespace rgpaul
+{
+//! An nlohmann::json output adapter that serializes directly into a string (e.g. the arena string of a response body).
+//! The string is resized ahead of the writes and written through its buffer, so the serializer doesn't append
+//! character by character - serialize() trims it to the written size afterwards. Text JSON as well as the binary
+//! formats (CBOR, MessagePack) are written this way.
+template <class String>
+class JsonOutput : public nlohmann::detail::output_adapter_protocol<char>
+{
+  public:
+    //! appends the compact serialization of data to output - reserve the expected size to avoid that the string grows
+    static void serialize(const nlohmann::json& data, String& output,
+                          JsonCodec::Format format = JsonCodec::Format::Json)
+    {
+        auto adapter = std::make_shared<JsonOutput>(output);
+
+        switch (format)
+        {
+            case JsonCodec::Format::Cbor:
+                nlohmann::detail::binary_writer<nlohmann::json, char>(adapter).write_cbor(data);
+                break;
+            case JsonCodec::Format::MessagePack:
+                nlohmann::detail::binary_writer<nlohmann::json, char>(adapter).write_msgpack(data);
+                break;
+            default:
+                nlohmann::detail::serializer<nlohmann::json>(adapter, ' ').dump(data, false, false, 0);
+                break;
+        }
+
+        output.resize(adapter->_position);
+    }
+
+    explicit JsonOutput(String& output) : _output(output), _position(output.size())
+    {
+        _output.resize(std::max(_output.capacity(), _position + kMinimumGrowth));
+    }
+
+    void write_character(char c) override
+    {
+        if (_position == _output.size())
+            grow(1);
+
+        _output[_position++] = c;
+    }
+
+    void write_characters(const char* s, std::size_t length) override
+    {
+        if (_output.size() - _position < length)
+            grow(length);
+
+        std::memcpy(&_output[_position], s, length);
+        _position += length;
+    }
+
+  private:
+    static constexpr std::size_t kMinimumGrowth = 256;
+
+    String& _output;
+    std::size_t _position;
+
+    void grow(std::size_t length)
+    {
+        _output.resize(std::max(_output.size() * 2, _position + std::max(length, kMinimumGrowth)));
+    }
+};
+}  // namespace rgpaul
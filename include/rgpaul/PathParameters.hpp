@@ -0,0 +1,69 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace rgpaul
+{
+class Router;
+
+//! The segments of a request target that were matched by the placeholders ("$" or "{name}") of an endpoint.
+//! The values are views into the request target - they are valid as long as the request is. The names are copies, so
+//! the parameters don't depend on the route table that matched them (it may be replaced while a request is answered).
+class PathParameters
+{
+  public:
+    //! maximum number of placeholders an endpoint can have
+    static constexpr std::size_t kCapacity = 16;
+
+    //! maximum length of all placeholder names of an endpoint together
+    static constexpr std::size_t kNameCapacity = 256;
+
+    std::size_t size() const;
+    bool empty() const;
+
+    //! returns the value of the placeholder at the given position (empty if there is none)
+    std::string_view operator[](std::size_t index) const;
+
+    //! returns the value of the named placeholder (e.g. "id" for "/users/{id}")
+    std::optional<std::string_view> get(std::string_view name) const;
+
+    //! returns the name of the placeholder at the given position (empty for "$")
+    std::string_view name(std::size_t index) const;
+
+  private:
+    friend Router;
+
+    std::array<std::string_view, kCapacity> _values;
+    std::size_t _size {0};
+
+    // names of the placeholders of the matched endpoint - name i is [_nameOffsets[i], _nameOffsets[i + 1])
+    std::array<char, kNameCapacity> _nameData;
+    std::array<std::uint16_t, kCapacity + 1> _nameOffsets {};
+};
+}  // namespace rgpaul
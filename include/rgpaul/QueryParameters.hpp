@@ -0,0 +1,86 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rgpaul
+{
+//! The parameters of a query string ("a=1&b=2&a=3") as views into the request target.
+//! Keys and values are kept encoded - they are only decoded on request and only if they contain escapes. Keys can
+//! occur more than once. Up to kInlineCapacity parameters are stored without allocating.
+class QueryParameters
+{
+  public:
+    static constexpr std::size_t kInlineCapacity = 16;
+
+    struct Parameter
+    {
+        std::string_view key;
+        std::string_view value;
+        bool keyEncoded {false};
+        bool valueEncoded {false};
+
+        //! returns the decoded value - it is only written into buffer if the value contains escapes
+        std::string_view decodedValue(std::string& buffer) const;
+
+        //! returns the decoded key - it is only written into buffer if the key contains escapes
+        std::string_view decodedKey(std::string& buffer) const;
+    };
+
+    QueryParameters() = default;
+
+    //! tokenizes a request target ("/search?q=1") or a bare query ("q=1") - a fragment ("#...") is ignored
+    explicit QueryParameters(std::string_view target);
+
+    std::size_t size() const;
+    bool empty() const;
+    const Parameter& operator[](std::size_t index) const;
+
+    //! checks if there is a parameter with the given (decoded) key
+    bool contains(std::string_view key) const;
+
+    //! number of parameters with the given (decoded) key
+    std::size_t count(std::string_view key) const;
+
+    //! returns the raw (encoded) value of the n-th parameter with the given key
+    std::optional<std::string_view> get(std::string_view key, std::size_t occurrence = 0) const;
+
+    //! returns the decoded value of the n-th parameter with the given key - buffer is only used if it has escapes
+    std::optional<std::string_view> value(std::string_view key, std::string& buffer, std::size_t occurrence = 0) const;
+
+    //! decodes a query component ("+" is a space, "%XX" an escaped byte) into the given buffer
+    static void decode(std::string_view input, std::string& output);
+
+  private:
+    std::array<Parameter, kInlineCapacity> _inline;
+    std::vector<Parameter> _overflow;
+    std::size_t _size {0};
+
+    const Parameter* find(std::string_view key, std::size_t occurrence) const;
+};
+}  // namespace rgpaul
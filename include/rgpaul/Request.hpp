@@ -0,0 +1,83 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include <boost/beast/http.hpp>
+
+#include <rgpaul/JsonBody.hpp>
+#include <rgpaul/PathParameters.hpp>
+#include <rgpaul/QueryParameters.hpp>
+#include <rgpaul/SessionArena.hpp>
+
+namespace rgpaul
+{
+class RestServer;
+class Session;
+
+//! The request that is passed to the endpoint callbacks.
+//! It is a regular beast request that additionally carries the values that were captured while routing.
+//! Headers and body use the allocator they were created with - for the requests of a session that is its arena.
+class Request : public boost::beast::http::request<ArenaStringBody, ArenaFields>
+{
+  public:
+    using Message = boost::beast::http::request<ArenaStringBody, ArenaFields>;
+    using Message::message;
+
+    //! the route of a request without an endpoint
+    static constexpr std::uint32_t kNoRoute = UINT32_MAX;
+
+    Request() = default;
+
+    //! takes over the headers and the body of the message (e.g. released by a parser) without copying them
+    explicit Request(Message&& message);
+
+    //! the segments of the target that were matched by the placeholders of the endpoint
+    const PathParameters& pathParameters() const;
+
+    //! the parameters of the query string - the target is tokenized on the first call
+    const QueryParameters& queryParameters() const;
+
+    //! the body parsed as JSON - it is parsed on the first call (without building a DOM) and kept with the request, so
+    //! every layer that reads the body uses the same result
+    //! (bodies with the Content-Type of CBOR or MessagePack are decoded from that format)
+    const JsonBody& json() const;
+
+    //! false if the endpoint of the request opted out of response compression (EndpointOptions::compress)
+    bool compressResponse() const;
+
+    //! the index of the endpoint in the route table - the order of registration (kNoRoute if there is none)
+    std::uint32_t route() const;
+
+  private:
+    friend RestServer;
+    friend Session;
+
+    PathParameters _pathParameters;
+    bool _compressResponse {true};
+    std::uint32_t _route {kNoRoute};
+    mutable std::optional<QueryParameters> _queryParameters;
+    mutable std::optional<JsonBody> _json;
+};
+}  // namespace rgpaul
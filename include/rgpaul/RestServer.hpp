@@ -21,9 +21,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -33,31 +39,144 @@
 #include <boost/beast/http.hpp>
 #include <nlohmann/json.hpp>
 
+#include <rgpaul/AccessLog.hpp>
+#include <rgpaul/Compression.hpp>
+#include <rgpaul/ConnectionLimiter.hpp>
+#include <rgpaul/Endpoint.hpp>
+#include <rgpaul/EpochReclaimer.hpp>
+#include <rgpaul/Request.hpp>
+#include <rgpaul/RouteTable.hpp>
 #include <rgpaul/Session.hpp>
+#include <rgpaul/StaticFileCache.hpp>
+#include <rgpaul/ThreadPlacement.hpp>
+#include <rgpaul/WorkStealingPool.hpp>
 
 namespace rgpaul
 {
-using RestServerCallback =
-    std::function<void(std::shared_ptr<Session>, const boost::beast::http::request<boost::beast::http::string_body>&)>;
-
-class UriNode;
-
 class RestServer : public std::enable_shared_from_this<RestServer>
 {
   public:
+    //! how the connections are distributed over the threads
+    enum class ExecutionModel
+    {
+        //! all threads run one io_context with one acceptor - every connection gets a strand
+        SharedContext,
+
+        //! every thread runs an io_context with an acceptor of its own (SO_REUSEPORT) - a connection stays on the
+        //! thread that accepted it and doesn't need a strand
+        ContextPerThread
+    };
+
     RestServer() = delete;
     explicit RestServer(const std::string& host, unsigned short port = 8080);
 
-    void registerEndpoint(const std::string& target, RestServerCallback callback);
+    //! registers the callback for the given target - segments that are "$" or "{name}" are placeholders whose values
+    //! are passed to the callback in Request::pathParameters()
+    //! (can be called while the server is running - requests in flight finish with the previous endpoints)
+    void registerEndpoint(const std::string& target, RestServerCallback callback, EndpointOptions options = {});
+
+    //! registers an endpoint that receives the body of its requests in chunks instead of one string (for large uploads)
+    //! - the next chunk is read after the body callback returned, unless Session::pauseBody was called
+    void registerStreamingEndpoint(const std::string& target, StreamCallbacks callbacks, EndpointOptions options = {});
+
+    //! removes the endpoint that was registered for the given target - returns false if there is none
+    bool unregisterEndpoint(const std::string& target);
 
     //! starts listening with given number of threads - this call won't block
     void startListening(unsigned short threads = 1);
 
+    //! stops all threads and closes the acceptors - must not be called from one of the threads of the server
+    //! (the connections are closed when the server is destroyed)
+    void stop();
+
+    //! must be set before startListening (default: SharedContext)
+    void setExecutionModel(ExecutionModel model);
+    ExecutionModel executionModel() const;
+
+    //! pins the i/o threads to cpus and binds their memory to the NUMA node of the cpu - must be set before
+    //! startListening (the threads are named "rgp-io-<index>" in any case)
+    void setThreadPlacement(ThreadPlacement placement);
+    const ThreadPlacement& threadPlacement() const;
+
+    //! the port the server is bound to (useful if it was created with port 0)
+    unsigned short port() const;
+
+    //! the number of pipelined requests a connection processes before their responses are written (default: 16)
+    //! (1 disables pipelining - changes apply to new connections)
+    void setMaxPipelineDepth(std::size_t depth);
+    std::size_t maxPipelineDepth() const;
+
+    //! answers Session::sendFile from memory for the files that fit into the cache (must be set before startListening,
+    //! nullptr disables it - the default)
+    void setStaticFileCache(std::shared_ptr<StaticFileCache> cache);
+    std::shared_ptr<StaticFileCache> staticFileCache() const;
+
+    //! every answered request is recorded in the access log (must be set before startListening, default: none)
+    void setAccessLog(std::shared_ptr<AccessLog> log);
+    std::shared_ptr<AccessLog> accessLog() const;
+
+    //! responses are compressed with the best encoding the client accepts (Accept-Encoding) if the level is above 0 -
+    //! endpoints can opt out with EndpointOptions::compress (must be set before startListening, default: off)
+    void setCompression(Compression::Settings settings);
+    const Compression::Settings& compression() const;
+
+    //! JSON responses are encoded as CBOR or MessagePack if the client prefers it in Accept - they carry "Vary: Accept"
+    //! then (default: false, applies to new connections)
+    void setBinaryJson(bool enabled);
+    bool binaryJson() const;
+
+    //! files are sent by the kernel (sendfile/splice) instead of being read and written by the session - only
+    //! supported on Linux, elsewhere the setting has no effect (default: true, applies to new connections)
+    //! SIGPIPE is blocked in the I/O threads of the server for it - the signal disposition of the process isn't changed
+    void setZeroCopyFiles(bool enabled);
+    bool zeroCopyFiles() const;
+
+    //! the timeouts of the connections (must be set before startListening, default: 30 s each) - the body timeout can
+    //! be set per endpoint with EndpointOptions::bodyTimeout
+    void setTimeouts(Session::Timeouts timeouts);
+    const Session::Timeouts& timeouts() const;
+
+    //! the number of concurrent connections in total and per client address (must be set before startListening,
+    //! default: unlimited) - at the total limit no connection is accepted until a session is closed, connections from
+    //! an address beyond its limit are closed right away
+    void setConnectionLimits(ConnectionLimiter::Limits limits);
+    const ConnectionLimiter::Limits& connectionLimits() const;
+
+    //! the open connections and the numbers of rejected and deferred connections
+    ConnectionLimiter::Metrics connectionMetrics() const;
+
+    //! the maximum size of a request body for endpoints without a limit of their own (default: 1 MiB)
+    void setBodyLimit(std::uint64_t limit);
+    std::uint64_t bodyLimit() const;
+
+    //! the size of the worker pool for offloaded endpoints (default: number of cores) and the number of callbacks every
+    //! worker queues - requests beyond that get "503 Service Unavailable" (must be set before the first offloaded
+    //! request, the pool is started with it)
+    void setWorkerThreads(std::size_t threads, std::size_t queueCapacity = 1024);
+
+    //! queue depths, executed and stolen callbacks of the worker pool (empty if no callback was offloaded yet)
+    WorkStealingPool::Metrics workerMetrics() const;
+
     static std::vector<std::string> splitUri(std::string uri);
 
     static std::string urlEncode(const std::string& url);
     static std::string urlDecode(const std::string& url);
 
+    //! encodes into the given string - its capacity is reused
+    static void urlEncode(std::string_view url, std::string& output);
+
+    //! encodes into the given buffer that needs space for 3 * url.size() characters - returns the encoded length
+    static std::size_t urlEncode(std::string_view url, char* output);
+
+    //! decodes into the given string - its capacity is reused
+    static void urlDecode(std::string_view url, std::string& output);
+
+    //! decodes into the given buffer that needs space for url.size() characters - returns the decoded length
+    static std::size_t urlDecode(std::string_view url, char* output);
+
+    //! decodes the given string in place
+    static void urlDecodeInPlace(std::string& url);
+
   private:
     // the io_context is required for all i/o
     boost::asio::io_context _ioc;
@@ -68,13 +187,90 @@ class RestServer : public std::enable_shared_from_this<RestServer>
     // holds all threads that are listening for incoming connections
     std::vector<std::thread> _threads;
 
-    std::shared_ptr<UriNode> _registeredEndpoints;
+    // an io_context with an acceptor of its own - one per thread with ExecutionModel::ContextPerThread
+    struct Listener
+    {
+        // the context is only run by one thread
+        boost::asio::io_context ioc {1};
+        boost::asio::ip::tcp::acceptor acceptor {ioc};
+    };
+
+    ExecutionModel _executionModel {ExecutionModel::SharedContext};
+    ThreadPlacement _threadPlacement;
+    std::vector<std::unique_ptr<Listener>> _listeners;
+
+    // serializes changes of the registered endpoints
+    std::mutex _endpointsMutex;
+
+    // all registered endpoints - only accessed by writers
+    std::vector<Endpoint> _endpoints;
+
+    // the snapshot that is used for requests - replaced (copy on write) for every change once we are listening
+    RcuPointer<RouteTable> _routeTable {std::make_unique<const RouteTable>()};
+    bool _listening {false};
+
+    std::atomic<std::size_t> _maxPipelineDepth {16};
+    std::atomic<std::uint64_t> _bodyLimit {1024 * 1024};
+    std::atomic<bool> _zeroCopyFiles {true};
+    std::atomic<bool> _binaryJson {false};
+    std::shared_ptr<StaticFileCache> _staticFileCache;
+    std::shared_ptr<AccessLog> _accessLog;
+    Compression::Settings _compression;
+    Session::Timeouts _timeouts;
+    std::shared_ptr<ConnectionLimiter> _connectionLimiter {std::make_shared<ConnectionLimiter>()};
+
+    // runs the callbacks of offloaded endpoints - started with the first one
+    std::size_t _workerThreads {std::thread::hardware_concurrency()};
+    std::size_t _workerQueueCapacity {1024};
+    std::once_flag _workersStarted;
+    std::unique_ptr<WorkStealingPool> _workers;
+    std::atomic<bool> _workersRunning {false};
+
+    WorkStealingPool& workers();
+    void offload(const Endpoint& endpoint, Request& request, std::shared_ptr<Session> session);
+
+    void addEndpoint(Endpoint endpoint);
+    void publishRouteTable();
+
+    bool openListeners(std::size_t count);
 
     void doAccept();
     void onAccept(boost::beast::error_code ec, boost::asio::ip::tcp::socket socket);
 
+    void doAccept(Listener& listener);
+    void onAccept(Listener& listener, boost::beast::error_code ec, boost::asio::ip::tcp::socket socket);
+
+    // reserves the connection for the next accept - false if the acceptor has to wait for a closed session, it is
+    // resumed on the given context then
+    bool reserveConnection(boost::asio::io_context& context, boost::asio::ip::tcp::acceptor& acceptor,
+                           std::function<void()> accept);
+
+    // admits the accepted connection and starts its session (or closes the socket if its address has too many)
+    void startSession(boost::asio::ip::tcp::socket socket);
+
+    // places and names the calling thread and runs the given context
+    void runThread(std::size_t index, boost::asio::io_context& context);
+
+    // what a session has to know about the endpoint of a request before it reads the body
+    struct BodyPolicy
+    {
+        std::uint64_t limit;
+
+        // set for streaming endpoints - a copy, because the route table may be replaced while the body is read
+        std::optional<StreamCallbacks> stream;
+
+        // 0 if the endpoint uses the body timeout of the server
+        std::chrono::milliseconds timeout {0};
+
+        // the route of a streaming endpoint
+        std::uint32_t route {Request::kNoRoute};
+    };
+
     friend Session;
-    void handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& req,
-                       std::shared_ptr<Session> session);
+    void handleRequest(Request& request, std::shared_ptr<Session> session);
+    BodyPolicy bodyPolicy(boost::beast::string_view target) const;
+
+    // runs work of a session (e.g. compressing a large body) on the worker pool - false if all queues are full
+    bool submitToWorkers(WorkStealingPool::Task task);
 };
 }  // namespace rgpaul
@@ -0,0 +1,55 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include <rgpaul/Endpoint.hpp>
+#include <rgpaul/PathParameters.hpp>
+#include <rgpaul/Router.hpp>
+
+namespace rgpaul
+{
+//! An immutable snapshot of the registered endpoints together with the router that was built for them.
+//! RestServer publishes a new table for every change, so requests that are in flight keep using the old one.
+class RouteTable
+{
+  public:
+    RouteTable() = default;
+    explicit RouteTable(std::vector<Endpoint> endpoints);
+
+    //! returns the endpoint for the given target (or nullptr) and stores the values of its placeholders in parameters
+    const Endpoint* findEndpoint(std::string_view target, PathParameters& parameters) const;
+
+    const std::vector<Endpoint>& endpoints() const;
+
+    //! true if an endpoint streams its body or has a body limit or timeout of its own - otherwise the body of a request
+    //! can be read without looking up its endpoint first
+    bool hasBodyOptions() const;
+
+  private:
+    std::vector<Endpoint> _endpoints;
+    Router _router;
+    bool _hasBodyOptions {false};
+};
+}  // namespace rgpaul
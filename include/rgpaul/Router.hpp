@@ -0,0 +1,96 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <rgpaul/PathParameters.hpp>
+
+namespace rgpaul
+{
+//! A frozen radix trie that maps request targets to route indices.
+//! All nodes, edge labels and child lookup bytes are stored in contiguous arrays, so a lookup works directly on the
+//! request target and does not allocate. A path segment consisting of a single "$" or a name in braces ("{id}") is a
+//! placeholder that matches any segment. Static segments take precedence over placeholders.
+class Router
+{
+  public:
+    //! returned by findRoute if no route matches
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    Router() = default;
+
+    //! builds the trie - the index of a pattern in the given vector is its route index
+    //! (invalid patterns are ignored, if a pattern occurs twice the last one wins)
+    explicit Router(const std::vector<std::string>& patterns);
+
+    //! returns the index of the route that matches the given target (query parameters are ignored) or npos
+    std::size_t findRoute(std::string_view target) const;
+
+    //! same as above - additionally stores the segments that were matched by placeholders in parameters
+    std::size_t findRoute(std::string_view target, PathParameters& parameters) const;
+
+    //! the number of nodes in the trie (mainly for diagnostics)
+    std::size_t nodeCount() const;
+
+    //! strips the query and a trailing "/" - the same normalization splitUri applies
+    static std::string_view normalizePath(std::string_view target);
+
+    //! checks if the pattern is absolute and doesn't have more placeholders (or longer names) than PathParameters can
+    //! hold
+    static bool isValidPattern(std::string_view pattern);
+
+  private:
+    static constexpr std::uint32_t kInvalid = UINT32_MAX;
+
+    struct Node
+    {
+        std::uint32_t labelOffset {0};
+        std::uint32_t labelLength {0};
+        std::uint32_t firstChild {0};
+        std::uint32_t childCount {0};
+        std::uint32_t wildcardChild {kInvalid};
+        std::uint32_t route {kInvalid};
+    };
+
+    // nodes in breadth first order - the static children of a node are stored next to each other
+    std::vector<Node> _nodes;
+
+    // the first byte of every node label (same index as _nodes) - scanned when looking for a child
+    std::vector<char> _firstBytes;
+
+    // all node labels in one block
+    std::string _labels;
+
+    // placeholder names of all routes in one block - route i uses [_parameterOffsets[i], _parameterOffsets[i + 1])
+    std::vector<std::string> _parameterNames;
+    std::vector<std::uint32_t> _parameterOffsets;
+
+    std::uint32_t match(std::uint32_t nodeIndex, std::string_view path, std::size_t pos, std::string_view* captures,
+                        std::size_t depth) const;
+    std::uint32_t findStaticChild(const Node& node, char byte) const;
+};
+}  // namespace rgpaul
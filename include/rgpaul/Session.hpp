@@ -21,13 +21,36 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <nlohmann/json.hpp>
 
+#include <rgpaul/AccessLog.hpp>
+#include <rgpaul/ByteRanges.hpp>
+#include <rgpaul/Compression.hpp>
+#include <rgpaul/ConnectionLimiter.hpp>
+#include <rgpaul/Endpoint.hpp>
+#include <rgpaul/FileRangeBody.hpp>
+#include <rgpaul/FileTransfer.hpp>
+#include <rgpaul/HandlerMemory.hpp>
+#include <rgpaul/HeaderTemplates.hpp>
+#include <rgpaul/Request.hpp>
+#include <rgpaul/SessionArena.hpp>
+#include <rgpaul/StaticFileCache.hpp>
+#include <rgpaul/TimingWheel.hpp>
+
 namespace rgpaul
 {
 class RestServer;
@@ -35,35 +58,334 @@ class RestServer;
 class Session : public std::enable_shared_from_this<Session>
 {
   public:
+    //! how long the phases of a connection may take before it is closed (RestServer::setTimeouts) - the deadlines are
+    //! tracked by the timing wheel of the i/o thread with a granularity of 100 ms
+    struct Timeouts
+    {
+        //! a keep-alive connection waits for the first bytes of its next request
+        std::chrono::milliseconds idle {std::chrono::seconds(30)};
+
+        //! from the first bytes of a request until its header is complete
+        std::chrono::milliseconds header {std::chrono::seconds(30)};
+
+        //! the body of a request - for every chunk of a streamed body (EndpointOptions::bodyTimeout overrides it)
+        std::chrono::milliseconds body {std::chrono::seconds(30)};
+
+        //! every write of responses
+        std::chrono::milliseconds write {std::chrono::seconds(30)};
+    };
+
     Session() = delete;
-    explicit Session(boost::asio::ip::tcp::socket&& socket, std::shared_ptr<RestServer> server);
+    //! the ticket of the connection limiter is released when the session is destroyed
+    explicit Session(boost::asio::ip::tcp::socket&& socket, std::shared_ptr<RestServer> server,
+                     ConnectionLimiter::Ticket ticket = {});
 
     void run();
 
+    //! all send functions answer the oldest request that waits for a response - they can be called from any thread
+    //! the JSON is serialized directly into the body of the response (in the memory of the session) - as CBOR or
+    //! MessagePack if the client prefers that in Accept (RestServer::setBinaryJson)
     void sendResponse(const nlohmann::json& data);
 
+    //! a document that isn't needed anymore is moved to the thread of the session instead of copied
+    void sendResponse(nlohmann::json&& data);
+
+    //! sends a body that is already serialized (e.g. cached JSON) - it doesn't have to outlive the call
+    //! (the content type has no default, so sendResponse with a single argument always sends JSON)
+    void sendResponse(std::string_view body, boost::beast::string_view contentType);
+
     void sendBadRequest(boost::beast::string_view why);
     void sendNotFound(boost::beast::string_view target);
     void sendServerError(boost::beast::string_view what);
+    void sendServiceUnavailable(boost::beast::string_view why);
+
+    //! with a static file cache (RestServer::setStaticFileCache) small files are answered from memory and requests with
+    //! a matching If-None-Match or If-Modified-Since get "304 Not Modified"
+    //! (a precompressed sibling of the file is sent instead if the client accepts its encoding)
+    //! GET requests with a Range header get the requested ranges ("206 Partial Content", several ranges as
+    //! multipart/byteranges) unless their If-Range doesn't match the file anymore
     void sendFile(const std::string& path);
 
+    //! starts a response whose body is written in pieces with writeChunk and finished with endStream - the header is
+    //! sent right away and the chunks as they are queued (HTTP/1.0 clients get the plain body and the connection is
+    //! closed after it)
+    //! drained is called on the thread of the session once the queue has room again after writeChunk returned false
+    void beginStream(boost::beast::http::status status = boost::beast::http::status::ok,
+                     boost::beast::string_view contentType = "application/json", std::function<void()> drained = {});
+
+    //! queues a piece of the body of the streamed response - returns false if the queue of the session is full
+    //! (256 KiB), the caller should wait for the drained callback then instead of producing more data
+    //! (after the connection failed the queue stays full and drained isn't called anymore)
+    bool writeChunk(std::string_view data);
+
+    //! finishes the body of the streamed response - the request is answered
+    void endStream();
+
+    //! the body of a streamed request isn't read further after the current chunk (e.g. while the chunk is processed
+    //! by another thread) - resumeBody continues, both can be called from any thread
+    void pauseBody();
+    void resumeBody();
+
+    //! returns the content type for the extension of the given path
+    static boost::beast::string_view mimeType(boost::beast::string_view path);
+
   private:
+    // a reusable response - it is built in place and written by its own serializer, both are reset after the write
+    template <class Body>
+    struct ResponseSlot
+    {
+        std::optional<boost::beast::http::response<Body, ArenaFields>> message;
+        std::optional<boost::beast::http::response_serializer<Body, ArenaFields>> serializer;
+    };
+
+    // a piece of a streamed response body together with its chunk header
+    struct Chunk
+    {
+        std::string data;
+        std::array<char, 24> header;
+        std::size_t headerSize {0};
+    };
+
+    // a response from the static file cache - the header fields and the body are shared with the cache
+    struct CachedResponse
+    {
+        std::shared_ptr<const StaticFileCache::Entry> entry;
+        bool notModified;
+        bool withBody;
+        bool keepAlive;
+        bool http10;
+
+        // the Date field - written when the response is gathered
+        std::array<char, HeaderTemplates::kDateFieldSize> date;
+    };
+
+    // a response whose status line and constant fields are a pre-serialized block of HeaderTemplates - the fields
+    // that differ between responses are written when it is gathered
+    struct TemplateResponse
+    {
+        std::string_view prefix;
+        boost::beast::http::status status;
+        ArenaStringBody::value_type body;
+        unsigned version;
+        bool keepAlive;
+        Compression::Encoding encoding {Compression::Encoding::Identity};
+        unsigned vary {0};
+        std::array<char, HeaderTemplates::kMaxFieldsSize> fields;
+
+        // the prefix of a content type HeaderTemplates doesn't keep - prefix is empty then
+        ArenaStringBody::value_type ownPrefix;
+    };
+
+    // a pipelined request together with its response
+    struct Exchange
+    {
+        std::optional<Request> request;
+        ResponseSlot<ArenaStringBody> stringResponse;
+        ResponseSlot<boost::beast::http::empty_body> emptyResponse;
+        ResponseSlot<FileRangeBody> fileResponse;
+        std::optional<CachedResponse> cachedResponse;
+        std::optional<TemplateResponse> templateResponse;
+
+        // the body of the template response is compressed by a worker - the response isn't written before it is done
+        bool pending {false};
+
+        // a streamed response - emptyResponse holds its header, the chunks are written while they are queued and
+        // removed once they were written (a deque, so the chunks of a write don't move while more are queued)
+        bool streamed {false};
+        bool headerGathered {false};
+        std::deque<Chunk> chunks;
+        std::size_t gatheredChunks {0};
+
+        // for the access log - when the first byte of the request arrived and the bytes of the response written so far
+        std::chrono::steady_clock::time_point start;
+        std::uint64_t bytes {0};
+
+        void release();
+
+        // the response closes the connection
+        void close();
+    };
+
     boost::beast::tcp_stream _stream;
     boost::beast::flat_buffer _buffer;
-    boost::beast::http::request<boost::beast::http::string_body> _req;
-    std::shared_ptr<void> _res;
+
+    // requests and responses allocate from the arena - declared before them, so it is destroyed after them
+    SessionArena _arena;
+    std::optional<boost::beast::http::request_parser<ArenaStringBody, ArenaAllocator>> _parser;
+
+    // the pipeline - requests are dispatched, answered and written in order:
+    // written <= answered <= dispatched <= received
+    std::vector<std::unique_ptr<Exchange>> _exchanges;
+    std::size_t _maxPipelineDepth;
+    std::size_t _receivedCount {0};
+    std::size_t _dispatchedCount {0};
+    std::size_t _answeredCount {0};
+    std::size_t _writtenCount {0};
+    bool _dispatching {false};
+
+    // counts the answered requests over the lifetime of the session (the counts above restart with every batch) - it
+    // identifies the request that waits for a response
+    std::uint64_t _answeredSequence {0};
+    bool _writing {false};
+
+    // keeps the io_context running while a request is answered by another thread and no operation is pending
+    std::optional<boost::beast::tcp_stream::executor_type> _answerWork;
+
+    // the request whose body is streamed to the callbacks of its endpoint - the parser reads into the body buffer
+    std::optional<boost::beast::http::request_parser<boost::beast::http::buffer_body, ArenaAllocator>> _bodyParser;
+    std::optional<StreamCallbacks> _streamCallbacks;
+    std::unique_ptr<char[]> _bodyBuffer;
+    bool _bodyPaused {false};
+    bool _deliveringBody {false};
+
+    // the response of the oldest request that waits for one while it is streamed
+    struct ResponseStream
+    {
+        bool open {false};
+        bool chunked {false};
+        bool head {false};
+        bool failed {false};
+
+        // a call of writeChunk returned false - drained is called once there is room again
+        bool full {false};
+        std::function<void()> drained;
+    };
+
+    ResponseStream _responseStream;
+
+    // the size of the queued chunks that weren't written yet - writeChunk adds to it on the thread of the caller
+    std::atomic<std::size_t> _queuedChunkBytes {0};
+
+    // answers sendFile from memory if it is set
+    std::shared_ptr<StaticFileCache> _fileCache;
+
+    Compression::Settings _compression;
+
+    // JSON responses are negotiated with the binary formats
+    bool _binaryJson;
+
+    // the size of the last JSON body (at most SessionArena::kMaxRetainedSize) - reserved for the next one
+    std::size_t _jsonSizeHint {0};
+
+    // the number of bodies that are compressed by workers right now
+    std::size_t _compressing {0};
+
+    // the body of a file response that is sent by the kernel after its header was written
+    bool _zeroCopyFiles;
+    std::optional<FileTransfer> _fileTransfer;
+
+    // the buffers of all responses that are written together
+    std::vector<boost::asio::const_buffer> _writeBuffers;
+
+    // the asynchronous operations of the read and the write chain reuse this memory
+    HandlerMemory _readMemory;
+    HandlerMemory _writeMemory;
+
     std::weak_ptr<RestServer> _restServer;
+    ConnectionLimiter::Ticket _ticket;
 
-    static boost::beast::string_view mimeType(boost::beast::string_view path);
+    // the wheel of the thread that arms a deadline checks it - an expired deadline closes the connection
+    Timeouts _timeouts;
+    std::chrono::milliseconds _bodyTimeout;
+    boost::asio::io_context* _context;
+    TimingWheel::Deadline _readDeadline;
+    TimingWheel::Deadline _writeDeadline;
+
+    // the written responses are recorded if it is set
+    std::shared_ptr<AccessLog> _accessLog;
+    boost::asio::ip::tcp::endpoint _peer;
+    std::chrono::steady_clock::time_point _requestStart;
+
+    // the pending write is a serializer of its own - its bytes are only known once it is done
+    bool _serializerWrite {false};
 
     void doRead();
+
+    // waits for the first bytes of the next request - the header is read with its own deadline afterwards
+    void onReadIdle(boost::beast::error_code ec, std::size_t bytes_transferred);
+    void doReadHeader();
+    void onReadHeader(boost::beast::error_code ec, std::size_t bytes_transferred);
+    void doReadMessage();
     void onRead(boost::beast::error_code ec, std::size_t bytes_transferred);
+
+    // the interim response for "Expect: 100-continue" - continues with the body of a streamed or a buffered request
+    void doContinue(bool stream);
+    void onContinue(bool stream, boost::beast::error_code ec, std::size_t bytes_transferred);
+
+    void startStream(StreamCallbacks callbacks, std::uint64_t bodyLimit, std::uint32_t route);
+    void doReadBody();
+    void onReadBody(boost::beast::error_code ec, std::size_t bytes_transferred);
+    void stopStream();
+
+    // answers the request whose header was parsed without reading its body - the connection is closed afterwards
+    void rejectRequest(boost::beast::http::status status, boost::beast::string_view why);
+
+    // applies the body limit of the endpoint to the parsed header - false if the body has to be read asynchronously
+    bool prepareBufferedBody();
     void doClose();
-    void onWrite(bool close, boost::beast::error_code ec, std::size_t bytes_transferred);
+    void onWrite(std::size_t count, bool close, boost::beast::error_code ec, std::size_t bytes_transferred);
+
+    // sends the body of the file response whose header was written - the socket is waited for while it is full
+    void doSendFile();
+    void onSendFile(boost::beast::error_code ec);
+
+    void onTimeout();
+
+    void emplaceParser();
+    Exchange& nextExchange();
+    void addExchange();
+    std::size_t parseBuffered();
+    void processPipeline();
+    void flush();
+
+    // adds the header and (unless headerOnly) the complete body of the response to the write buffers
+    template <class Body>
+    void gather(ResponseSlot<Body>& slot, bool headerOnly = false);
+
+    void gatherStream(Exchange& exchange);
+    void gatherCached(CachedResponse& response);
+    void gatherTemplate(TemplateResponse& response);
+    void queueChunk(std::string data, bool full);
+    void releaseChunks(Exchange& exchange);
+    void checkDrained();
+
+    // the size of the write buffers from the given one on
+    std::size_t gatheredBytes(std::size_t first) const;
+    void logAccess(const Exchange& exchange);
+
+    // the exchange whose request waits for a response - nullptr if every dispatched request was answered
+    Exchange* answering();
+    void answered();
+
+    void sendJson(boost::beast::http::status status, const nlohmann::json& data);
+
+    // the response of the exchange with an empty body - sendTemplate answers the request once the body is set
+    TemplateResponse& emplaceTemplate(Exchange& exchange, boost::beast::http::status status,
+                                      std::string_view contentType);
+    void sendTemplate(Exchange& exchange);
+
+    // ranges of a cached file are copied into a string response
+    void sendCachedRanges(Exchange& exchange, const StaticFileCache::Entry& entry,
+                          boost::beast::string_view contentType, ByteRanges::Result result,
+                          const std::vector<ByteRanges::Range>& ranges);
+    void sendRangeNotSatisfiable(Exchange& exchange, std::uint64_t size);
+
+    // compresses the body of the template response - large bodies on the worker pool
+    void sendCompressed(Exchange& exchange, Compression::Encoding encoding);
+    void setCompressedBody(Exchange& exchange, std::string_view body, Compression::Encoding encoding);
+
+    // the state of the session is only touched by the thread that runs its strand - calls from other threads are posted
+    bool runningInSessionThread();
+
+    template <class Function>
+    void postToSession(Function function);
+
+    void handleRequest(Exchange& exchange);
 
-    template <bool isRequest, class Body, class Fields>
-    void send(boost::beast::http::message<isRequest, Body, Fields>&& response);
+    // sends "500 Internal Server Error" unless the request with the given sequence was answered in the meantime - an
+    // offloaded callback may throw after it answered
+    void sendServerError(std::uint64_t sequence, boost::beast::string_view what);
 
-    void handleRequest();
+    friend RestServer;
 };
 }  // namespace rgpaul
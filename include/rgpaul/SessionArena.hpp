@@ -0,0 +1,86 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+#include <boost/beast/http.hpp>
+
+namespace rgpaul
+{
+//! A monotonic memory resource for everything a session allocates while it handles one request.
+//! Deallocations are ignored and reset() hands out the memory again from the start. If a request needed more than one
+//! block, reset() replaces the blocks by one block that is large enough for all of them - so a keep-alive connection
+//! stops allocating as soon as the arena has grown to the size of its largest request. Requests that needed more than
+//! kMaxRetainedSize (e.g. large bodies) don't keep their memory - the arena shrinks to its initial size again.
+class SessionArena : public std::pmr::memory_resource
+{
+  public:
+    //! the most memory reset() keeps for the next request
+    static constexpr std::size_t kMaxRetainedSize = 256 * 1024;
+
+    explicit SessionArena(std::size_t initialSize = kDefaultSize);
+    ~SessionArena() override;
+
+    SessionArena(const SessionArena&) = delete;
+    SessionArena& operator=(const SessionArena&) = delete;
+
+    //! makes all memory available again - everything that was allocated before must not be used anymore
+    void reset();
+
+    //! the number of bytes the arena can hand out without allocating
+    std::size_t capacity() const;
+
+    //! the number of blocks that were requested from the global heap since the arena was created
+    std::size_t blockAllocations() const;
+
+  private:
+    static constexpr std::size_t kDefaultSize = 8192;
+
+    // placed at the start of every block
+    struct alignas(alignof(std::max_align_t)) Block
+    {
+        Block* next;
+        std::size_t size;
+    };
+
+    std::size_t _initialSize;
+    Block* _blocks {nullptr};
+    char* _position {nullptr};
+    std::size_t _remaining {0};
+    std::size_t _blockAllocations {0};
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    void addBlock(std::size_t size);
+    void releaseBlocks();
+};
+
+//! the allocator of the request and response messages - it uses the arena of the session
+using ArenaAllocator = std::pmr::polymorphic_allocator<char>;
+using ArenaFields = boost::beast::http::basic_fields<ArenaAllocator>;
+using ArenaStringBody = boost::beast::http::basic_string_body<char, std::char_traits<char>, ArenaAllocator>;
+}  // namespace rgpaul
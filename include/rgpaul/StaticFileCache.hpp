@@ -0,0 +1,162 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <rgpaul/Compression.hpp>
+
+namespace rgpaul
+{
+//! An in-memory cache for files that are served with Session::sendFile (RestServer::setStaticFileCache).
+//! Every entry holds the body of a file together with its pre-serialized header fields, a strong ETag and the
+//! Last-Modified date, so a cached file is answered without touching the file system - requests whose If-None-Match or
+//! If-Modified-Since matches are answered with "304 Not Modified". The least recently used files are evicted once the
+//! cache exceeds its capacity. On Linux the directories of the cached files are watched with inotify and changed files
+//! are dropped from the cache, on other platforms invalidate() has to be called.
+//! Precompressed siblings of a file ("<path>.br", "<path>.zst", "<path>.gz") are cached together with it.
+class StaticFileCache
+{
+  public:
+    //! a cached file - it stays valid while it is referenced, even if it is evicted in the meantime
+    struct Entry
+    {
+        std::string body;
+
+        //! the header fields of a "200 OK" and a "304 Not Modified" response (each line ends with CRLF)
+        std::string fields;
+        std::string notModifiedFields;
+
+        std::string etag;
+        std::string lastModified;
+        std::time_t modified {0};
+
+        //! the content coding of the body - Identity for the file itself
+        Compression::Encoding encoding {Compression::Encoding::Identity};
+
+        //! the precompressed siblings of the file in the order of Compression::kPrecompressed (their fields contain
+        //! Content-Encoding and the content type of the file)
+        std::vector<std::shared_ptr<const Entry>> variants;
+    };
+
+    struct Metrics
+    {
+        std::uint64_t hits {0};
+        std::uint64_t misses {0};
+        std::uint64_t evictions {0};
+
+        //! entries that were dropped because their file changed
+        std::uint64_t invalidations {0};
+    };
+
+    //! capacity is the number of bytes all entries may use - larger files than maxFileSize are not cached
+    explicit StaticFileCache(std::size_t capacity = 64 * 1024 * 1024, std::size_t maxFileSize = 1024 * 1024);
+
+    //! stops watching the directories
+    ~StaticFileCache();
+
+    StaticFileCache(const StaticFileCache&) = delete;
+    StaticFileCache& operator=(const StaticFileCache&) = delete;
+
+    //! returns the cached file and loads it on a miss - nullptr if the file can't be read or is too large
+    std::shared_ptr<const Entry> get(const std::string& path);
+
+    //! drops the file from the cache
+    void invalidate(const std::string& path);
+    void clear();
+
+    //! the number of cached files and the bytes they use
+    std::size_t count() const;
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+    std::size_t maxFileSize() const;
+    Metrics metrics() const;
+
+    //! true if the validators of a request match the entry, so it can be answered with "304 Not Modified"
+    //! (If-Modified-Since is only evaluated without If-None-Match)
+    static bool notModified(const Entry& entry, std::string_view ifNoneMatch, std::string_view ifModifiedSince);
+
+    //! formats and parses the date format of HTTP (e.g. "Sun, 06 Nov 1994 08:49:37 GMT") - parse returns -1 for
+    //! invalid dates
+    static std::string formatHttpDate(std::time_t time);
+    static std::time_t parseHttpDate(std::string_view date);
+
+  private:
+    struct Node
+    {
+        std::string path;
+        std::shared_ptr<const Entry> entry;
+        std::size_t size;
+
+        // the inotify watch of the directory and the name of the file in it
+        int watch;
+        std::string fileName;
+    };
+
+    std::size_t _capacity;
+    std::size_t _maxFileSize;
+
+    // the most recently used file is at the front
+    mutable std::mutex _mutex;
+    std::list<Node> _lru;
+    std::unordered_map<std::string_view, std::list<Node>::iterator> _index;
+    std::size_t _size {0};
+    Metrics _metrics;
+
+    // counts the changes of cached or loading files - an entry that was loaded during a change isn't cached
+    std::uint64_t _generation {0};
+
+    // a file in a watched directory - its cached nodes and the misses that are loading it
+    struct WatchedFile
+    {
+        std::vector<std::list<Node>::iterator> nodes;
+        std::size_t loading {0};
+    };
+
+    // inotify - one watch per directory that contains a cached file, the files of the watches by name
+    int _inotify {-1};
+    int _wakeup {-1};
+    std::unordered_map<std::string, int> _watches;
+    std::unordered_map<int, std::unordered_map<std::string, WatchedFile>> _watchedFiles;
+    std::thread _watcher;
+
+    std::shared_ptr<Entry> load(const std::string& path) const;
+    std::shared_ptr<Entry> read(const std::string& path) const;
+    int watchDirectory(const std::string& path, std::string& fileName);
+    void watch();
+    bool fileChanged(int watch, const std::string& fileName);
+    void forgetFile(int watch, const std::string& fileName, const Node* node);
+    void erase(std::list<Node>::iterator node);
+};
+}  // namespace rgpaul
@@ -0,0 +1,95 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace rgpaul
+{
+//! Where the threads of the server run.
+//! A placement resolves to a list of cpus - thread i is pinned to cpus()[i % cpus().size()] and (optionally) allocates
+//! its memory from the NUMA node of that cpu. Pinning and NUMA binding are only supported on Linux, on other
+//! platforms the threads are only named.
+class ThreadPlacement
+{
+  public:
+    enum class Policy
+    {
+        //! the kernel decides (default)
+        None,
+
+        //! an explicit list of cpus
+        Cpus,
+
+        //! the first hardware thread of every physical core - the hyper-threading siblings stay free
+        PhysicalCores,
+
+        //! the cpus that handle the receive queues of a network interface (IRQ affinity or RPS) - combined with
+        //! RestServer::ExecutionModel::ContextPerThread a connection is processed on the cpu its packets arrive on
+        NicQueues
+    };
+
+    //! threads are not pinned
+    ThreadPlacement() = default;
+
+    static ThreadPlacement onCpus(std::vector<unsigned> cpus);
+    static ThreadPlacement onPhysicalCores();
+    static ThreadPlacement onNicQueues(const std::string& interface);
+
+    //! allocate the memory of every thread from the NUMA node of its cpu (default: true)
+    ThreadPlacement& bindMemory(bool bind);
+
+    Policy policy() const;
+    bool bindsMemory() const;
+
+    //! the resolved cpus - empty if the threads are not pinned
+    const std::vector<unsigned>& cpus() const;
+
+    //! the cpu of the thread with the given index or -1 if it is not pinned
+    int cpuForThread(std::size_t index) const;
+
+    //! pins the calling thread as the thread with the given index and names it
+    void apply(std::size_t index, const std::string& name) const;
+
+    //! the cpus the process may run on
+    static std::vector<unsigned> availableCpus();
+
+    //! the first available hardware thread of every physical core
+    static std::vector<unsigned> physicalCoreCpus();
+
+    //! the cpus that handle the receive queues of the given interface in queue order - empty if there are none
+    static std::vector<unsigned> nicQueueCpus(const std::string& interface);
+
+    //! the NUMA node of the given cpu or -1 if it is unknown
+    static int numaNode(unsigned cpu);
+
+    //! names the calling thread (truncated to 15 characters, the limit of Linux)
+    static void setThreadName(const std::string& name);
+
+  private:
+    Policy _policy {Policy::None};
+    std::vector<unsigned> _cpus;
+    bool _bindMemory {true};
+};
+}  // namespace rgpaul
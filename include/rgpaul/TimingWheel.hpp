@@ -0,0 +1,135 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+namespace rgpaul
+{
+//! A hashed timing wheel for the deadlines of the connections of a thread.
+//! The wheel ticks every 100 ms while it holds deadlines and visits one slot per tick. Moving a deadline that is in a
+//! wheel to a later time is a single atomic store - the wheel finds the new time when it visits the slot and moves the
+//! deadline to the slot of that time, so a keep-alive connection doesn't add and cancel a timer for every request.
+class TimingWheel : public std::enable_shared_from_this<TimingWheel>
+{
+  public:
+    //! the granularity of the deadlines
+    static constexpr std::chrono::milliseconds kTick {100};
+
+    //! one revolution takes 102.4 s - longer deadlines stay in their slot for several revolutions
+    static constexpr std::size_t kSlots = 1024;
+
+    //! a deadline that can be moved and disarmed from one thread at a time (e.g. the strand of a session)
+    class Deadline
+    {
+      public:
+        Deadline() = default;
+        ~Deadline();
+
+        Deadline(const Deadline&) = delete;
+        Deadline& operator=(const Deadline&) = delete;
+
+        //! called on the thread of the wheel once the deadline passed - it may have been moved in the meantime, so the
+        //! owner checks expired() on its own thread (must be set before the deadline is armed the first time)
+        void setHandler(std::function<void()> handler);
+
+        //! arms the deadline - it is added to the wheel of the calling thread if it isn't in a wheel already
+        void expiresAfter(boost::asio::io_context& context, std::chrono::milliseconds timeout);
+
+        //! disarms the deadline - the wheel drops it when it visits its slot
+        void expiresNever();
+
+        //! adds an armed deadline that was dropped by its wheel to the wheel of the calling thread again
+        void reschedule(boost::asio::io_context& context);
+
+        bool armed() const;
+
+        //! true if the deadline is armed and passed
+        bool expired() const;
+
+      private:
+        friend TimingWheel;
+
+        static constexpr std::uint64_t kNever = UINT64_MAX;
+
+        // the tick the deadline expires with - written by the owner, read by the wheel
+        std::atomic<std::uint64_t> _tick {kNever};
+
+        // the last armed tick - the deadline is never in the slot of a later tick, so only earlier deadlines have to
+        // be moved in the wheel right away (only used by the owner)
+        std::uint64_t _armedTick {0};
+
+        // changed by the wheel under its mutex
+        std::atomic<bool> _linked {false};
+
+        // the wheel the deadline was added to last - only used by the owner
+        std::shared_ptr<TimingWheel> _wheel;
+        std::function<void()> _handler;
+
+        // the list of the slot - guarded by the mutex of the wheel
+        Deadline* _previous {nullptr};
+        Deadline* _next {nullptr};
+        std::size_t _slot {0};
+    };
+
+    explicit TimingWheel(boost::asio::io_context& context);
+
+    //! the wheel of the calling thread - created on first use (the thread runs the given context)
+    static std::shared_ptr<TimingWheel> local(boost::asio::io_context& context);
+
+    //! the current time in ticks
+    static std::uint64_t now();
+
+    //! the number of deadlines in the wheel (including disarmed ones that weren't visited yet)
+    std::size_t size() const;
+
+  private:
+    boost::asio::io_context& _context;
+    boost::asio::steady_timer _timer;
+
+    mutable std::mutex _mutex;
+    std::array<Deadline*, kSlots> _slots {};
+    std::size_t _size {0};
+
+    // the last tick whose slot was visited
+    std::uint64_t _visited;
+    bool _waiting {false};
+
+    // all of them are called with the mutex locked
+    void add(Deadline& deadline);
+    void link(Deadline& deadline, std::uint64_t tick);
+    void unlink(Deadline& deadline);
+    void wait();
+
+    void onTick(boost::system::error_code ec);
+};
+}  // namespace rgpaul
@@ -0,0 +1,58 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace rgpaul
+{
+//! Percent encoding kernels behind RestServer::urlEncode and RestServer::urlDecode.
+//! The vectorized kernels copy runs of characters that need no work in blocks of 16 (SSE2) or 32 (AVX2) bytes and only
+//! fall back to the scalar code for the bytes that have to be escaped or unescaped. The fastest kernel the CPU supports
+//! is selected at runtime.
+class UrlCodec
+{
+  public:
+    enum class Kernel
+    {
+        scalar,
+        sse2,
+        avx2
+    };
+
+    //! the kernel that is used by encode and decode without an explicit kernel
+    static Kernel activeKernel();
+
+    //! checks if the kernel is compiled in and supported by the CPU
+    static bool isSupported(Kernel kernel);
+
+    //! encodes everything except alphanumeric characters - output needs space for 3 * length characters
+    //! returns the number of characters written to output
+    static std::size_t encode(const char* input, std::size_t length, char* output);
+    static std::size_t encode(const char* input, std::size_t length, char* output, Kernel kernel);
+
+    //! decodes "%XX" sequences - output needs space for length characters and may be the same as input
+    //! returns the number of characters written to output
+    static std::size_t decode(const char* input, std::size_t length, char* output);
+    static std::size_t decode(const char* input, std::size_t length, char* output, Kernel kernel);
+};
+}  // namespace rgpaul
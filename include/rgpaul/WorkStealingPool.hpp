@@ -0,0 +1,120 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rgpaul
+{
+//! A thread pool for callbacks that would block the i/o threads for too long.
+//! Every worker has two bounded queues: tasks from other threads are spread over the workers and run in the order
+//! they were submitted, tasks that a worker submits itself are pushed to its own deque. A worker takes the newest task
+//! of its deque first, then the oldest submitted task - if it has neither it steals the oldest task of another worker.
+class WorkStealingPool
+{
+  public:
+    using Task = std::function<void()>;
+
+    struct Metrics
+    {
+        //! the number of queued tasks of every worker
+        std::vector<std::size_t> queueDepths;
+
+        std::uint64_t executed {0};
+
+        //! tasks that were taken from the deque of another worker
+        std::uint64_t stolen {0};
+
+        //! tasks that were not accepted because all queues were full
+        std::uint64_t rejected {0};
+    };
+
+    //! starts the given number of workers (at least one) - every queue holds up to queueCapacity tasks
+    explicit WorkStealingPool(std::size_t threads, std::size_t queueCapacity = kDefaultQueueCapacity);
+
+    //! runs the remaining tasks and joins the workers
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    //! queues the task - returns false if it was rejected because all queues are full
+    bool submit(Task task);
+
+    std::size_t threadCount() const;
+    Metrics metrics() const;
+
+  private:
+    static constexpr std::size_t kDefaultQueueCapacity = 1024;
+
+    // ring buffer of tasks - guarded by the mutex of its worker
+    struct Ring
+    {
+        std::vector<Task> tasks;
+        std::size_t head {0};
+        std::size_t size {0};
+
+        bool pushBack(Task& task);
+        bool popBack(Task& task);
+        bool popFront(Task& task);
+    };
+
+    struct alignas(64) Worker
+    {
+        // the owner works at the back of its own deque and at the front of the submitted tasks, thieves at the fronts
+        std::mutex mutex;
+        Ring own;
+        Ring submitted;
+
+        std::atomic<std::size_t> depth {0};
+        std::atomic<std::uint64_t> executed {0};
+        std::atomic<std::uint64_t> stolen {0};
+
+        std::thread thread;
+
+        bool push(Task& task, bool fromOwner);
+        bool pop(Task& task);
+        bool steal(Task& task);
+    };
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<std::size_t> _nextWorker {0};
+    std::atomic<std::uint64_t> _rejected {0};
+
+    // the number of queued tasks - workers sleep while it is 0
+    std::atomic<std::size_t> _pending {0};
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeup;
+    bool _stopping {false};
+
+    void run(std::size_t index);
+    bool findTask(std::size_t index, Task& task);
+};
+}  // namespace rgpaul
@@ -0,0 +1,279 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/AccessLog.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include <boost/asio/ip/address_v6.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <rgpaul/CivilDate.hpp>
+#include <rgpaul/Request.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the header of a log file - the record size changes with the format
+struct FileHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+constexpr std::array<char, 8> kMagic {'R', 'G', 'P', 'A', 'L', 'O', 'G', '\0'};
+constexpr std::uint32_t kVersion = 1;
+
+std::atomic<std::uint64_t> nextId {1};
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+AccessLog::AccessLog(const std::string& path) : _id(nextId++)
+{
+    _file.open(path, std::ios::binary | std::ios::app);
+    if (!_file)
+    {
+        BOOST_LOG_TRIVIAL(error) << "access log: can't open '" << path << "'.";
+        return;
+    }
+
+    // a new file gets the header - an existing one is continued
+    _file.seekp(0, std::ios::end);
+    if (_file.tellp() == 0)
+    {
+        FileHeader header {kMagic, kVersion, sizeof(Record)};
+        _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    _drainer = std::thread([this] {
+        std::unique_lock<std::mutex> lock(_drainMutex);
+
+        while (!_stopping)
+        {
+            _wakeup.wait_for(lock, kDrainInterval);
+            drain();
+        }
+    });
+}
+
+AccessLog::~AccessLog()
+{
+    if (!_drainer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_drainMutex);
+        _stopping = true;
+    }
+
+    _wakeup.notify_one();
+    _drainer.join();
+
+    // records that were logged while the thread stopped
+    std::lock_guard<std::mutex> lock(_drainMutex);
+    drain();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+void AccessLog::log(const Record& record)
+{
+    if (!isOpen())
+        return;
+
+    Ring& ring = localRing();
+    std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    std::uint64_t size = head - ring.tail.load(std::memory_order_acquire);
+
+    if (size == kRingSize)
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring.records[head % kRingSize] = record;
+    ring.head.store(head + 1, std::memory_order_release);
+
+    // a busy thread doesn't wait for the next interval
+    if (size == kRingSize / 2)
+        _wakeup.notify_one();
+}
+
+void AccessLog::flush()
+{
+    std::lock_guard<std::mutex> lock(_drainMutex);
+    drain();
+}
+
+bool AccessLog::isOpen() const
+{
+    return _drainer.joinable();
+}
+
+AccessLog::Metrics AccessLog::metrics() const
+{
+    return {_written.load(std::memory_order_relaxed), _dropped.load(std::memory_order_relaxed)};
+}
+
+std::vector<AccessLog::Record> AccessLog::read(const std::string& path)
+{
+    std::vector<Record> records;
+    std::ifstream file(path, std::ios::binary);
+
+    FileHeader header {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kMagic
+        || header.version != kVersion || header.recordSize != sizeof(Record))
+    {
+        BOOST_LOG_TRIVIAL(error) << "access log: '" << path << "' is no access log.";
+        return records;
+    }
+
+    Record record {};
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) records.push_back(record);
+
+    return records;
+}
+
+std::string AccessLog::format(const Record& record)
+{
+    std::uint64_t seconds = record.timestamp / 1000000;
+    CivilDate date = CivilDate::fromDays(static_cast<std::int64_t>(seconds / 86400));
+
+    char timestamp[40];
+    std::snprintf(timestamp, sizeof(timestamp), "%04lld-%02u-%02uT%02u:%02u:%02u.%06uZ",
+                  static_cast<long long>(date.year), date.month, date.day, static_cast<unsigned>(seconds % 86400 / 3600),
+                  static_cast<unsigned>(seconds % 3600 / 60), static_cast<unsigned>(seconds % 60),
+                  static_cast<unsigned>(record.timestamp % 1000000));
+
+    boost::asio::ip::address peer = address(record);
+
+    std::ostringstream line;
+    line << timestamp << ' ';
+
+    if (peer.is_v6())
+        line << '[' << peer << "]:" << record.port << ' ';
+    else
+        line << peer << ':' << record.port << ' ';
+
+    line << boost::beast::http::to_string(static_cast<boost::beast::http::verb>(record.method)) << ' ';
+
+    if (record.route == Request::kNoRoute)
+        line << '-';
+    else
+        line << '/' << record.route;
+
+    line << ' ' << record.status << ' ' << record.bytes << " B " << record.latency << " us";
+    return line.str();
+}
+
+std::array<std::uint8_t, 16> AccessLog::addressBytes(const boost::asio::ip::address& address)
+{
+    if (address.is_v4())
+        return boost::asio::ip::make_address_v6(boost::asio::ip::v4_mapped, address.to_v4()).to_bytes();
+
+    return address.to_v6().to_bytes();
+}
+
+boost::asio::ip::address AccessLog::address(const Record& record)
+{
+    boost::asio::ip::address_v6 address(record.address);
+
+    if (address.is_v4_mapped())
+        return boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, address);
+
+    return address;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+AccessLog::Ring& AccessLog::localRing()
+{
+    // the ring of the log the thread used last - a thread that logs for several logs looks its ring up when it changes
+    struct Local
+    {
+        std::uint64_t log {0};
+        std::shared_ptr<Ring> ring;
+    };
+    thread_local Local local;
+
+    if (local.log != _id)
+    {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+
+        std::shared_ptr<Ring>& ring = _rings[std::this_thread::get_id()];
+        if (!ring)
+            ring = std::make_shared<Ring>();
+
+        local.log = _id;
+        local.ring = ring;
+    }
+
+    return *local.ring;
+}
+
+void AccessLog::drain()
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        rings.reserve(_rings.size());
+        for (const auto& entry : _rings) rings.push_back(entry.second);
+    }
+
+    std::uint64_t written = 0;
+
+    for (const auto& ring : rings)
+    {
+        std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+
+        // at most two blocks - the records before and after the end of the ring
+        while (tail != head)
+        {
+            std::size_t first = tail % kRingSize;
+            std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(head - tail, kRingSize - first));
+
+            _file.write(reinterpret_cast<const char*>(&ring->records[first]), count * sizeof(Record));
+            tail += count;
+            written += count;
+        }
+
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    if (written > 0)
+    {
+        _file.flush();
+        _written.fetch_add(written, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/ByteRanges.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include <rgpaul/HeaderValues.hpp>
+#include <rgpaul/StaticFileCache.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// parses a position - positions beyond the largest number are as good as the end of any representation
+bool parsePosition(std::string_view text, std::uint64_t& value)
+{
+    if (text.empty())
+        return false;
+
+    constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    value = 0;
+
+    for (char c : text)
+    {
+        if (c < '0' || c > '9')
+            return false;
+
+        auto digit = static_cast<std::uint64_t>(c - '0');
+        value = value > (max - digit) / 10 ? max : value * 10 + digit;
+    }
+
+    return true;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+ByteRanges::Result ByteRanges::parse(std::string_view header, std::uint64_t size, std::vector<Range>& ranges)
+{
+    ranges.clear();
+
+    header = HeaderValues::trim(header);
+    if (header.size() < 6 || !HeaderValues::iequals(header.substr(0, 6), "bytes="))
+        return Result::Ignored;
+
+    header.remove_prefix(6);
+    std::size_t count = 0;
+
+    while (!header.empty())
+    {
+        std::size_t end = std::min(header.find(','), header.size());
+        std::string_view spec = HeaderValues::trim(header.substr(0, end));
+        header.remove_prefix(std::min(end + 1, header.size()));
+
+        // empty list elements are allowed
+        if (spec.empty())
+            continue;
+
+        if (++count > kMaxRanges)
+        {
+            ranges.clear();
+            return Result::Ignored;
+        }
+
+        std::size_t dash = spec.find('-');
+        if (dash == std::string_view::npos)
+        {
+            ranges.clear();
+            return Result::Ignored;
+        }
+
+        std::string_view firstText = HeaderValues::trim(spec.substr(0, dash));
+        std::string_view lastText = HeaderValues::trim(spec.substr(dash + 1));
+        std::uint64_t first = 0;
+        std::uint64_t last = std::numeric_limits<std::uint64_t>::max();
+
+        // "-500" - the last 500 bytes
+        if (firstText.empty())
+        {
+            std::uint64_t suffix = 0;
+            if (!parsePosition(lastText, suffix))
+            {
+                ranges.clear();
+                return Result::Ignored;
+            }
+
+            if (suffix > 0 && size > 0)
+                ranges.push_back({size - std::min(suffix, size), size - 1});
+
+            continue;
+        }
+
+        if (!parsePosition(firstText, first) || (!lastText.empty() && !parsePosition(lastText, last)) || last < first)
+        {
+            ranges.clear();
+            return Result::Ignored;
+        }
+
+        // a range that starts behind the representation can't be satisfied - the others may be
+        if (first < size)
+            ranges.push_back({first, std::min(last, size - 1)});
+    }
+
+    if (count == 0)
+        return Result::Ignored;
+
+    if (ranges.empty())
+        return Result::Unsatisfiable;
+
+    // merge overlapping and adjacent ranges
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.first < b.first; });
+
+    std::size_t merged = 0;
+    for (std::size_t i = 1; i < ranges.size(); ++i)
+    {
+        if (ranges[i].first <= ranges[merged].last + 1)
+            ranges[merged].last = std::max(ranges[merged].last, ranges[i].last);
+        else
+            ranges[++merged] = ranges[i];
+    }
+    ranges.resize(merged + 1);
+
+    return Result::Satisfiable;
+}
+
+bool ByteRanges::ifRangeMatches(std::string_view ifRange, std::string_view etag, std::time_t modified)
+{
+    ifRange = HeaderValues::trim(ifRange);
+    if (ifRange.empty())
+        return true;
+
+    // weak entity tags never match
+    if (ifRange.front() == '"' || ifRange.substr(0, 2) == "W/")
+        return !etag.empty() && ifRange == etag;
+
+    std::time_t date = StaticFileCache::parseHttpDate(ifRange);
+    return date >= 0 && date == modified;
+}
+
+std::string ByteRanges::contentRange(const Range& range, std::uint64_t size)
+{
+    return "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) + "/" + std::to_string(size);
+}
+
+std::string ByteRanges::contentRange(std::uint64_t size)
+{
+    return "bytes */" + std::to_string(size);
+}
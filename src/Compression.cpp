@@ -0,0 +1,238 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/Compression.hpp>
+
+#include <algorithm>
+#include <climits>
+
+#include <boost/log/trivial.hpp>
+
+#include <rgpaul/HeaderValues.hpp>
+
+#include <zlib.h>
+
+using namespace rgpaul;
+
+namespace
+{
+// a deflate stream of the calling thread - it is reset for every body, so its window isn't allocated again
+class Deflater
+{
+  public:
+    ~Deflater()
+    {
+        if (_level >= 0)
+            deflateEnd(&_stream);
+    }
+
+    z_stream* get(bool gzip, int level)
+    {
+        if (_level == level)
+        {
+            if (deflateReset(&_stream) == Z_OK)
+                return &_stream;
+        }
+
+        if (_level >= 0)
+            deflateEnd(&_stream);
+
+        _level = -1;
+        _stream = {};
+
+        // 15 window bits - 16 more select the gzip wrapper instead of the zlib one
+        if (deflateInit2(&_stream, level, Z_DEFLATED, gzip ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return nullptr;
+
+        _level = level;
+        return &_stream;
+    }
+
+  private:
+    z_stream _stream {};
+    int _level {-1};
+};
+
+// the quality of the coding in Accept-Encoding (or of *) - -1 if the client doesn't name it
+int namedQuality(std::string_view acceptEncoding, std::string_view token, bool gzip)
+{
+    int wildcard = -1;
+
+    while (!acceptEncoding.empty())
+    {
+        std::size_t end = std::min(acceptEncoding.find(','), acceptEncoding.size());
+        std::string_view element = acceptEncoding.substr(0, end);
+        acceptEncoding.remove_prefix(std::min(end + 1, acceptEncoding.size()));
+
+        // "gzip;q=0.5" - a coding without a weight has the quality 1
+        std::size_t semicolon = std::min(element.find(';'), element.size());
+        std::string_view coding = HeaderValues::trim(element.substr(0, semicolon));
+        int quality = 1000;
+
+        if (semicolon < element.size())
+        {
+            std::string_view parameter = HeaderValues::trim(element.substr(semicolon + 1));
+            if (parameter.size() < 2 || (parameter[0] != 'q' && parameter[0] != 'Q') || parameter[1] != '=')
+                continue;
+
+            quality = HeaderValues::parseQuality(HeaderValues::trim(parameter.substr(2)));
+            if (quality < 0)
+                continue;
+        }
+
+        bool alias = gzip && HeaderValues::iequals(coding, "x-gzip");
+        if (alias || HeaderValues::iequals(coding, token))
+            return quality;
+
+        if (coding == "*")
+            wildcard = quality;
+    }
+
+    return wildcard;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string_view Compression::name(Encoding encoding)
+{
+    switch (encoding)
+    {
+        case Encoding::Gzip:
+            return "gzip";
+        case Encoding::Deflate:
+            return "deflate";
+        case Encoding::Brotli:
+            return "br";
+        case Encoding::Zstd:
+            return "zstd";
+        default:
+            return "identity";
+    }
+}
+
+std::string_view Compression::extension(Encoding encoding)
+{
+    switch (encoding)
+    {
+        case Encoding::Gzip:
+            return ".gz";
+        case Encoding::Brotli:
+            return ".br";
+        case Encoding::Zstd:
+            return ".zst";
+        default:
+            return {};
+    }
+}
+
+int Compression::quality(std::string_view acceptEncoding, Encoding encoding)
+{
+    int quality = namedQuality(acceptEncoding, name(encoding), encoding == Encoding::Gzip);
+    if (quality >= 0)
+        return quality;
+
+    return encoding == Encoding::Identity ? 1000 : 0;
+}
+
+int Compression::minimumQuality(std::string_view acceptEncoding)
+{
+    return std::max(namedQuality(acceptEncoding, name(Encoding::Identity), false), 0);
+}
+
+Compression::Encoding Compression::negotiate(std::string_view acceptEncoding,
+                                             std::initializer_list<Encoding> candidates)
+{
+    Encoding best = Encoding::Identity;
+    int bestQuality = 0;
+
+    if (acceptEncoding.empty())
+        return best;
+
+    // "gzip;q=0.1, identity" - the client prefers the uncompressed body (a candidate wins a tie with identity)
+    int minimum = minimumQuality(acceptEncoding);
+
+    for (Encoding candidate : candidates)
+    {
+        int value = quality(acceptEncoding, candidate);
+        if (value > bestQuality && value >= minimum)
+        {
+            best = candidate;
+            bestQuality = value;
+        }
+    }
+
+    return best;
+}
+
+bool Compression::compress(std::string_view data, Encoding encoding, int level, std::string& output)
+{
+    if (encoding != Encoding::Gzip && encoding != Encoding::Deflate)
+        return false;
+
+    thread_local Deflater gzipDeflater;
+    thread_local Deflater zlibDeflater;
+
+    level = std::clamp(level, 1, 9);
+    z_stream* stream = encoding == Encoding::Gzip ? gzipDeflater.get(true, level) : zlibDeflater.get(false, level);
+    if (!stream)
+    {
+        BOOST_LOG_TRIVIAL(error) << "compress: the zlib stream can't be initialized";
+        return false;
+    }
+
+    // the bound is enough for a single deflate call - zlib counts in uInt, so larger bodies are passed in pieces
+    output.resize(deflateBound(stream, static_cast<uLong>(data.size())));
+
+    stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream->next_out = reinterpret_cast<Bytef*>(output.data());
+
+    std::size_t remainingIn = data.size();
+    std::size_t remainingOut = output.size();
+    int result = Z_OK;
+
+    while (result == Z_OK)
+    {
+        stream->avail_in = static_cast<uInt>(std::min<std::size_t>(remainingIn, UINT_MAX));
+        stream->avail_out = static_cast<uInt>(std::min<std::size_t>(remainingOut, UINT_MAX));
+        uInt availIn = stream->avail_in;
+        uInt availOut = stream->avail_out;
+
+        result = deflate(stream, remainingIn == stream->avail_in ? Z_FINISH : Z_NO_FLUSH);
+
+        remainingIn -= availIn - stream->avail_in;
+        remainingOut -= availOut - stream->avail_out;
+
+        if (result == Z_BUF_ERROR && remainingOut == 0)
+            break;
+    }
+
+    if (result != Z_STREAM_END)
+    {
+        BOOST_LOG_TRIVIAL(error) << "compress: " << (stream->msg ? stream->msg : "the output doesn't fit");
+        return false;
+    }
+
+    output.resize(output.size() - remainingOut);
+    return true;
+}
@@ -0,0 +1,170 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/ConnectionLimiter.hpp>
+
+#include <utility>
+
+using namespace rgpaul;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+ConnectionLimiter::ConnectionLimiter() : _limits() {}
+
+ConnectionLimiter::ConnectionLimiter(Limits limits) : _limits(limits) {}
+
+ConnectionLimiter::Ticket::Ticket(Ticket&& other) noexcept
+    : _limiter(std::move(other._limiter)), _address(other._address)
+{
+}
+
+ConnectionLimiter::Ticket& ConnectionLimiter::Ticket::operator=(Ticket&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (_limiter)
+            _limiter->release(_address);
+
+        _limiter = std::move(other._limiter);
+        _address = other._address;
+    }
+
+    return *this;
+}
+
+ConnectionLimiter::Ticket::~Ticket()
+{
+    if (_limiter)
+        _limiter->release(_address);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+ConnectionLimiter::Ticket::operator bool() const
+{
+    return _limiter != nullptr;
+}
+
+bool ConnectionLimiter::reserve(std::function<void()> resume)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_limits.connections != 0 && _reserved >= _limits.connections)
+    {
+        _paused.push_back(std::move(resume));
+        ++_deferred;
+        return false;
+    }
+
+    ++_reserved;
+    return true;
+}
+
+void ConnectionLimiter::cancel()
+{
+    std::function<void()> resume = freeReservation();
+
+    // called without the lock - the acceptor reserves again
+    if (resume)
+        resume();
+}
+
+ConnectionLimiter::Ticket ConnectionLimiter::admit(const boost::asio::ip::address& address)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        bool admitted = true;
+        if (_limits.connectionsPerAddress != 0)
+        {
+            std::size_t& count = _addressConnections[address];
+            admitted = count < _limits.connectionsPerAddress;
+            if (admitted)
+                ++count;
+        }
+
+        if (admitted)
+        {
+            ++_connections;
+
+            Ticket ticket;
+            ticket._limiter = shared_from_this();
+            ticket._address = address;
+            return ticket;
+        }
+
+        ++_rejected;
+    }
+
+    cancel();
+    return {};
+}
+
+const ConnectionLimiter::Limits& ConnectionLimiter::limits() const
+{
+    return _limits;
+}
+
+ConnectionLimiter::Metrics ConnectionLimiter::metrics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return {_connections, _rejected, _deferred};
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ConnectionLimiter::release(const boost::asio::ip::address& address)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        --_connections;
+
+        if (_limits.connectionsPerAddress != 0)
+        {
+            auto it = _addressConnections.find(address);
+            if (it != _addressConnections.end() && --it->second == 0)
+                _addressConnections.erase(it);
+        }
+    }
+
+    cancel();
+}
+
+std::function<void()> ConnectionLimiter::freeReservation()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    --_reserved;
+
+    if (_paused.empty())
+        return nullptr;
+
+    std::function<void()> resume = std::move(_paused.back());
+    _paused.pop_back();
+    return resume;
+}
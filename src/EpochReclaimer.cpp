@@ -0,0 +1,169 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/EpochReclaimer.hpp>
+
+#include <algorithm>
+
+#include <boost/log/trivial.hpp>
+
+namespace rgpaul
+{
+// the slot of the current thread and how deep its read guards are nested
+struct EpochReclaimerThreadState
+{
+    static constexpr int kNoSlot = -1;
+    static constexpr int kOverflow = -2;
+
+    int slot {kNoSlot};
+    unsigned depth {0};
+
+    ~EpochReclaimerThreadState()
+    {
+        if (slot >= 0)
+            EpochReclaimer::instance().releaseSlot(slot);
+    }
+};
+}  // namespace rgpaul
+
+using namespace rgpaul;
+
+namespace
+{
+thread_local EpochReclaimerThreadState threadState;
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// ReadGuard
+// ---------------------------------------------------------------------------------------------------------------------
+
+EpochReclaimer::ReadGuard::ReadGuard()
+{
+    EpochReclaimer::instance().enter();
+}
+
+EpochReclaimer::ReadGuard::~ReadGuard()
+{
+    EpochReclaimer::instance().leave();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+EpochReclaimer& EpochReclaimer::instance()
+{
+    static EpochReclaimer reclaimer;
+    return reclaimer;
+}
+
+void EpochReclaimer::retire(std::shared_ptr<const void> object)
+{
+    // readers that enter from now on get the new epoch and can't see the retired object
+    std::uint64_t epoch = _epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+    std::lock_guard<std::mutex> lock(_retiredMutex);
+    _retired.push_back({epoch, std::move(object)});
+}
+
+void EpochReclaimer::collect()
+{
+    std::vector<Retired> garbage;
+
+    {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+
+        if (_retired.empty() || _overflowReaders.load(std::memory_order_seq_cst) > 0)
+            return;
+
+        // the oldest epoch a reader is still in
+        std::uint64_t oldest = UINT64_MAX;
+        for (const auto& slot : _slots)
+        {
+            std::uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < oldest)
+                oldest = epoch;
+        }
+
+        // everything that was retired before the oldest reader entered can be deleted
+        auto it = std::partition(_retired.begin(), _retired.end(),
+                                 [oldest](const Retired& retired) { return retired.epoch > oldest; });
+
+        garbage.assign(std::make_move_iterator(it), std::make_move_iterator(_retired.end()));
+        _retired.erase(it, _retired.end());
+    }
+
+    // the objects are deleted here - outside of the lock
+}
+
+std::size_t EpochReclaimer::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(_retiredMutex);
+    return _retired.size();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+int EpochReclaimer::acquireSlot()
+{
+    for (std::size_t i = 0; i < _slots.size(); ++i)
+    {
+        bool expected = false;
+        if (_slots[i].used.compare_exchange_strong(expected, true))
+            return static_cast<int>(i);
+    }
+
+    BOOST_LOG_TRIVIAL(warning) << "epoch reclaimer: no free reader slot, falling back to the shared reader counter.";
+    return EpochReclaimerThreadState::kOverflow;
+}
+
+void EpochReclaimer::releaseSlot(int slot)
+{
+    _slots[slot].epoch.store(0, std::memory_order_release);
+    _slots[slot].used.store(false, std::memory_order_release);
+}
+
+void EpochReclaimer::enter()
+{
+    if (threadState.depth++ > 0)
+        return;
+
+    if (threadState.slot == EpochReclaimerThreadState::kNoSlot)
+        threadState.slot = acquireSlot();
+
+    if (threadState.slot >= 0)
+        _slots[threadState.slot].epoch.store(_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    else
+        _overflowReaders.fetch_add(1, std::memory_order_seq_cst);
+}
+
+void EpochReclaimer::leave()
+{
+    if (--threadState.depth > 0)
+        return;
+
+    if (threadState.slot >= 0)
+        _slots[threadState.slot].epoch.store(0, std::memory_order_release);
+    else
+        _overflowReaders.fetch_sub(1, std::memory_order_release);
+}
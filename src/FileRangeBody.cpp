@@ -0,0 +1,179 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/FileRangeBody.hpp>
+
+#include <algorithm>
+
+#include <boost/beast/http/error.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the size of the blocks the file is read in
+constexpr std::size_t kBlockSize = 64 * 1024;
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// value_type
+// ---------------------------------------------------------------------------------------------------------------------
+
+void FileRangeBody::value_type::open(const char* path, boost::beast::file_mode mode, boost::beast::error_code& ec)
+{
+    _file.open(path, mode, ec);
+    if (ec)
+        return;
+
+    _fileSize = _file.size(ec);
+    if (ec)
+    {
+        boost::beast::error_code ignored;
+        _file.close(ignored);
+        return;
+    }
+
+    setParts({{{}, 0, _fileSize}});
+}
+
+bool FileRangeBody::value_type::is_open() const
+{
+    return _file.is_open();
+}
+
+boost::beast::file& FileRangeBody::value_type::file()
+{
+    return _file;
+}
+
+std::uint64_t FileRangeBody::value_type::fileSize() const
+{
+    return _fileSize;
+}
+
+void FileRangeBody::value_type::setParts(std::vector<Part> parts, std::string suffix)
+{
+    _parts = std::move(parts);
+    _suffix = std::move(suffix);
+
+    _size = _suffix.size();
+    for (const Part& part : _parts) _size += part.prefix.size() + part.size;
+}
+
+const std::vector<FileRangeBody::Part>& FileRangeBody::value_type::parts() const
+{
+    return _parts;
+}
+
+const std::string& FileRangeBody::value_type::suffix() const
+{
+    return _suffix;
+}
+
+bool FileRangeBody::value_type::contiguous() const
+{
+    return _parts.size() == 1 && _parts.front().prefix.empty() && _suffix.empty();
+}
+
+std::uint64_t FileRangeBody::value_type::size() const
+{
+    return _size;
+}
+
+std::uint64_t FileRangeBody::size(const value_type& body)
+{
+    return body.size();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// writer
+// ---------------------------------------------------------------------------------------------------------------------
+
+void FileRangeBody::writer::init(boost::beast::error_code& ec)
+{
+    ec = {};
+
+    std::uint64_t largest = 0;
+    for (const Part& part : _body.parts()) largest = std::max(largest, part.size);
+
+    _bufferSize = static_cast<std::size_t>(std::min<std::uint64_t>(largest, kBlockSize));
+    if (_bufferSize > 0)
+        _buffer = std::make_unique<char[]>(_bufferSize);
+}
+
+boost::optional<std::pair<FileRangeBody::writer::const_buffers_type, bool>> FileRangeBody::writer::get(
+    boost::beast::error_code& ec)
+{
+    ec = {};
+    const auto& parts = _body.parts();
+
+    while (_part < parts.size())
+    {
+        const Part& part = parts[_part];
+
+        if (!_prefixWritten)
+        {
+            _prefixWritten = true;
+            if (!part.prefix.empty())
+                return {{boost::asio::const_buffer(part.prefix.data(), part.prefix.size()), true}};
+        }
+
+        if (_position < part.size)
+        {
+            // a new part starts somewhere else in the file
+            if (_position == 0)
+            {
+                _body.file().seek(part.offset, ec);
+                if (ec)
+                    return boost::none;
+            }
+
+            auto size = static_cast<std::size_t>(std::min<std::uint64_t>(part.size - _position, _bufferSize));
+            std::size_t read = _body.file().read(_buffer.get(), size, ec);
+            if (ec)
+                return boost::none;
+
+            // the file was truncated in the meantime
+            if (read == 0)
+            {
+                ec = boost::beast::http::error::short_read;
+                return boost::none;
+            }
+
+            _position += read;
+
+            bool more = _position < part.size || _part + 1 < parts.size() || !_body.suffix().empty();
+            return {{boost::asio::const_buffer(_buffer.get(), read), more}};
+        }
+
+        ++_part;
+        _prefixWritten = false;
+        _position = 0;
+    }
+
+    if (!_suffixWritten && !_body.suffix().empty())
+    {
+        _suffixWritten = true;
+        return {{boost::asio::const_buffer(_body.suffix().data(), _body.suffix().size()), false}};
+    }
+
+    return boost::none;
+}
@@ -0,0 +1,213 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/FileTransfer.hpp>
+
+#include <algorithm>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
+using namespace rgpaul;
+
+namespace
+{
+// the most sendfile and splice transfer with one call
+constexpr std::uint64_t kMaxTransfer = 0x7ffff000;
+
+// the bytes that are moved through the pipe of splice at once (the default capacity of a pipe)
+constexpr std::size_t kPipeSize = 64 * 1024;
+
+boost::system::error_code lastError()
+{
+    return boost::system::error_code(errno, boost::system::system_category());
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+FileTransfer::FileTransfer(boost::beast::file::native_handle_type file, std::uint64_t offset, std::uint64_t size)
+    : _file(file), _offset(offset), _remaining(size)
+{
+}
+
+FileTransfer::~FileTransfer()
+{
+#if defined(__linux__)
+    if (_pipe[0] >= 0)
+    {
+        ::close(_pipe[0]);
+        ::close(_pipe[1]);
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::size_t FileTransfer::send(boost::asio::ip::tcp::socket::native_handle_type socket, boost::system::error_code& ec)
+{
+    ec = {};
+    std::size_t sent = 0;
+
+    while (!ec && !done())
+    {
+        if (_method == Method::SendFile)
+            sent += sendFile(socket, ec);
+        else if (_method == Method::Splice)
+            sent += splice(socket, ec);
+        else
+            ec = boost::asio::error::operation_not_supported;
+    }
+
+    return sent;
+}
+
+bool FileTransfer::done() const
+{
+    return _remaining == 0 && _inPipe == 0;
+}
+
+std::uint64_t FileTransfer::remaining() const
+{
+    return _remaining + _inPipe;
+}
+
+FileTransfer::Method FileTransfer::method() const
+{
+    return _method;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+#if defined(__linux__)
+
+std::size_t FileTransfer::sendFile(boost::asio::ip::tcp::socket::native_handle_type socket,
+                                   boost::system::error_code& ec)
+{
+    off_t offset = static_cast<off_t>(_offset);
+    ssize_t sent = ::sendfile(socket, _file, &offset, std::min(_remaining, kMaxTransfer));
+
+    if (sent < 0)
+    {
+        // the file system doesn't support sendfile - as long as nothing was sent we can switch to splice
+        if ((errno == EINVAL || errno == ENOSYS) && !_started)
+            _method = Method::Splice;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            ec = boost::asio::error::would_block;
+        else if (errno != EINTR)
+            ec = lastError();
+
+        return 0;
+    }
+
+    // the file was truncated while it was sent
+    if (sent == 0)
+    {
+        ec = boost::asio::error::eof;
+        return 0;
+    }
+
+    _started = true;
+    _offset += static_cast<std::uint64_t>(sent);
+    _remaining -= static_cast<std::uint64_t>(sent);
+    return static_cast<std::size_t>(sent);
+}
+
+std::size_t FileTransfer::splice(boost::asio::ip::tcp::socket::native_handle_type socket,
+                                 boost::system::error_code& ec)
+{
+    if (_pipe[0] < 0 && ::pipe2(_pipe, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        ec = lastError();
+        return 0;
+    }
+
+    // refill the pipe once the socket took everything that was in it
+    if (_inPipe == 0)
+    {
+        loff_t offset = static_cast<loff_t>(_offset);
+        ssize_t moved = ::splice(_file, &offset, _pipe[1], nullptr, std::min<std::uint64_t>(_remaining, kPipeSize),
+                                 SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+        if (moved < 0)
+        {
+            if ((errno == EINVAL || errno == ENOSYS) && !_started)
+                _method = Method::None;
+            else if (errno != EINTR && errno != EAGAIN)
+                ec = lastError();
+
+            return 0;
+        }
+
+        if (moved == 0)
+        {
+            ec = boost::asio::error::eof;
+            return 0;
+        }
+
+        _started = true;
+        _offset += static_cast<std::uint64_t>(moved);
+        _remaining -= static_cast<std::uint64_t>(moved);
+        _inPipe = static_cast<std::size_t>(moved);
+    }
+
+    ssize_t sent = ::splice(_pipe[0], nullptr, socket, nullptr, _inPipe,
+                            SPLICE_F_MOVE | SPLICE_F_NONBLOCK | (_remaining > 0 ? SPLICE_F_MORE : 0));
+
+    if (sent < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            ec = boost::asio::error::would_block;
+        else if (errno != EINTR)
+            ec = lastError();
+
+        return 0;
+    }
+
+    _inPipe -= static_cast<std::size_t>(sent);
+    return static_cast<std::size_t>(sent);
+}
+
+#else
+
+std::size_t FileTransfer::sendFile(boost::asio::ip::tcp::socket::native_handle_type, boost::system::error_code&)
+{
+    _method = Method::None;
+    return 0;
+}
+
+std::size_t FileTransfer::splice(boost::asio::ip::tcp::socket::native_handle_type, boost::system::error_code&)
+{
+    _method = Method::None;
+    return 0;
+}
+
+#endif
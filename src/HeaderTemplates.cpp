@@ -0,0 +1,181 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/HeaderTemplates.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/beast/version.hpp>
+
+#include <rgpaul/StaticFileCache.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the size of "Sun, 06 Nov 1994 08:49:37 GMT"
+constexpr std::size_t kDateSize = 29;
+
+using Key = std::tuple<unsigned, unsigned, std::string>;
+
+// the prefixes of all threads - an entry is never removed, so views of it stay valid (at most kMaxPrefixes of them, a
+// server that sends arbitrary content types doesn't grow the map)
+std::mutex prefixMutex;
+std::map<Key, std::string> prefixes;
+
+// the prefixes a thread has used - looked up without the mutex
+struct ThreadPrefix
+{
+    unsigned status;
+    unsigned version;
+    std::string contentType;
+    std::string_view prefix;
+};
+
+std::size_t append(char* output, std::string_view text)
+{
+    std::memcpy(output, text.data(), text.size());
+    return text.size();
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string_view HeaderTemplates::prefix(boost::beast::http::status status, unsigned version,
+                                         std::string_view contentType)
+{
+    // every version but 1.0 is answered with 1.1
+    version = version == 10 ? 10 : 11;
+
+    thread_local std::vector<ThreadPrefix> threadPrefixes;
+
+    for (const auto& entry : threadPrefixes)
+    {
+        if (entry.status == static_cast<unsigned>(status) && entry.version == version
+            && entry.contentType == contentType)
+            return entry.prefix;
+    }
+
+    std::string_view prefix;
+    {
+        std::lock_guard<std::mutex> lock(prefixMutex);
+
+        Key key(static_cast<unsigned>(status), version, std::string(contentType));
+        auto it = prefixes.find(key);
+        if (it == prefixes.end())
+        {
+            if (prefixes.size() >= kMaxPrefixes)
+                return {};
+
+            it = prefixes.emplace(key, serializePrefix(status, version, contentType)).first;
+        }
+
+        prefix = it->second;
+    }
+
+    threadPrefixes.push_back({static_cast<unsigned>(status), version, std::string(contentType), prefix});
+    return prefix;
+}
+
+std::string HeaderTemplates::serializePrefix(boost::beast::http::status status, unsigned version,
+                                             std::string_view contentType)
+{
+    std::string prefix = version == 10 ? "HTTP/1.0 " : "HTTP/1.1 ";
+    prefix += std::to_string(static_cast<unsigned>(status));
+    prefix += ' ';
+
+    boost::beast::string_view reason = boost::beast::http::obsolete_reason(status);
+    prefix.append(reason.data(), reason.size());
+
+    prefix += "\r\nServer: " BOOST_BEAST_VERSION_STRING "\r\nContent-Type: ";
+    prefix += contentType;
+    prefix += "\r\n";
+
+    return prefix;
+}
+
+std::string_view HeaderTemplates::date()
+{
+    thread_local std::time_t second = -1;
+    thread_local char text[kDateSize];
+
+    // a response is sent within the second, the text is only formatted again after it changed
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (now != second)
+    {
+        std::string formatted = StaticFileCache::formatHttpDate(now);
+        std::memcpy(text, formatted.data(), std::min(formatted.size(), kDateSize));
+        second = now;
+    }
+
+    return std::string_view(text, kDateSize);
+}
+
+std::size_t HeaderTemplates::writeDate(char* output)
+{
+    std::size_t size = append(output, "Date: ");
+    size += append(output + size, date());
+    size += append(output + size, "\r\n");
+    return size;
+}
+
+std::size_t HeaderTemplates::writeFields(char* output, std::uint64_t contentLength, unsigned version, bool keepAlive,
+                                         Compression::Encoding encoding, unsigned vary)
+{
+    std::size_t size = writeDate(output);
+
+    size += append(output + size, "Content-Length: ");
+    size = std::to_chars(output + size, output + size + 20, contentLength).ptr - output;
+    size += append(output + size, "\r\n");
+
+    if (encoding != Compression::Encoding::Identity)
+    {
+        size += append(output + size, "Content-Encoding: ");
+        size += append(output + size, Compression::name(encoding));
+        size += append(output + size, "\r\n");
+    }
+
+    if (vary != 0)
+    {
+        static constexpr std::string_view varyFields[] = {"", "Vary: Accept\r\n", "Vary: Accept-Encoding\r\n",
+                                                          "Vary: Accept, Accept-Encoding\r\n"};
+        size += append(output + size, varyFields[vary & 3]);
+    }
+
+    // the header is only needed if it differs from the default of the version
+    bool http10 = version == 10;
+    if (keepAlive == http10)
+        size += append(output + size, keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
+
+    size += append(output + size, "\r\n");
+    return size;
+}
@@ -0,0 +1,468 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/JsonBody.hpp>
+
+#include <limits>
+
+using namespace rgpaul;
+
+namespace
+{
+constexpr std::uint32_t kInvalid = std::numeric_limits<std::uint32_t>::max();
+
+// the array index of a JSON pointer token - only digits without leading zeros
+std::optional<std::size_t> arrayIndex(std::string_view token)
+{
+    if (token.empty() || (token.size() > 1 && token.front() == '0'))
+        return std::nullopt;
+
+    std::size_t index = 0;
+    for (char c : token)
+    {
+        if (c < '0' || c > '9' || index > (std::numeric_limits<std::size_t>::max() - 9) / 10)
+            return std::nullopt;
+
+        index = index * 10 + static_cast<std::size_t>(c - '0');
+    }
+
+    return index;
+}
+
+// replaces the escapes of a JSON pointer token ("~0" is "~", "~1" is "/") - false if the token has invalid escapes
+bool unescapeToken(std::string_view token, std::string& output)
+{
+    output.clear();
+
+    for (std::size_t i = 0; i < token.size(); ++i)
+    {
+        if (token[i] != '~')
+        {
+            output += token[i];
+            continue;
+        }
+
+        if (i + 1 == token.size() || (token[i + 1] != '0' && token[i + 1] != '1'))
+            return false;
+
+        output += token[++i] == '0' ? '~' : '/';
+    }
+
+    return true;
+}
+}  // namespace
+
+// the SAX handler that appends the values to the nodes of the document
+struct JsonBody::Builder
+{
+    JsonBody& body;
+
+    // the containers that are open
+    std::vector<std::uint32_t> open;
+
+    // the name of the member whose value follows
+    Span name {0, 0};
+
+    Node* add(Type type)
+    {
+        if (!open.empty())
+            ++body._nodes[open.back()].size;
+
+        Node& node = body._nodes.emplace_back();
+        node.type = type;
+        node.boolean = false;
+        node.end = static_cast<std::uint32_t>(body._nodes.size());
+        node.size = 0;
+        node.name = name;
+        node.unsignedInteger = 0;
+
+        name = {0, 0};
+        return &node;
+    }
+
+    Span store(const std::string& text)
+    {
+        Span span {static_cast<std::uint32_t>(body._strings.size()), static_cast<std::uint32_t>(text.size())};
+        body._strings += text;
+        return span;
+    }
+
+    bool startContainer(Type type)
+    {
+        if (open.size() == kMaxDepth)
+        {
+            body._error = "the document is nested deeper than " + std::to_string(kMaxDepth) + " levels";
+            return false;
+        }
+
+        add(type);
+        open.push_back(static_cast<std::uint32_t>(body._nodes.size() - 1));
+        return true;
+    }
+
+    bool endContainer()
+    {
+        body._nodes[open.back()].end = static_cast<std::uint32_t>(body._nodes.size());
+        open.pop_back();
+        return true;
+    }
+
+    // the interface of nlohmann::json_sax
+    bool null()
+    {
+        add(Type::Null);
+        return true;
+    }
+
+    bool boolean(bool value)
+    {
+        add(Type::Boolean)->boolean = value;
+        return true;
+    }
+
+    bool number_integer(nlohmann::json::number_integer_t value)
+    {
+        add(Type::Integer)->integer = value;
+        return true;
+    }
+
+    bool number_unsigned(nlohmann::json::number_unsigned_t value)
+    {
+        add(Type::Unsigned)->unsignedInteger = value;
+        return true;
+    }
+
+    bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t&)
+    {
+        add(Type::Float)->number = value;
+        return true;
+    }
+
+    bool string(nlohmann::json::string_t& value)
+    {
+        Span span = store(value);
+        add(Type::String)->string = span;
+        return true;
+    }
+
+    bool binary(nlohmann::json::binary_t& value)
+    {
+        Span span = store(std::string(value.begin(), value.end()));
+        add(Type::Binary)->string = span;
+        return true;
+    }
+
+    bool start_object(std::size_t) { return startContainer(Type::Object); }
+    bool end_object() { return endContainer(); }
+    bool start_array(std::size_t) { return startContainer(Type::Array); }
+    bool end_array() { return endContainer(); }
+
+    bool key(nlohmann::json::string_t& value)
+    {
+        name = store(value);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& exception)
+    {
+        body._error = exception.what();
+        return false;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+JsonBody::JsonBody(std::string_view data, std::pmr::memory_resource* resource, JsonCodec::Format format)
+    : _nodes(resource), _strings(resource)
+{
+    // there can't be more nodes or string bytes than bytes of data - 32 bit indices are enough below 4 GiB
+    if (data.size() >= kInvalid)
+    {
+        _error = "the document is too large";
+        return;
+    }
+
+    // a rough estimate for compact documents - the arrays rarely have to grow (and leave their old blocks in an arena)
+    _nodes.reserve(data.size() / 16);
+    _strings.reserve(data.size() / 4);
+
+    nlohmann::json::input_format_t input = nlohmann::json::input_format_t::json;
+    if (format == JsonCodec::Format::Cbor)
+        input = nlohmann::json::input_format_t::cbor;
+    else if (format == JsonCodec::Format::MessagePack)
+        input = nlohmann::json::input_format_t::msgpack;
+
+    Builder builder {*this, {}};
+    if (!nlohmann::json::sax_parse(data, &builder, input) && _error.empty())
+        _error = "the document is incomplete";
+
+    if (!_error.empty())
+        _nodes.clear();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool JsonBody::valid() const
+{
+    return !_nodes.empty();
+}
+
+const std::string& JsonBody::error() const
+{
+    return _error;
+}
+
+JsonBody::Value JsonBody::root() const
+{
+    return _nodes.empty() ? Value() : Value(this, 0);
+}
+
+JsonBody::Value JsonBody::at(std::string_view pointer) const
+{
+    return root().at(pointer);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string_view JsonBody::text(Span span) const
+{
+    return std::string_view(_strings.data() + span.offset, span.length);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Value
+// ---------------------------------------------------------------------------------------------------------------------
+
+JsonBody::Value::Value(const JsonBody* body, std::uint32_t index) : _body(body), _index(index) {}
+
+bool JsonBody::Value::exists() const
+{
+    return _body != nullptr;
+}
+
+JsonBody::Value::operator bool() const
+{
+    return exists();
+}
+
+JsonBody::Type JsonBody::Value::type() const
+{
+    return _body ? _body->_nodes[_index].type : Type::Null;
+}
+
+bool JsonBody::Value::isNull() const
+{
+    return type() == Type::Null;
+}
+
+bool JsonBody::Value::isObject() const
+{
+    return type() == Type::Object;
+}
+
+bool JsonBody::Value::isArray() const
+{
+    return type() == Type::Array;
+}
+
+std::optional<bool> JsonBody::Value::boolean() const
+{
+    if (type() != Type::Boolean)
+        return std::nullopt;
+
+    return _body->_nodes[_index].boolean;
+}
+
+std::optional<std::int64_t> JsonBody::Value::integer() const
+{
+    if (!_body)
+        return std::nullopt;
+
+    const Node& node = _body->_nodes[_index];
+    switch (node.type)
+    {
+        case Type::Integer:
+            return node.integer;
+        case Type::Unsigned:
+            if (node.unsignedInteger <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+                return static_cast<std::int64_t>(node.unsignedInteger);
+            return std::nullopt;
+        case Type::Float:
+            // only floats without a fraction that fit
+            if (node.number >= -9223372036854775808.0 && node.number < 9223372036854775808.0
+                && static_cast<double>(static_cast<std::int64_t>(node.number)) == node.number)
+                return static_cast<std::int64_t>(node.number);
+            return std::nullopt;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<double> JsonBody::Value::number() const
+{
+    if (!_body)
+        return std::nullopt;
+
+    const Node& node = _body->_nodes[_index];
+    switch (node.type)
+    {
+        case Type::Integer:
+            return static_cast<double>(node.integer);
+        case Type::Unsigned:
+            return static_cast<double>(node.unsignedInteger);
+        case Type::Float:
+            return node.number;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<std::string_view> JsonBody::Value::string() const
+{
+    if (type() != Type::String)
+        return std::nullopt;
+
+    return _body->text(_body->_nodes[_index].string);
+}
+
+std::size_t JsonBody::Value::size() const
+{
+    return _body ? _body->_nodes[_index].size : 0;
+}
+
+JsonBody::Value JsonBody::Value::member(std::string_view name) const
+{
+    if (!isObject())
+        return {};
+
+    const Node& node = _body->_nodes[_index];
+
+    // the members follow the object - the subtree of a member is skipped at once
+    for (std::uint32_t child = _index + 1; child < node.end; child = _body->_nodes[child].end)
+    {
+        if (_body->text(_body->_nodes[child].name) == name)
+            return Value(_body, child);
+    }
+
+    return {};
+}
+
+JsonBody::Value JsonBody::Value::element(std::size_t index) const
+{
+    if (index >= size())
+        return {};
+
+    std::uint32_t child = _index + 1;
+    for (std::size_t i = 0; i < index; ++i) child = _body->_nodes[child].end;
+
+    return Value(_body, child);
+}
+
+std::string_view JsonBody::Value::name() const
+{
+    return _body ? _body->text(_body->_nodes[_index].name) : std::string_view();
+}
+
+JsonBody::Value JsonBody::Value::at(std::string_view pointer) const
+{
+    if (!pointer.empty() && pointer.front() != '/')
+        return {};
+
+    Value value = *this;
+    std::string buffer;
+
+    while (value && !pointer.empty())
+    {
+        pointer.remove_prefix(1);
+
+        std::size_t end = pointer.find('/');
+        std::string_view token = pointer.substr(0, end);
+        pointer = end == std::string_view::npos ? std::string_view() : pointer.substr(end);
+
+        if (token.find('~') != std::string_view::npos)
+        {
+            if (!unescapeToken(token, buffer))
+                return {};
+
+            token = buffer;
+        }
+
+        if (value.isArray())
+        {
+            std::optional<std::size_t> index = arrayIndex(token);
+            value = index ? value.element(*index) : Value();
+        }
+        else
+            value = value.member(token);
+    }
+
+    return value;
+}
+
+nlohmann::json JsonBody::Value::toJson() const
+{
+    if (!_body)
+        return nullptr;
+
+    const Node& node = _body->_nodes[_index];
+    switch (node.type)
+    {
+        case Type::Null:
+            return nullptr;
+        case Type::Boolean:
+            return node.boolean;
+        case Type::Integer:
+            return node.integer;
+        case Type::Unsigned:
+            return node.unsignedInteger;
+        case Type::Float:
+            return node.number;
+        case Type::String:
+            return std::string(_body->text(node.string));
+        case Type::Binary:
+        {
+            std::string_view bytes = _body->text(node.string);
+            return nlohmann::json::binary(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+        }
+        case Type::Array:
+        {
+            nlohmann::json array = nlohmann::json::array();
+            for (std::uint32_t child = _index + 1; child < node.end; child = _body->_nodes[child].end)
+                array.push_back(Value(_body, child).toJson());
+            return array;
+        }
+        case Type::Object:
+        {
+            nlohmann::json object = nlohmann::json::object();
+            for (std::uint32_t child = _index + 1; child < node.end; child = _body->_nodes[child].end)
+                object.emplace(std::string(_body->text(_body->_nodes[child].name)), Value(_body, child).toJson());
+            return object;
+        }
+    }
+
+    return nullptr;
+}
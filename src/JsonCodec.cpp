@@ -0,0 +1,161 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/JsonCodec.hpp>
+
+#include <algorithm>
+
+#include <rgpaul/HeaderValues.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the subtypes of the media types below "application/" that stand for a format
+struct Subtype
+{
+    std::string_view name;
+    JsonCodec::Format format;
+};
+
+constexpr Subtype kSubtypes[] = {{"json", JsonCodec::Format::Json},
+                                 {"cbor", JsonCodec::Format::Cbor},
+                                 {"msgpack", JsonCodec::Format::MessagePack},
+                                 {"x-msgpack", JsonCodec::Format::MessagePack},
+                                 {"vnd.msgpack", JsonCodec::Format::MessagePack}};
+
+// the format of "type/subtype" - false if it isn't one of ours
+bool mediaFormat(std::string_view mediaType, JsonCodec::Format& format)
+{
+    std::size_t slash = mediaType.find('/');
+    if (slash == std::string_view::npos || !HeaderValues::iequals(mediaType.substr(0, slash), "application"))
+        return false;
+
+    for (const auto& subtype : kSubtypes)
+    {
+        if (HeaderValues::iequals(mediaType.substr(slash + 1), subtype.name))
+        {
+            format = subtype.format;
+            return true;
+        }
+    }
+
+    return false;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string_view JsonCodec::contentType(Format format)
+{
+    switch (format)
+    {
+        case Format::Cbor:
+            return "application/cbor";
+        case Format::MessagePack:
+            return "application/msgpack";
+        default:
+            return "application/json";
+    }
+}
+
+JsonCodec::Format JsonCodec::fromContentType(std::string_view contentType)
+{
+    Format format = Format::Json;
+    mediaFormat(HeaderValues::trim(contentType.substr(0, contentType.find(';'))), format);
+    return format;
+}
+
+int JsonCodec::quality(std::string_view accept, Format format)
+{
+    if (HeaderValues::trim(accept).empty())
+        return 1000;
+
+    // "*/*" < "application/*" < "application/cbor"
+    int bestSpecificity = 0;
+    int bestQuality = 0;
+
+    while (!accept.empty())
+    {
+        std::size_t end = std::min(accept.find(','), accept.size());
+        std::string_view element = accept.substr(0, end);
+        accept.remove_prefix(std::min(end + 1, accept.size()));
+
+        // "application/cbor;q=0.5" - the weight is the first "q" parameter, the media type parameters are ignored
+        std::size_t semicolon = std::min(element.find(';'), element.size());
+        std::string_view range = HeaderValues::trim(element.substr(0, semicolon));
+        int quality = 1000;
+
+        while (semicolon < element.size())
+        {
+            element.remove_prefix(semicolon + 1);
+            semicolon = std::min(element.find(';'), element.size());
+
+            std::string_view parameter = HeaderValues::trim(element.substr(0, semicolon));
+            if (parameter.size() >= 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=')
+            {
+                quality = HeaderValues::parseQuality(HeaderValues::trim(parameter.substr(2)));
+                break;
+            }
+        }
+
+        if (quality < 0)
+            continue;
+
+        int specificity = 0;
+        Format rangeFormat;
+
+        if (range == "*/*")
+            specificity = 1;
+        else if (HeaderValues::iequals(range, "application/*"))
+            specificity = 2;
+        else if (mediaFormat(range, rangeFormat) && rangeFormat == format)
+            specificity = 3;
+
+        if (specificity > bestSpecificity)
+        {
+            bestSpecificity = specificity;
+            bestQuality = quality;
+        }
+    }
+
+    return bestQuality;
+}
+
+JsonCodec::Format JsonCodec::negotiate(std::string_view accept)
+{
+    Format best = Format::Json;
+    int bestQuality = quality(accept, Format::Json);
+
+    for (Format format : {Format::Cbor, Format::MessagePack})
+    {
+        int formatQuality = quality(accept, format);
+        if (formatQuality > bestQuality)
+        {
+            best = format;
+            bestQuality = formatQuality;
+        }
+    }
+
+    return best;
+}
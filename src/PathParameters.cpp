@@ -0,0 +1,68 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/PathParameters.hpp>
+
+using namespace rgpaul;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Accessors
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::size_t PathParameters::size() const
+{
+    return _size;
+}
+
+bool PathParameters::empty() const
+{
+    return _size == 0;
+}
+
+std::string_view PathParameters::operator[](std::size_t index) const
+{
+    if (index >= _size)
+        return {};
+
+    return _values[index];
+}
+
+std::optional<std::string_view> PathParameters::get(std::string_view name) const
+{
+    if (name.empty())
+        return std::nullopt;
+
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+        if (this->name(i) == name)
+            return _values[i];
+    }
+
+    return std::nullopt;
+}
+
+std::string_view PathParameters::name(std::size_t index) const
+{
+    if (index >= _size)
+        return {};
+
+    return std::string_view(_nameData.data() + _nameOffsets[index], _nameOffsets[index + 1] - _nameOffsets[index]);
+}
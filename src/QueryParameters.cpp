@@ -0,0 +1,250 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/QueryParameters.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    return -1;
+}
+
+// decodes the character at pos and advances pos behind it
+char decodeAt(std::string_view input, std::size_t& pos)
+{
+    char c = input[pos];
+
+    if (c == '+')
+    {
+        ++pos;
+        return ' ';
+    }
+
+    // sequences which start with a percent sign but are not followed by two hexadecimal characters are kept
+    if (c == '%' && pos + 2 < input.size())
+    {
+        int high = hexValue(input[pos + 1]);
+        int low = hexValue(input[pos + 2]);
+
+        if (high >= 0 && low >= 0)
+        {
+            pos += 3;
+            return static_cast<char>((high << 4) + low);
+        }
+    }
+
+    ++pos;
+    return c;
+}
+
+bool containsEscapes(std::string_view input)
+{
+    return input.find_first_of("%+") != std::string_view::npos;
+}
+
+// compares an encoded key with a decoded one without decoding it into a buffer
+bool equalsDecoded(std::string_view encoded, std::string_view decoded)
+{
+    std::size_t pos = 0;
+    std::size_t index = 0;
+
+    while (pos < encoded.size())
+    {
+        if (index == decoded.size() || decodeAt(encoded, pos) != decoded[index])
+            return false;
+
+        ++index;
+    }
+
+    return index == decoded.size();
+}
+
+bool keyMatches(const QueryParameters::Parameter& parameter, std::string_view key)
+{
+    if (parameter.keyEncoded)
+        return equalsDecoded(parameter.key, key);
+
+    return parameter.key == key;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Parameter
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::string_view QueryParameters::Parameter::decodedValue(std::string& buffer) const
+{
+    if (!valueEncoded)
+        return value;
+
+    decode(value, buffer);
+    return buffer;
+}
+
+std::string_view QueryParameters::Parameter::decodedKey(std::string& buffer) const
+{
+    if (!keyEncoded)
+        return key;
+
+    decode(key, buffer);
+    return buffer;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+QueryParameters::QueryParameters(std::string_view target)
+{
+    // a target without "?" has no query
+    std::size_t pos = target.find('?');
+    if (pos != std::string_view::npos)
+        target.remove_prefix(pos + 1);
+    else if (!target.empty() && target.front() == '/')
+        return;
+
+    pos = target.find('#');
+    if (pos != std::string_view::npos)
+        target = target.substr(0, pos);
+
+    while (!target.empty())
+    {
+        std::size_t end = target.find('&');
+        std::string_view token = target.substr(0, end);
+        target.remove_prefix(end == std::string_view::npos ? target.size() : end + 1);
+
+        if (token.empty())
+            continue;
+
+        Parameter parameter;
+        std::size_t separator = token.find('=');
+        parameter.key = token.substr(0, separator);
+        if (separator != std::string_view::npos)
+            parameter.value = token.substr(separator + 1);
+
+        parameter.keyEncoded = containsEscapes(parameter.key);
+        parameter.valueEncoded = containsEscapes(parameter.value);
+
+        if (_size < kInlineCapacity)
+            _inline[_size] = parameter;
+        else
+            _overflow.push_back(parameter);
+
+        ++_size;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::size_t QueryParameters::size() const
+{
+    return _size;
+}
+
+bool QueryParameters::empty() const
+{
+    return _size == 0;
+}
+
+const QueryParameters::Parameter& QueryParameters::operator[](std::size_t index) const
+{
+    if (index < kInlineCapacity)
+        return _inline[index];
+
+    return _overflow[index - kInlineCapacity];
+}
+
+bool QueryParameters::contains(std::string_view key) const
+{
+    return find(key, 0) != nullptr;
+}
+
+std::size_t QueryParameters::count(std::string_view key) const
+{
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+        if (keyMatches((*this)[i], key))
+            ++result;
+    }
+
+    return result;
+}
+
+std::optional<std::string_view> QueryParameters::get(std::string_view key, std::size_t occurrence) const
+{
+    const Parameter* parameter = find(key, occurrence);
+
+    if (!parameter)
+        return std::nullopt;
+
+    return parameter->value;
+}
+
+std::optional<std::string_view> QueryParameters::value(std::string_view key, std::string& buffer,
+                                                        std::size_t occurrence) const
+{
+    const Parameter* parameter = find(key, occurrence);
+
+    if (!parameter)
+        return std::nullopt;
+
+    return parameter->decodedValue(buffer);
+}
+
+void QueryParameters::decode(std::string_view input, std::string& output)
+{
+    output.clear();
+    output.reserve(input.size());
+
+    std::size_t pos = 0;
+    while (pos < input.size()) output.push_back(decodeAt(input, pos));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+const QueryParameters::Parameter* QueryParameters::find(std::string_view key, std::size_t occurrence) const
+{
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+        const Parameter& parameter = (*this)[i];
+
+        if (keyMatches(parameter, key) && occurrence-- == 0)
+            return &parameter;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,73 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/Request.hpp>
+
+using namespace rgpaul;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+Request::Request(Message&& message) : Message(std::move(message)) {}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Accessors
+// ---------------------------------------------------------------------------------------------------------------------
+
+const PathParameters& Request::pathParameters() const
+{
+    return _pathParameters;
+}
+
+const QueryParameters& Request::queryParameters() const
+{
+    if (!_queryParameters)
+    {
+        boost::beast::string_view target = this->target();
+        _queryParameters.emplace(std::string_view(target.data(), target.size()));
+    }
+
+    return *_queryParameters;
+}
+
+const JsonBody& Request::json() const
+{
+    // the values are allocated from the same memory as the body - the arena of the session
+    if (!_json)
+    {
+        boost::beast::string_view contentType = (*this)[boost::beast::http::field::content_type];
+        _json.emplace(std::string_view(body().data(), body().size()), body().get_allocator().resource(),
+                      JsonCodec::fromContentType(std::string_view(contentType.data(), contentType.size())));
+    }
+
+    return *_json;
+}
+
+bool Request::compressResponse() const
+{
+    return _compressResponse;
+}
+
+std::uint32_t Request::route() const
+{
+    return _route;
+}
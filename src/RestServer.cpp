@@ -21,6 +21,7 @@
 
 #include <rgpaul/RestServer.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 #include <boost/algorithm/string.hpp>
@@ -28,10 +29,27 @@
 #include <boost/log/trivial.hpp>
 
 #include <rgpaul/Session.hpp>
-#include <rgpaul/UriNode.hpp>
+#include <rgpaul/UrlCodec.hpp>
+
+#if defined(__linux__)
+#include <csignal>
+#include <pthread.h>
+#endif
 
 using namespace rgpaul;
 
+#if defined(SO_REUSEPORT)
+namespace
+{
+// lets every thread bind an acceptor to the same port - the kernel distributes the connections
+using ReusePort = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+
+#if defined(SO_INCOMING_CPU)
+using IncomingCpu = boost::asio::detail::socket_option::integer<SOL_SOCKET, SO_INCOMING_CPU>;
+#endif
+}  // namespace
+#endif
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Constructors / Destructor
 // ---------------------------------------------------------------------------------------------------------------------
@@ -72,33 +90,46 @@ RestServer::RestServer(const std::string& host, unsigned short port)
         BOOST_LOG_TRIVIAL(error) << "listen: " << ec.message();
         return;
     }
-
-    // init root node for uri
-    _registeredEndpoints = UriNode::createRootNode();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 // Public
 // ---------------------------------------------------------------------------------------------------------------------
 
-void RestServer::registerEndpoint(const std::string& target, RestServerCallback callback)
+void RestServer::registerEndpoint(const std::string& target, RestServerCallback callback, EndpointOptions options)
 {
-    // check if it is the root element - we can assign the callback directly
-    if (target == "/")
+    addEndpoint({target, std::move(callback), options});
+}
+
+void RestServer::registerStreamingEndpoint(const std::string& target, StreamCallbacks callbacks,
+                                           EndpointOptions options)
+{
+    if (!callbacks.body)
     {
-        _registeredEndpoints->setCallback(std::move(callback));
+        BOOST_LOG_TRIVIAL(error) << "register streaming endpoint: target '" << target << "' needs a body callback.";
         return;
     }
 
-    // split the uri path
-    std::vector<std::string> uriPaths = splitUri(target);
+    addEndpoint({target, nullptr, options, std::move(callbacks)});
+}
 
-    // create a node for the path
-    std::shared_ptr<UriNode> node = _registeredEndpoints->createNodeForPath(uriPaths);
+bool RestServer::unregisterEndpoint(const std::string& target)
+{
+    std::lock_guard<std::mutex> lock(_endpointsMutex);
+
+    std::string_view path = Router::normalizePath(target);
+    auto existing = std::find_if(_endpoints.begin(), _endpoints.end(),
+                                 [path](const Endpoint& endpoint) { return endpoint.target == path; });
+
+    if (existing == _endpoints.end())
+        return false;
+
+    _endpoints.erase(existing);
 
-    // if the node could be created, we assign the callback to it
-    if (node)
-        node->setCallback(std::move(callback));
+    if (_listening)
+        publishRouteTable();
+
+    return true;
 }
 
 void RestServer::startListening(unsigned short threads)
@@ -109,14 +140,244 @@ void RestServer::startListening(unsigned short threads)
         return;
     }
 
-    // accept incoming connections
-    doAccept();
+    if (_executionModel == ExecutionModel::ContextPerThread && !openListeners(threads))
+        return;
+
+    // publish the registered endpoints
+    {
+        std::lock_guard<std::mutex> lock(_endpointsMutex);
+        publishRouteTable();
+        _listening = true;
+    }
 
     // reserve space for the number of threads
     _threads.reserve(threads);
 
+    if (_executionModel == ExecutionModel::ContextPerThread)
+    {
+        // every thread accepts and runs its own connections
+        for (std::size_t i = 0; i < _listeners.size(); ++i)
+        {
+            doAccept(*_listeners[i]);
+            _threads.emplace_back([this, i] { runThread(i, _listeners[i]->ioc); });
+        }
+
+        return;
+    }
+
+    // accept incoming connections
+    doAccept();
+
     // start the amount of given threads and run ioc for each of them
-    for (auto i = 0; i < threads; ++i) _threads.emplace_back([this] { _ioc.run(); });
+    for (auto i = 0; i < threads; ++i) _threads.emplace_back([this, i] { runThread(i, _ioc); });
+}
+
+void RestServer::stop()
+{
+    _ioc.stop();
+    for (auto& listener : _listeners) listener->ioc.stop();
+
+    for (auto& thread : _threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    _threads.clear();
+
+    // the pending accept operations hold a reference to the server - close the acceptors and let them finish
+    boost::system::error_code ec;
+    _acceptor.close(ec);
+    _ioc.restart();
+    _ioc.poll();
+
+    for (auto& listener : _listeners)
+    {
+        listener->acceptor.close(ec);
+        listener->ioc.restart();
+        listener->ioc.poll();
+    }
+}
+
+void RestServer::setExecutionModel(ExecutionModel model)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set execution model: the server is already listening.";
+        return;
+    }
+
+    _executionModel = model;
+}
+
+RestServer::ExecutionModel RestServer::executionModel() const
+{
+    return _executionModel;
+}
+
+void RestServer::setThreadPlacement(ThreadPlacement placement)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set thread placement: the server is already listening.";
+        return;
+    }
+
+    _threadPlacement = std::move(placement);
+}
+
+const ThreadPlacement& RestServer::threadPlacement() const
+{
+    return _threadPlacement;
+}
+
+unsigned short RestServer::port() const
+{
+    boost::system::error_code ec;
+
+    if (!_listeners.empty())
+        return _listeners.front()->acceptor.local_endpoint(ec).port();
+
+    return _acceptor.local_endpoint(ec).port();
+}
+
+void RestServer::setMaxPipelineDepth(std::size_t depth)
+{
+    _maxPipelineDepth = std::max<std::size_t>(depth, 1);
+}
+
+std::size_t RestServer::maxPipelineDepth() const
+{
+    return _maxPipelineDepth;
+}
+
+void RestServer::setStaticFileCache(std::shared_ptr<StaticFileCache> cache)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set static file cache: the server is already listening.";
+        return;
+    }
+
+    _staticFileCache = std::move(cache);
+}
+
+std::shared_ptr<StaticFileCache> RestServer::staticFileCache() const
+{
+    return _staticFileCache;
+}
+
+void RestServer::setAccessLog(std::shared_ptr<AccessLog> log)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set access log: the server is already listening.";
+        return;
+    }
+
+    _accessLog = std::move(log);
+}
+
+std::shared_ptr<AccessLog> RestServer::accessLog() const
+{
+    return _accessLog;
+}
+
+void RestServer::setCompression(Compression::Settings settings)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set compression: the server is already listening.";
+        return;
+    }
+
+    _compression = settings;
+}
+
+const Compression::Settings& RestServer::compression() const
+{
+    return _compression;
+}
+
+void RestServer::setBinaryJson(bool enabled)
+{
+    _binaryJson = enabled;
+}
+
+bool RestServer::binaryJson() const
+{
+    return _binaryJson;
+}
+
+void RestServer::setZeroCopyFiles(bool enabled)
+{
+    _zeroCopyFiles = enabled;
+}
+
+bool RestServer::zeroCopyFiles() const
+{
+    return _zeroCopyFiles;
+}
+
+void RestServer::setTimeouts(Session::Timeouts timeouts)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set timeouts: the server is already listening.";
+        return;
+    }
+
+    _timeouts = timeouts;
+}
+
+const Session::Timeouts& RestServer::timeouts() const
+{
+    return _timeouts;
+}
+
+void RestServer::setConnectionLimits(ConnectionLimiter::Limits limits)
+{
+    if (_listening)
+    {
+        BOOST_LOG_TRIVIAL(error) << "set connection limits: the server is already listening.";
+        return;
+    }
+
+    _connectionLimiter = std::make_shared<ConnectionLimiter>(limits);
+}
+
+const ConnectionLimiter::Limits& RestServer::connectionLimits() const
+{
+    return _connectionLimiter->limits();
+}
+
+ConnectionLimiter::Metrics RestServer::connectionMetrics() const
+{
+    return _connectionLimiter->metrics();
+}
+
+void RestServer::setBodyLimit(std::uint64_t limit)
+{
+    _bodyLimit = limit;
+}
+
+std::uint64_t RestServer::bodyLimit() const
+{
+    return _bodyLimit;
+}
+
+void RestServer::setWorkerThreads(std::size_t threads, std::size_t queueCapacity)
+{
+    _workerThreads = threads;
+    _workerQueueCapacity = queueCapacity;
+}
+
+WorkStealingPool::Metrics RestServer::workerMetrics() const
+{
+    if (!_workersRunning.load(std::memory_order_acquire))
+        return {};
+
+    return _workers->metrics();
 }
 
 std::vector<std::string> RestServer::splitUri(std::string uri)
@@ -145,146 +406,221 @@ std::vector<std::string> RestServer::splitUri(std::string uri)
 
 std::string RestServer::urlEncode(const std::string& url)
 {
-    // only alphanum are safe characters
-    const char kSafe[256] = {/*      0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F */
-                             /* 0 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* 1 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* 2 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* 3 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
-
-                             /* 4 */ 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                             /* 5 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
-                             /* 6 */ 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                             /* 7 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
-
-                             /* 8 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* 9 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* A */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* B */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-
-                             /* C */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* D */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* E */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                             /* F */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-
-    const char kDec2hex[16 + 1] = "0123456789ABCDEF";
-    const unsigned char* source = reinterpret_cast<const unsigned char*>(url.c_str());
-    const int kSourceLength = url.length();
-    // we allocate a new char* that has space for tripple the amount of characters
-    unsigned char* const pStart = new unsigned char[kSourceLength * 3];
-    unsigned char* pEnd = pStart;
-    const unsigned char* const kSourceEnd = source + kSourceLength;
-
-    for (; source < kSourceEnd; ++source)
-    {
-        // check if this character is a safe one (that don't needs to be escaped)
-        if (kSafe[*source])
-            *pEnd++ = *source;
-        else
-        {
-            *pEnd++ = '%';
-            *pEnd++ = kDec2hex[*source >> 4];
-            *pEnd++ = kDec2hex[*source & 0x0F];
-        }
-    }
-
-    std::string result(reinterpret_cast<char*>(pStart), reinterpret_cast<char*>(pEnd));
-    delete[] pStart;
+    std::string result;
+    urlEncode(url, result);
     return result;
 }
 
 std::string RestServer::urlDecode(const std::string& url)
 {
-    // Note from RFC1630: "Sequences which start with a percent
-    // sign but are not followed by two hexadecimal characters
-    // (0-9, A-F) are reserved for future extension"
+    std::string result;
+    urlDecode(url, result);
+    return result;
+}
 
-    const char kHex2Dec[256] = {/*       0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F */
-                                /* 0 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 1 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 2 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 3 */ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  -1, -1, -1, -1, -1, -1,
+void RestServer::urlEncode(std::string_view url, std::string& output)
+{
+    // every character can become 3 characters
+    output.resize(url.size() * 3);
+    output.resize(UrlCodec::encode(url.data(), url.size(), output.data()));
+}
 
-                                /* 4 */ -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 5 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 6 */ -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 7 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+std::size_t RestServer::urlEncode(std::string_view url, char* output)
+{
+    return UrlCodec::encode(url.data(), url.size(), output);
+}
 
-                                /* 8 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* 9 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* A */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* B */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+void RestServer::urlDecode(std::string_view url, std::string& output)
+{
+    output.resize(url.size());
+    output.resize(UrlCodec::decode(url.data(), url.size(), output.data()));
+}
 
-                                /* C */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* D */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* E */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                /* F */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+std::size_t RestServer::urlDecode(std::string_view url, char* output)
+{
+    return UrlCodec::decode(url.data(), url.size(), output);
+}
 
-    const unsigned char* source = reinterpret_cast<const unsigned char*>(url.c_str());
-    const int kSourceLength = url.length();
-    const unsigned char* const kSourceEnd = source + kSourceLength;
+void RestServer::urlDecodeInPlace(std::string& url)
+{
+    url.resize(UrlCodec::decode(url.data(), url.size(), url.data()));
+}
 
-    // last decodable '%' if there is one
-    const unsigned char* const kSourceLastDec = kSourceEnd - 2;
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
 
-    // we allocate a new char* for the decoded characters
-    char* const pStart = new char[kSourceLength];
-    char* pEnd = pStart;
+bool RestServer::openListeners(std::size_t count)
+{
+#if defined(SO_REUSEPORT)
+    // all acceptors have to set SO_REUSEPORT before they are bound - so the acceptor of the constructor is replaced
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::endpoint endpoint = _acceptor.local_endpoint(ec);
+    _acceptor.close(ec);
 
-    while (source < kSourceLastDec)
+    for (std::size_t i = 0; i < count; ++i)
     {
-        if (*source == '%')
+        auto listener = std::make_unique<Listener>();
+        boost::asio::ip::tcp::acceptor& acceptor = listener->acceptor;
+
+        acceptor.open(endpoint.protocol(), ec);
+        if (!ec)
+            acceptor.set_option(boost::asio::socket_base::reuse_address(true), ec);
+        if (!ec)
+            acceptor.set_option(ReusePort(true), ec);
+#if defined(SO_INCOMING_CPU)
+        // connections whose packets arrive on the cpu of the thread prefer its acceptor
+        if (!ec && _threadPlacement.cpuForThread(i) >= 0)
+            acceptor.set_option(IncomingCpu(_threadPlacement.cpuForThread(i)), ec);
+#endif
+        if (!ec)
+            acceptor.bind(endpoint, ec);
+        if (!ec)
+            acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+
+        if (ec)
         {
-            char dec1, dec2;
-            if (-1 != (dec1 = kHex2Dec[*(source + 1)]) && -1 != (dec2 = kHex2Dec[*(source + 2)]))
-            {
-                *pEnd++ = (dec1 << 4) + dec2;
-                source += 3;
-                continue;
-            }
+            BOOST_LOG_TRIVIAL(error) << "open listener " << i << ": " << ec.message();
+            _listeners.clear();
+            return false;
         }
 
-        *pEnd++ = *source++;
+        _listeners.push_back(std::move(listener));
     }
 
-    // the last 2 characters
-    while (source < kSourceEnd) *pEnd++ = *source++;
-
-    std::string result(pStart, pEnd);
-    delete[] pStart;
-    return result;
+    return true;
+#else
+    BOOST_LOG_TRIVIAL(error) << "open listeners: SO_REUSEPORT is not supported - using a shared context.";
+    _executionModel = ExecutionModel::SharedContext;
+    return true;
+#endif
 }
 
-// ---------------------------------------------------------------------------------------------------------------------
-// Private
-// ---------------------------------------------------------------------------------------------------------------------
-
 void RestServer::doAccept()
 {
+    if (!reserveConnection(_ioc, _acceptor, [this] { doAccept(); }))
+        return;
+
     // the new connection gets its own strand
     _acceptor.async_accept(boost::asio::make_strand(_ioc),
-                           boost::beast::bind_front_handler(&RestServer::onAccept, shared_from_this()));
+                           [self = shared_from_this()](boost::beast::error_code ec,
+                                                       boost::asio::ip::tcp::socket socket) {
+                               self->onAccept(ec, std::move(socket));
+                           });
 }
 
 void RestServer::onAccept(boost::beast::error_code ec, boost::asio::ip::tcp::socket socket)
 {
+    // the acceptor was closed
+    if (ec == boost::asio::error::operation_aborted)
+    {
+        _connectionLimiter->cancel();
+        return;
+    }
+
     if (ec)
     {
         BOOST_LOG_TRIVIAL(error) << "accept: " << ec.message();
+        _connectionLimiter->cancel();
     }
     else
     {
         // create the session and run it
-        BOOST_LOG_TRIVIAL(info) << "server accepted incoming connection.";
-        std::make_shared<Session>(std::move(socket), shared_from_this())->run();
+        BOOST_LOG_TRIVIAL(debug) << "server accepted incoming connection.";
+        startSession(std::move(socket));
     }
 
     // accept another connection
     doAccept();
 }
 
-void RestServer::handleRequest(const boost::beast::http::request<boost::beast::http::string_body>& request,
-                               std::shared_ptr<Session> session)
+void RestServer::doAccept(Listener& listener)
+{
+    if (!reserveConnection(listener.ioc, listener.acceptor, [this, &listener] { doAccept(listener); }))
+        return;
+
+    // the connection runs on the context of the listener - its only thread serializes the handlers
+    listener.acceptor.async_accept(
+        listener.ioc,
+        [self = shared_from_this(), &listener](boost::beast::error_code ec, boost::asio::ip::tcp::socket socket) {
+            self->onAccept(listener, ec, std::move(socket));
+        });
+}
+
+void RestServer::onAccept(Listener& listener, boost::beast::error_code ec, boost::asio::ip::tcp::socket socket)
+{
+    if (ec == boost::asio::error::operation_aborted)
+    {
+        _connectionLimiter->cancel();
+        return;
+    }
+
+    if (ec)
+    {
+        BOOST_LOG_TRIVIAL(error) << "accept: " << ec.message();
+        _connectionLimiter->cancel();
+    }
+    else
+    {
+        BOOST_LOG_TRIVIAL(debug) << "server accepted incoming connection.";
+        startSession(std::move(socket));
+    }
+
+    doAccept(listener);
+}
+
+bool RestServer::reserveConnection(boost::asio::io_context& context, boost::asio::ip::tcp::acceptor& acceptor,
+                                   std::function<void()> accept)
+{
+    // at the limit we simply don't accept - the connections wait in the backlog of the kernel instead of holding the
+    // memory of a session
+    return _connectionLimiter->reserve([self = weak_from_this(), &context, &acceptor, accept = std::move(accept)] {
+        std::shared_ptr<RestServer> server = self.lock();
+        if (!server)
+            return;
+
+        // called by the thread that closed a session - the acceptor is only used by the threads of its context
+        // (the server isn't kept alive by the handler, it owns the context)
+        boost::asio::post(context, [&acceptor, accept] {
+            if (acceptor.is_open())
+                accept();
+        });
+    });
+}
+
+void RestServer::startSession(boost::asio::ip::tcp::socket socket)
+{
+    boost::system::error_code ec;
+    ConnectionLimiter::Ticket ticket = _connectionLimiter->admit(socket.remote_endpoint(ec).address());
+
+    if (!ticket)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "rejected connection: too many connections from the address.";
+        socket.close(ec);
+        return;
+    }
+
+    // responses are written in one piece - waiting for more data (Nagle) only delays the next pipelined response
+    socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+
+    std::make_shared<Session>(std::move(socket), shared_from_this(), std::move(ticket))->run();
+}
+
+void RestServer::runThread(std::size_t index, boost::asio::io_context& context)
+{
+#if defined(__linux__)
+    // sendfile and splice raise SIGPIPE if the client closed the connection - blocked, the transfer fails with EPIPE
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+
+    _threadPlacement.apply(index, "rgp-io-" + std::to_string(index));
+    context.run();
+}
+
+void RestServer::handleRequest(Request& request, std::shared_ptr<Session> session)
 {
     if (!session)
     {
@@ -292,7 +628,7 @@ void RestServer::handleRequest(const boost::beast::http::request<boost::beast::h
         return;
     }
 
-    std::string target = std::string(request.target());
+    boost::beast::string_view target = request.target();
 
     // request path must be absolute and not contain "..".
     if (target.empty() || target[0] != '/' || target.find("..") != boost::beast::string_view::npos)
@@ -301,20 +637,141 @@ void RestServer::handleRequest(const boost::beast::http::request<boost::beast::h
         return;
     }
 
-    // split the target
-    std::vector<std::string> uriPaths = splitUri(target);
+    // the route table (and with it the endpoint) stays alive until the guard is gone, even if it gets replaced
+    EpochReclaimer::ReadGuard guard;
+    const RouteTable* routeTable = _routeTable.load(guard);
 
-    // find the node for the given target
-    std::shared_ptr<UriNode> node = _registeredEndpoints->findNodeForPath(uriPaths);
+    // find the endpoint for the given target
+    const Endpoint* endpoint =
+        routeTable->findEndpoint(std::string_view(target.data(), target.size()), request._pathParameters);
 
-    // if there is no node or no callback for the node, we send a not found
-    if (!node || !node->callback())
+    // if there is no endpoint, we send a not found
+    if (!endpoint)
     {
         session->sendNotFound(target);
         return;
     }
 
-    // call the callback for the found node
-    const auto& callback = node->callback();
-    callback(session, request);
+    request._compressResponse = endpoint->options.compress;
+    request._route = static_cast<std::uint32_t>(endpoint - routeTable->endpoints().data());
+
+    // a streaming endpoint that was registered after the body was read - it gets the whole body at once
+    if (!endpoint->callback)
+    {
+        if (!endpoint->stream.header || endpoint->stream.header(session, request))
+            endpoint->stream.body(session, request, std::string_view(request.body().data(), request.body().size()),
+                                  true);
+        return;
+    }
+
+    if (endpoint->options.offload)
+    {
+        offload(*endpoint, request, std::move(session));
+        return;
+    }
+
+    // call the callback for the found endpoint
+    endpoint->callback(session, request);
+}
+
+RestServer::BodyPolicy RestServer::bodyPolicy(boost::beast::string_view target) const
+{
+    BodyPolicy policy {_bodyLimit, std::nullopt};
+
+    EpochReclaimer::ReadGuard guard;
+    const RouteTable* routeTable = _routeTable.load(guard);
+
+    // the usual case - no endpoint has to be looked up
+    if (!routeTable->hasBodyOptions())
+        return policy;
+
+    PathParameters parameters;
+    const Endpoint* endpoint = routeTable->findEndpoint(std::string_view(target.data(), target.size()), parameters);
+
+    if (!endpoint)
+        return policy;
+
+    if (endpoint->options.bodyLimit > 0)
+        policy.limit = endpoint->options.bodyLimit;
+
+    policy.timeout = endpoint->options.bodyTimeout;
+
+    if (!endpoint->callback)
+    {
+        policy.stream = endpoint->stream;
+        policy.route = static_cast<std::uint32_t>(endpoint - routeTable->endpoints().data());
+    }
+
+    return policy;
+}
+
+bool RestServer::submitToWorkers(WorkStealingPool::Task task)
+{
+    return workers().submit(std::move(task));
+}
+
+WorkStealingPool& RestServer::workers()
+{
+    std::call_once(_workersStarted, [this] {
+        _workers = std::make_unique<WorkStealingPool>(_workerThreads, _workerQueueCapacity);
+        _workersRunning.store(true, std::memory_order_release);
+    });
+
+    return *_workers;
+}
+
+void RestServer::offload(const Endpoint& endpoint, Request& request, std::shared_ptr<Session> session)
+{
+    // the request stays in the session until it was answered - but the route table may be replaced in the meantime, so
+    // the task gets a copy of the callback (the path parameters of the request carry copies of their names)
+    // after the callback answered the request may be gone already - an exception only uses a copy of the target and
+    // the sequence of the request, the session ignores the error if the request was answered
+    bool queued = workers().submit([callback = endpoint.callback, session, &request,
+                                    target = std::string(request.target()), sequence = session->_answeredSequence] {
+        try
+        {
+            callback(session, request);
+        }
+        catch (const std::exception& e)
+        {
+            BOOST_LOG_TRIVIAL(error) << "offloaded callback for " << target << ": " << e.what();
+            session->sendServerError(sequence, e.what());
+        }
+    });
+
+    if (!queued)
+        session->sendServiceUnavailable("All workers are busy.");
+}
+
+void RestServer::addEndpoint(Endpoint endpoint)
+{
+    if (!Router::isValidPattern(endpoint.target))
+    {
+        BOOST_LOG_TRIVIAL(error) << "register endpoint: target '" << endpoint.target
+                                 << "' must start with '/' and can't have more than " << PathParameters::kCapacity
+                                 << " placeholders with up to " << PathParameters::kNameCapacity
+                                 << " characters in their names.";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_endpointsMutex);
+
+    // registering the same target again replaces the callback
+    endpoint.target = std::string(Router::normalizePath(endpoint.target));
+    auto existing = std::find_if(_endpoints.begin(), _endpoints.end(),
+                                 [&endpoint](const Endpoint& other) { return other.target == endpoint.target; });
+
+    if (existing != _endpoints.end())
+        *existing = std::move(endpoint);
+    else
+        _endpoints.push_back(std::move(endpoint));
+
+    // before we are listening all endpoints are published at once
+    if (_listening)
+        publishRouteTable();
+}
+
+void RestServer::publishRouteTable()
+{
+    _routeTable.store(std::make_unique<const RouteTable>(_endpoints));
 }
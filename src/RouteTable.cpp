@@ -0,0 +1,69 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/RouteTable.hpp>
+
+#include <string>
+
+using namespace rgpaul;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+RouteTable::RouteTable(std::vector<Endpoint> endpoints) : _endpoints(std::move(endpoints))
+{
+    std::vector<std::string> patterns;
+    patterns.reserve(_endpoints.size());
+
+    for (const auto& endpoint : _endpoints)
+    {
+        patterns.push_back(endpoint.target);
+        _hasBodyOptions = _hasBodyOptions || endpoint.stream.body || endpoint.options.bodyLimit > 0
+                          || endpoint.options.bodyTimeout.count() > 0;
+    }
+
+    _router = Router(patterns);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+const Endpoint* RouteTable::findEndpoint(std::string_view target, PathParameters& parameters) const
+{
+    std::size_t route = _router.findRoute(target, parameters);
+
+    if (route == Router::npos || (!_endpoints[route].callback && !_endpoints[route].stream.body))
+        return nullptr;
+
+    return &_endpoints[route];
+}
+
+const std::vector<Endpoint>& RouteTable::endpoints() const
+{
+    return _endpoints;
+}
+
+bool RouteTable::hasBodyOptions() const
+{
+    return _hasBodyOptions;
+}
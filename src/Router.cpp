@@ -0,0 +1,356 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/Router.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+using namespace rgpaul;
+
+namespace
+{
+// node of the mutable trie that is only used while building the router
+struct BuildNode
+{
+    std::string label;
+    std::map<char, std::unique_ptr<BuildNode>> children;
+    std::unique_ptr<BuildNode> wildcard;
+    std::uint32_t route {UINT32_MAX};
+};
+
+// extends the trie so that it contains the literal below the given node and returns the node where the literal ends
+BuildNode* insertLiteral(BuildNode* node, std::string_view literal)
+{
+    while (!literal.empty())
+    {
+        auto it = node->children.find(literal.front());
+
+        // no child starts with the same byte => the rest of the literal becomes a new leaf
+        if (it == node->children.end())
+        {
+            auto child = std::make_unique<BuildNode>();
+            child->label = std::string(literal);
+            BuildNode* leaf = child.get();
+            node->children.emplace(literal.front(), std::move(child));
+            return leaf;
+        }
+
+        BuildNode* child = it->second.get();
+
+        std::size_t common = 0;
+        while (common < child->label.size() && common < literal.size() && child->label[common] == literal[common])
+            ++common;
+
+        // the literal diverges inside the label of the child => split the child at that position
+        if (common < child->label.size())
+        {
+            auto split = std::make_unique<BuildNode>();
+            split->label = child->label.substr(0, common);
+            child->label.erase(0, common);
+            split->children.emplace(child->label.front(), std::move(it->second));
+            it->second = std::move(split);
+            child = it->second.get();
+        }
+
+        node = child;
+        literal.remove_prefix(common);
+    }
+
+    return node;
+}
+
+// returns true if the segment is a placeholder ("$" or "{name}") and stores the name of the placeholder
+bool isPlaceholder(std::string_view segment, std::string_view& name)
+{
+    if (segment == "$")
+    {
+        name = {};
+        return true;
+    }
+
+    if (segment.size() >= 2 && segment.front() == '{' && segment.back() == '}')
+    {
+        name = segment.substr(1, segment.size() - 2);
+        return true;
+    }
+
+    return false;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+Router::Router(const std::vector<std::string>& patterns)
+{
+    BuildNode root;
+    _parameterOffsets.reserve(patterns.size() + 1);
+
+    for (std::size_t index = 0; index < patterns.size(); ++index)
+    {
+        _parameterOffsets.push_back(static_cast<std::uint32_t>(_parameterNames.size()));
+
+        if (!isValidPattern(patterns[index]))
+            continue;
+
+        std::string_view pattern = normalizePath(patterns[index]);
+
+        // split the pattern into literals and placeholders - the literals keep their separating "/"
+        BuildNode* node = &root;
+        std::string literal;
+        std::size_t pos = 0;
+
+        while (pos < pattern.size())
+        {
+            literal += '/';
+            ++pos;
+
+            std::size_t end = pattern.find('/', pos);
+            if (end == std::string_view::npos)
+                end = pattern.size();
+
+            std::string_view segment = pattern.substr(pos, end - pos);
+            std::string_view name;
+            if (isPlaceholder(segment, name))
+            {
+                _parameterNames.emplace_back(name);
+
+                node = insertLiteral(node, literal);
+                literal.clear();
+
+                if (!node->wildcard)
+                    node->wildcard = std::make_unique<BuildNode>();
+
+                node = node->wildcard.get();
+            }
+            else
+                literal += segment;
+
+            pos = end;
+        }
+
+        node = insertLiteral(node, literal);
+        node->route = static_cast<std::uint32_t>(index);
+    }
+
+    _parameterOffsets.push_back(static_cast<std::uint32_t>(_parameterNames.size()));
+
+    // flatten the trie in breadth first order, so that the static children of every node are stored next to each other
+    std::vector<const BuildNode*> order {&root};
+    _nodes.emplace_back();
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const BuildNode* buildNode = order[i];
+
+        _nodes[i].labelOffset = static_cast<std::uint32_t>(_labels.size());
+        _nodes[i].labelLength = static_cast<std::uint32_t>(buildNode->label.size());
+        _nodes[i].route = buildNode->route;
+        _labels += buildNode->label;
+
+        _nodes[i].firstChild = static_cast<std::uint32_t>(order.size());
+        _nodes[i].childCount = static_cast<std::uint32_t>(buildNode->children.size());
+
+        for (const auto& child : buildNode->children)
+        {
+            order.push_back(child.second.get());
+            _nodes.emplace_back();
+        }
+
+        if (buildNode->wildcard)
+        {
+            _nodes[i].wildcardChild = static_cast<std::uint32_t>(order.size());
+            order.push_back(buildNode->wildcard.get());
+            _nodes.emplace_back();
+        }
+    }
+
+    _firstBytes.reserve(order.size());
+    for (const BuildNode* buildNode : order)
+        _firstBytes.push_back(buildNode->label.empty() ? '\0' : buildNode->label.front());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::size_t Router::findRoute(std::string_view target) const
+{
+    PathParameters parameters;
+    return findRoute(target, parameters);
+}
+
+std::size_t Router::findRoute(std::string_view target, PathParameters& parameters) const
+{
+    parameters._size = 0;
+
+    if (_nodes.empty() || target.empty() || target.front() != '/')
+        return npos;
+
+    std::uint32_t route = match(0, normalizePath(target), 0, parameters._values.data(), 0);
+
+    if (route == kInvalid)
+        return npos;
+
+    // every placeholder on the way to the route captured one segment - the names are copied, because the router may be
+    // gone before the request
+    parameters._size = _parameterOffsets[route + 1] - _parameterOffsets[route];
+
+    std::uint16_t offset = 0;
+    for (std::size_t i = 0; i < parameters._size; ++i)
+    {
+        const std::string& name = _parameterNames[_parameterOffsets[route] + i];
+        std::copy(name.begin(), name.end(), parameters._nameData.begin() + offset);
+        offset += static_cast<std::uint16_t>(name.size());
+        parameters._nameOffsets[i + 1] = offset;
+    }
+
+    return route;
+}
+
+std::size_t Router::nodeCount() const
+{
+    return _nodes.size();
+}
+
+std::string_view Router::normalizePath(std::string_view target)
+{
+    // cut get params
+    std::size_t pos = target.find('?');
+    if (pos != std::string_view::npos)
+        target = target.substr(0, pos);
+
+    // a trailing "/" addresses the same resource
+    if (target.size() > 1 && target.back() == '/')
+        target.remove_suffix(1);
+
+    return target;
+}
+
+bool Router::isValidPattern(std::string_view pattern)
+{
+    if (pattern.empty() || pattern.front() != '/')
+        return false;
+
+    pattern = normalizePath(pattern);
+
+    std::size_t placeholders = 0;
+    std::size_t nameLength = 0;
+    std::size_t pos = 0;
+
+    while (pos < pattern.size())
+    {
+        std::size_t end = pattern.find('/', pos + 1);
+        if (end == std::string_view::npos)
+            end = pattern.size();
+
+        std::string_view name;
+        if (isPlaceholder(pattern.substr(pos + 1, end - pos - 1), name))
+        {
+            ++placeholders;
+            nameLength += name.size();
+        }
+
+        pos = end;
+    }
+
+    return placeholders <= PathParameters::kCapacity && nameLength <= PathParameters::kNameCapacity;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::uint32_t Router::match(std::uint32_t nodeIndex, std::string_view path, std::size_t pos,
+                            std::string_view* captures, std::size_t depth) const
+{
+    const Node& node = _nodes[nodeIndex];
+
+    if (pos == path.size())
+    {
+        if (node.route != kInvalid)
+            return node.route;
+
+        // an empty last segment (e.g. "/test//") can still be matched by a placeholder - but the root has no segments
+        if (node.wildcardChild != kInvalid && path.size() > 1)
+        {
+            captures[depth] = path.substr(pos, 0);
+            return _nodes[node.wildcardChild].route;
+        }
+
+        return kInvalid;
+    }
+
+    // static segments are preferred - if they don't lead to a route we fall back to the placeholder
+    std::uint32_t childIndex = findStaticChild(node, path[pos]);
+    if (childIndex != kInvalid)
+    {
+        const Node& child = _nodes[childIndex];
+        std::string_view label(_labels.data() + child.labelOffset, child.labelLength);
+
+        if (path.substr(pos, label.size()) == label)
+        {
+            std::uint32_t route = match(childIndex, path, pos + label.size(), captures, depth);
+            if (route != kInvalid)
+                return route;
+        }
+    }
+
+    // the placeholder consumes the whole segment
+    if (node.wildcardChild != kInvalid)
+    {
+        std::size_t end = path.find('/', pos);
+        if (end == std::string_view::npos)
+            end = path.size();
+
+        captures[depth] = path.substr(pos, end - pos);
+        return match(node.wildcardChild, path, end, captures, depth + 1);
+    }
+
+    return kInvalid;
+}
+
+std::uint32_t Router::findStaticChild(const Node& node, char byte) const
+{
+    const char* first = _firstBytes.data() + node.firstChild;
+    const char* last = first + node.childCount;
+
+    // the children are sorted by their first byte - a linear scan is faster for the usual small fan-out
+    if (node.childCount <= 16)
+    {
+        for (const char* it = first; it != last; ++it)
+        {
+            if (*it == byte)
+                return static_cast<std::uint32_t>(it - _firstBytes.data());
+        }
+
+        return kInvalid;
+    }
+
+    const char* it = std::lower_bound(first, last, byte);
+    if (it != last && *it == byte)
+        return static_cast<std::uint32_t>(it - _firstBytes.data());
+
+    return kInvalid;
+}
@@ -21,23 +21,189 @@
 
 #include <rgpaul/Session.hpp>
 
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <typeinfo>
 
 #include <boost/log/trivial.hpp>
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/beast/version.hpp>
+#include <boost/filesystem.hpp>
 
+#include <rgpaul/JsonOutput.hpp>
 #include <rgpaul/RestServer.hpp>
 
 using namespace rgpaul;
 
+namespace
+{
+// the size of the chunks a streamed body is read in
+constexpr std::size_t kBodyChunkSize = 64 * 1024;
+
+// the most an idle connection reads at once (the limit Beast uses for its reads)
+constexpr std::size_t kReadSize = 64 * 1024;
+
+// writeChunk returns false once the queued chunks of a streamed response exceed this size
+constexpr std::size_t kChunkQueueSize = 256 * 1024;
+
+// ends the body of a streamed response with chunked transfer encoding
+constexpr boost::beast::string_view kLastChunk = "0\r\n\r\n";
+
+// the interim response to "Expect: 100-continue"
+constexpr boost::beast::string_view kContinue = "HTTP/1.1 100 Continue\r\n\r\n";
+
+std::string_view fieldValue(const Request& request, boost::beast::http::field field)
+{
+    boost::beast::string_view value = request[field];
+    return std::string_view(value.data(), value.size());
+}
+
+// the Date field of responses that aren't built from a header template
+boost::beast::string_view currentDate()
+{
+    std::string_view date = HeaderTemplates::date();
+    return boost::beast::string_view(date.data(), date.size());
+}
+
+// opens the precompressed sibling of the file whose encoding the client prefers - Identity if there is none
+// (variants tells whether the file has siblings - the response depends on Accept-Encoding then)
+Compression::Encoding openPrecompressed(const std::string& path, std::string_view acceptEncoding,
+                                        FileRangeBody::value_type& body, bool& variants)
+{
+    std::array<std::pair<int, Compression::Encoding>, std::size(Compression::kPrecompressed)> candidates;
+    std::size_t count = 0;
+    int minimum = Compression::minimumQuality(acceptEncoding);
+
+    for (Compression::Encoding encoding : Compression::kPrecompressed)
+    {
+        int quality = Compression::quality(acceptEncoding, encoding);
+        if (quality > 0 && quality >= minimum)
+            candidates[count++] = {quality, encoding};
+    }
+
+    std::stable_sort(candidates.begin(), candidates.begin() + count,
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        boost::beast::error_code ec;
+        body.open((path + std::string(Compression::extension(candidates[i].second))).c_str(),
+                  boost::beast::file_mode::scan, ec);
+        if (!ec)
+        {
+            variants = true;
+            return candidates[i].second;
+        }
+    }
+
+    variants = false;
+    for (Compression::Encoding encoding : Compression::kPrecompressed)
+    {
+        boost::system::error_code ec;
+        if (boost::filesystem::exists(path + std::string(Compression::extension(encoding)), ec))
+        {
+            variants = true;
+            break;
+        }
+    }
+
+    return Compression::Encoding::Identity;
+}
+
+// the ranges of a GET request that are sent instead of the whole file
+ByteRanges::Result requestedRanges(const Request& request, std::string_view etag, std::time_t modified,
+                                   std::uint64_t size, std::vector<ByteRanges::Range>& ranges)
+{
+    if (request.method() != boost::beast::http::verb::get || request.count(boost::beast::http::field::range) == 0)
+        return ByteRanges::Result::Ignored;
+
+    // the file changed since the client got the other parts - it gets the whole file
+    if (!ByteRanges::ifRangeMatches(fieldValue(request, boost::beast::http::field::if_range), etag, modified))
+        return ByteRanges::Result::Ignored;
+
+    return ByteRanges::parse(fieldValue(request, boost::beast::http::field::range), size, ranges);
+}
+
+// the parts of a multipart/byteranges body - returns its content type
+std::string multipartParts(const std::vector<ByteRanges::Range>& ranges, boost::beast::string_view contentType,
+                           std::uint64_t size, std::vector<FileRangeBody::Part>& parts, std::string& suffix)
+{
+    thread_local std::mt19937_64 random(std::random_device {}());
+
+    char boundary[17];
+    std::snprintf(boundary, sizeof(boundary), "%016llx", static_cast<unsigned long long>(random()));
+
+    for (const auto& range : ranges)
+        parts.push_back({"\r\n--" + std::string(boundary) + "\r\nContent-Type: " + std::string(contentType)
+                             + "\r\nContent-Range: " + ByteRanges::contentRange(range, size) + "\r\n\r\n",
+                         range.first, range.size()});
+
+    suffix = "\r\n--" + std::string(boundary) + "--\r\n";
+    return "multipart/byteranges; boundary=" + std::string(boundary);
+}
+
+// files that aren't cached aren't hashed - their entity tag is made of the size and the modification time
+std::string fileEntityTag(std::uint64_t size, std::time_t modified)
+{
+    char etag[48];
+    std::snprintf(etag, sizeof(etag), "\"%llx-%llx\"", static_cast<unsigned long long>(size),
+                  static_cast<unsigned long long>(modified));
+    return etag;
+}
+
+template <class Response>
+void setFileFields(Response& response, boost::beast::string_view contentType, Compression::Encoding encoding,
+                   bool vary, const std::string& etag, const std::string& lastModified)
+{
+    response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
+    response.set(boost::beast::http::field::date, currentDate());
+    response.set(boost::beast::http::field::content_type, contentType);
+
+    if (encoding != Compression::Encoding::Identity)
+        response.set(boost::beast::http::field::content_encoding, Compression::name(encoding).data());
+    if (vary)
+        response.set(boost::beast::http::field::vary, "Accept-Encoding");
+
+    response.set(boost::beast::http::field::accept_ranges, "bytes");
+    response.set(boost::beast::http::field::etag, etag);
+    response.set(boost::beast::http::field::last_modified, lastModified);
+}
+
+// the client waits for an interim response before it sends the body
+template <class Fields>
+bool expectsContinue(const boost::beast::http::header<true, Fields>& header)
+{
+    return boost::beast::iequals(header[boost::beast::http::field::expect], "100-continue");
+}
+}  // namespace
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Constructors / Destructor
 // ---------------------------------------------------------------------------------------------------------------------
 
-Session::Session(boost::asio::ip::tcp::socket&& socket, std::shared_ptr<RestServer> server)
-    : _stream(std::move(socket)), _restServer(server)
+Session::Session(boost::asio::ip::tcp::socket&& socket, std::shared_ptr<RestServer> server,
+                 ConnectionLimiter::Ticket ticket)
+    : _stream(std::move(socket)), _maxPipelineDepth(server ? server->maxPipelineDepth() : 1),
+      _fileCache(server ? server->staticFileCache() : nullptr),
+      _compression(server ? server->compression() : Compression::Settings {0}),
+      _binaryJson(server ? server->binaryJson() : false),
+      _zeroCopyFiles(server ? server->zeroCopyFiles() : false), _restServer(server), _ticket(std::move(ticket)),
+      _timeouts(server ? server->timeouts() : Timeouts {}), _bodyTimeout(_timeouts.body),
+      _context(&static_cast<boost::asio::io_context&>(
+          boost::asio::query(_stream.get_executor(), boost::asio::execution::context))),
+      _accessLog(server ? server->accessLog() : nullptr)
 {
+    if (_accessLog)
+    {
+        boost::beast::error_code ec;
+        _peer = _stream.socket().remote_endpoint(ec);
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -46,110 +212,340 @@ Session::Session(boost::asio::ip::tcp::socket&& socket, std::shared_ptr<RestServ
 
 void Session::run()
 {
+    // the wheel calls the handler on its own thread - the deadlines are checked on the thread of the session
+    auto expired = [self = weak_from_this()] {
+        if (std::shared_ptr<Session> session = self.lock())
+            boost::asio::post(session->_stream.get_executor(), [session] { session->onTimeout(); });
+    };
+    _readDeadline.setHandler(expired);
+    _writeDeadline.setHandler(expired);
+
     boost::asio::dispatch(_stream.get_executor(),
                           boost::beast::bind_front_handler(&Session::doRead, shared_from_this()));
 }
 
 void Session::sendResponse(const nlohmann::json& data)
 {
-    boost::beast::http::response<boost::beast::http::string_body> response {boost::beast::http::status::ok,
-                                                                            _req.version()};
+    if (!runningInSessionThread())
+        return postToSession([data](Session& session) { session.sendResponse(data); });
 
-    response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
-    response.set(boost::beast::http::field::content_type, "application/json");
-    response.keep_alive(_req.keep_alive());
-    response.body() = data.dump();
-    response.prepare_payload();
+    sendJson(boost::beast::http::status::ok, data);
+}
+
+void Session::sendResponse(nlohmann::json&& data)
+{
+    if (!runningInSessionThread())
+        return postToSession([data = std::move(data)](Session& session) { session.sendResponse(data); });
+
+    sendJson(boost::beast::http::status::ok, data);
+}
+
+void Session::sendResponse(std::string_view body, boost::beast::string_view contentType)
+{
+    if (!runningInSessionThread())
+        return postToSession([body = std::string(body), contentType = std::string(contentType)](Session& session) {
+            session.sendResponse(body, contentType);
+        });
+
+    Exchange* exchange = answering();
+    if (!exchange)
+        return;
+
+    auto& response = emplaceTemplate(*exchange, boost::beast::http::status::ok,
+                                     std::string_view(contentType.data(), contentType.size()));
+    response.body.assign(body.data(), body.size());
 
-    send(std::move(response));
+    sendTemplate(*exchange);
 }
 
 void Session::sendBadRequest(boost::beast::string_view why)
 {
-    nlohmann::json message = {{"error", std::string(why)}};
-    boost::beast::http::response<boost::beast::http::string_body> response {boost::beast::http::status::bad_request,
-                                                                            _req.version()};
-    response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
-    response.set(boost::beast::http::field::content_type, "application/json");
-    response.keep_alive(_req.keep_alive());
-    response.body() = message.dump();
-    response.prepare_payload();
+    if (!runningInSessionThread())
+        return postToSession([why = std::string(why)](Session& session) { session.sendBadRequest(why); });
 
-    send(std::move(response));
+    nlohmann::json message = {{"error", std::string(why)}};
+    sendJson(boost::beast::http::status::bad_request, message);
 }
 
 void Session::sendNotFound(boost::beast::string_view target)
 {
-    nlohmann::json message = {{"error", "The resource '" + std::string(target) + "' was not found."}};
-    boost::beast::http::response<boost::beast::http::string_body> response {boost::beast::http::status::not_found,
-                                                                            _req.version()};
-    response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
-    response.set(boost::beast::http::field::content_type, "application/json");
-    response.keep_alive(_req.keep_alive());
-    response.body() = message.dump();
-    response.prepare_payload();
+    if (!runningInSessionThread())
+        return postToSession([target = std::string(target)](Session& session) { session.sendNotFound(target); });
 
-    send(std::move(response));
+    nlohmann::json message = {{"error", "The resource '" + std::string(target) + "' was not found."}};
+    sendJson(boost::beast::http::status::not_found, message);
 }
 
 void Session::sendServerError(boost::beast::string_view what)
 {
+    if (!runningInSessionThread())
+        return postToSession([what = std::string(what)](Session& session) { session.sendServerError(what); });
+
     nlohmann::json message = {{"error", "An error occurred: '" + std::string(what) + "'"}};
-    boost::beast::http::response<boost::beast::http::string_body> response {
-        boost::beast::http::status::internal_server_error, _req.version()};
-    response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
-    response.set(boost::beast::http::field::content_type, "application/json");
-    response.keep_alive(_req.keep_alive());
-    response.body() = message.dump();
-    response.prepare_payload();
+    sendJson(boost::beast::http::status::internal_server_error, message);
+}
+
+void Session::sendServerError(std::uint64_t sequence, boost::beast::string_view what)
+{
+    if (!runningInSessionThread())
+        return postToSession([sequence, what = std::string(what)](Session& session) {
+            session.sendServerError(sequence, what);
+        });
+
+    if (_answeredSequence != sequence)
+        return;
 
-    send(std::move(response));
+    sendServerError(what);
+}
+
+void Session::sendServiceUnavailable(boost::beast::string_view why)
+{
+    if (!runningInSessionThread())
+        return postToSession([why = std::string(why)](Session& session) { session.sendServiceUnavailable(why); });
+
+    nlohmann::json message = {{"error", std::string(why)}};
+    sendJson(boost::beast::http::status::service_unavailable, message);
 }
 
 void Session::sendFile(const std::string& path)
 {
-    // attempt to open the file
+    if (!runningInSessionThread())
+        return postToSession([path](Session& session) { session.sendFile(path); });
+
+    Exchange* exchange = answering();
+    if (!exchange)
+        return;
+
+    const Request& request = *exchange->request;
+    std::vector<ByteRanges::Range> ranges;
+
+    // a cached file is answered without touching the file system
+    if (_fileCache)
+    {
+        if (auto entry = _fileCache->get(path))
+        {
+            // a precompressed sibling the client accepts
+            std::string_view acceptEncoding = fieldValue(request, boost::beast::http::field::accept_encoding);
+
+            if (_compression.precompressed && !acceptEncoding.empty())
+            {
+                int bestQuality = 0;
+                int minimum = Compression::minimumQuality(acceptEncoding);
+                auto file = entry;
+                for (const auto& variant : file->variants)
+                {
+                    int quality = Compression::quality(acceptEncoding, variant->encoding);
+                    if (quality > bestQuality && quality >= minimum)
+                    {
+                        bestQuality = quality;
+                        entry = variant;
+                    }
+                }
+            }
+
+            bool notModified =
+                StaticFileCache::notModified(*entry, fieldValue(request, boost::beast::http::field::if_none_match),
+                                             fieldValue(request, boost::beast::http::field::if_modified_since));
+
+            if (!notModified)
+            {
+                ByteRanges::Result result =
+                    requestedRanges(request, entry->etag, entry->modified, entry->body.size(), ranges);
+                if (result != ByteRanges::Result::Ignored)
+                    return sendCachedRanges(*exchange, *entry, mimeType(path), result, ranges);
+            }
+
+            bool withBody = !notModified && request.method() != boost::beast::http::verb::head;
+
+            exchange->cachedResponse = CachedResponse {std::move(entry), notModified, withBody,
+                                                       request.keep_alive(), request.version() < 11, {}};
+            return answered();
+        }
+    }
+
     boost::beast::error_code ec;
-    boost::beast::http::file_body::value_type body;
-    body.open(path.c_str(), boost::beast::file_mode::scan, ec);
+    FileRangeBody::value_type body;
+    Compression::Encoding encoding = Compression::Encoding::Identity;
+    bool variants = false;
+
+    if (_compression.precompressed)
+        encoding =
+            openPrecompressed(path, fieldValue(request, boost::beast::http::field::accept_encoding), body, variants);
+
+    // attempt to open the file
+    if (encoding == Compression::Encoding::Identity)
+        body.open(path.c_str(), boost::beast::file_mode::scan, ec);
 
     // Handle the case where the file doesn't exist
     if (ec == boost::beast::errc::no_such_file_or_directory)
-        return sendNotFound(_req.target());
+        return sendNotFound(request.target());
 
     // handle an unknown error
     if (ec)
         return sendServerError(ec.message());
 
-    // Cache the size since we need it after the move
-    auto const size = body.size();
+    auto const size = body.fileSize();
+
+    // the validators of the file - they decide whether the ranges of If-Range requests can be sent
+    boost::system::error_code timeError;
+    std::time_t modified = boost::filesystem::last_write_time(path + std::string(Compression::extension(encoding)),
+                                                              timeError);
+    if (timeError)
+        modified = 0;
+
+    std::string etag = fileEntityTag(size, modified);
+    std::string lastModified = StaticFileCache::formatHttpDate(modified);
+    bool vary = encoding != Compression::Encoding::Identity || variants;
+
+    ByteRanges::Result result = requestedRanges(request, etag, modified, size, ranges);
+    if (result == ByteRanges::Result::Unsatisfiable)
+        return sendRangeNotSatisfiable(*exchange, size);
 
     // respond to HEAD request
-    if (_req.method() == boost::beast::http::verb::head)
+    if (request.method() == boost::beast::http::verb::head)
     {
-        boost::beast::http::response<boost::beast::http::empty_body> response {boost::beast::http::status::ok,
-                                                                               _req.version()};
-        response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
-        response.set(boost::beast::http::field::content_type, mimeType(path));
+        auto& response = exchange->emptyResponse.message.emplace(boost::beast::http::status::ok, request.version(),
+                                                                 boost::beast::http::empty_body::value_type {},
+                                                                 ArenaAllocator(&_arena));
+        setFileFields(response, mimeType(path), encoding, vary, etag, lastModified);
         response.content_length(size);
-        response.keep_alive(_req.keep_alive());
-        return send(std::move(response));
+        response.keep_alive(request.keep_alive());
+        return answered();
+    }
+
+    // a single range is still sent by the kernel - several ranges become the parts of a multipart/byteranges body
+    std::string multipartType;
+    if (ranges.size() == 1)
+        body.setParts({{{}, ranges.front().first, ranges.front().size()}});
+    else if (ranges.size() > 1)
+    {
+        std::vector<FileRangeBody::Part> parts;
+        std::string suffix;
+        multipartType = multipartParts(ranges, mimeType(path), size, parts, suffix);
+        body.setParts(std::move(parts), std::move(suffix));
     }
 
     // respond to GET request
-    boost::beast::http::response<boost::beast::http::file_body> response {
-        std::piecewise_construct, std::make_tuple(std::move(body)),
-        std::make_tuple(boost::beast::http::status::ok, _req.version())};
+    auto status = ranges.empty() ? boost::beast::http::status::ok : boost::beast::http::status::partial_content;
+    auto& response =
+        exchange->fileResponse.message.emplace(status, request.version(), std::move(body), ArenaAllocator(&_arena));
+    setFileFields(response, mimeType(path), encoding, vary, etag, lastModified);
+
+    if (ranges.size() == 1)
+        response.set(boost::beast::http::field::content_range, ByteRanges::contentRange(ranges.front(), size));
+    else if (ranges.size() > 1)
+        response.set(boost::beast::http::field::content_type, multipartType);
+
+    response.content_length(response.body().size());
+    response.keep_alive(request.keep_alive());
+    answered();
+}
+
+void Session::beginStream(boost::beast::http::status status, boost::beast::string_view contentType,
+                          std::function<void()> drained)
+{
+    if (!runningInSessionThread())
+        return postToSession(
+            [status, contentType = std::string(contentType), drained = std::move(drained)](Session& session) mutable {
+                session.beginStream(status, contentType, std::move(drained));
+            });
+
+    Exchange* exchange = answering();
+    if (!exchange)
+        return;
+
+    const Request& request = *exchange->request;
+    auto& response = exchange->emptyResponse.message.emplace(status, request.version(),
+                                                             boost::beast::http::empty_body::value_type {},
+                                                             ArenaAllocator(&_arena));
     response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
-    response.set(boost::beast::http::field::content_type, mimeType(path));
-    response.content_length(size);
-    response.keep_alive(_req.keep_alive());
-    return send(std::move(response));
+    response.set(boost::beast::http::field::date, currentDate());
+    response.set(boost::beast::http::field::content_type, contentType);
+    response.keep_alive(request.keep_alive());
+
+    // HTTP/1.0 doesn't know chunks - the end of the connection is the end of the body
+    bool chunked = request.version() >= 11;
+    if (chunked)
+        response.chunked(true);
+    else
+        response.keep_alive(false);
+
+    exchange->streamed = true;
+    _responseStream = {true, chunked, request.method() == boost::beast::http::verb::head, false, false,
+                       std::move(drained)};
+
+    // the header doesn't wait for the first chunk
+    flush();
 }
 
-// ---------------------------------------------------------------------------------------------------------------------
-// Private
-// ---------------------------------------------------------------------------------------------------------------------
+bool Session::writeChunk(std::string_view data)
+{
+    // an empty chunk would end the body
+    if (data.empty())
+        return _queuedChunkBytes < kChunkQueueSize;
+
+    bool full = (_queuedChunkBytes += data.size()) >= kChunkQueueSize;
+
+    if (!runningInSessionThread())
+        postToSession([data = std::string(data), full](Session& session) mutable {
+            session.queueChunk(std::move(data), full);
+        });
+    else
+        queueChunk(std::string(data), full);
+
+    return !full;
+}
+
+void Session::endStream()
+{
+    if (!runningInSessionThread())
+        return postToSession([](Session& session) { session.endStream(); });
+
+    if (!_responseStream.open)
+    {
+        BOOST_LOG_TRIVIAL(error) << "end stream: no response is streamed";
+        return;
+    }
+
+    // nothing can be written anymore
+    if (_responseStream.failed)
+    {
+        _responseStream = {};
+        return;
+    }
+
+    if (_responseStream.chunked && !_responseStream.head)
+    {
+        Chunk& chunk = _exchanges[_answeredCount]->chunks.emplace_back();
+        chunk.headerSize = kLastChunk.copy(chunk.header.data(), chunk.header.size());
+    }
+
+    _responseStream = {};
+    answered();
+}
+
+void Session::pauseBody()
+{
+    if (!runningInSessionThread())
+        return postToSession([](Session& session) { session.pauseBody(); });
+
+    _bodyPaused = true;
+}
+
+void Session::resumeBody()
+{
+    if (!runningInSessionThread())
+        return postToSession([](Session& session) { session.resumeBody(); });
+
+    if (!_bodyPaused)
+        return;
+
+    _bodyPaused = false;
+
+    // while the body callback runs the next chunk is read after it returned
+    if (_bodyParser && !_deliveringBody)
+        doReadBody();
+}
 
 boost::beast::string_view Session::mimeType(boost::beast::string_view path)
 {
@@ -207,91 +603,1124 @@ boost::beast::string_view Session::mimeType(boost::beast::string_view path)
     return "application/text";
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
 void Session::doRead()
 {
-    // make the request empty before reading
-    _req = {};
+    // every exchange was written - the memory of requests and responses is handed out again
+    _receivedCount = 0;
+    _dispatchedCount = 0;
+    _answeredCount = 0;
+    _writtenCount = 0;
+    _parser.reset();
+    _bodyParser.reset();
+    _streamCallbacks.reset();
+    _arena.reset();
+
+    // the client may have pipelined more requests than we processed with the last batch
+    if (parseBuffered() > 0)
+        return processPipeline();
+
+    if (_buffer.size() > 0)
+        return doReadHeader();
+
+    // the connection is idle until the next request arrives - it is usually read completely by this read
+    _readDeadline.expiresAfter(*_context, _timeouts.idle);
+    _stream.async_read_some(
+        _buffer.prepare(boost::beast::read_size(_buffer, kReadSize)),
+        bindHandlerMemory(_readMemory, boost::beast::bind_front_handler(&Session::onReadIdle, shared_from_this())));
+}
+
+void Session::onReadIdle(boost::beast::error_code ec, std::size_t bytes_transferred)
+{
+    _readDeadline.expiresNever();
+
+    // this means they closed the connection
+    if (ec == boost::asio::error::eof)
+        return doClose();
+
+    if (ec)
+    {
+        // the operations of a connection that timed out are canceled
+        if (ec != boost::asio::error::operation_aborted)
+            BOOST_LOG_TRIVIAL(error) << "read: " << ec.message();
+        return;
+    }
+
+    _buffer.commit(bytes_transferred);
+
+    if (parseBuffered() > 0)
+        return processPipeline();
+
+    doReadHeader();
+}
+
+void Session::doReadHeader()
+{
+    _readDeadline.expiresAfter(*_context, _timeouts.header);
+
+    // read the header of a request - its endpoint decides how the body is read
+    emplaceParser();
+    boost::beast::http::async_read_header(
+        _stream, _buffer, *_parser,
+        bindHandlerMemory(_readMemory, boost::beast::bind_front_handler(&Session::onReadHeader, shared_from_this())));
+}
+
+void Session::onReadHeader(boost::beast::error_code ec, std::size_t bytes_transferred)
+{
+    boost::ignore_unused(bytes_transferred);
+
+    _readDeadline.expiresNever();
+
+    // this means they closed the connection
+    if (ec == boost::beast::http::error::end_of_stream)
+        return doClose();
+
+    if (ec)
+    {
+        // the operations of a connection that timed out are canceled
+        if (ec != boost::asio::error::operation_aborted)
+            BOOST_LOG_TRIVIAL(error) << "read: " << ec.message();
+        return;
+    }
+
+    std::shared_ptr<RestServer> restServer = _restServer.lock();
+    if (!restServer)
+        return;
+
+    RestServer::BodyPolicy policy = restServer->bodyPolicy(_parser->get().target());
+    _bodyTimeout = policy.timeout.count() > 0 ? policy.timeout : _timeouts.body;
+
+    // a body that is too large is rejected before it is transmitted
+    if (_parser->content_length() && *_parser->content_length() > policy.limit)
+        return rejectRequest(boost::beast::http::status::payload_too_large, "The request body is too large.");
+
+    if (policy.stream)
+        return startStream(std::move(*policy.stream), policy.limit, policy.route);
+
+    _parser->body_limit(policy.limit);
+
+    // the client waits for our permission before it sends the body
+    if (!_parser->is_done() && expectsContinue(_parser->get()))
+        return doContinue(false);
+
+    doReadMessage();
+}
 
-    // set the timeout
-    _stream.expires_after(std::chrono::seconds(30));
+void Session::doReadMessage()
+{
+    _readDeadline.expiresAfter(*_context, _bodyTimeout);
 
-    // read a request
-    boost::beast::http::async_read(_stream, _buffer, _req,
-                                   boost::beast::bind_front_handler(&Session::onRead, shared_from_this()));
+    // read the body of the request
+    boost::beast::http::async_read(
+        _stream, _buffer, *_parser,
+        bindHandlerMemory(_readMemory, boost::beast::bind_front_handler(&Session::onRead, shared_from_this())));
 }
 
 void Session::onRead(boost::beast::error_code ec, std::size_t bytes_transferred)
 {
     boost::ignore_unused(bytes_transferred);
 
+    _readDeadline.expiresNever();
+
     // this means they closed the connection
     if (ec == boost::beast::http::error::end_of_stream)
         return doClose();
 
+    // a chunked body that is too large
+    if (ec == boost::beast::http::error::body_limit)
+        return rejectRequest(boost::beast::http::status::payload_too_large, "The request body is too large.");
+
     if (ec)
     {
-        BOOST_LOG_TRIVIAL(error) << "read: " << ec.message();
+        // the operations of a connection that timed out are canceled
+        if (ec != boost::asio::error::operation_aborted)
+            BOOST_LOG_TRIVIAL(error) << "read: " << ec.message();
         return;
     }
 
-    // process request and send response
-    handleRequest();
+    addExchange();
+
+    // the same read may have received further pipelined requests
+    parseBuffered();
 
-    // send the response
-    // handle_request(*doc_root_, std::move(req_), lambda_);
+    // process the requests and send the responses
+    processPipeline();
 }
 
-void Session::doClose()
+void Session::doContinue(bool stream)
 {
-    // send a tcp shutdown
-    boost::beast::error_code ec;
-    _stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+    // a response of a streamed request must not be written at the same time
+    _writing = true;
+    _writeDeadline.expiresAfter(*_context, _timeouts.write);
 
-    // at this point the connection is closed
-    BOOST_LOG_TRIVIAL(info) << "closed connection";
+    boost::asio::async_write(
+        _stream, boost::asio::buffer(kContinue.data(), kContinue.size()),
+        bindHandlerMemory(_writeMemory,
+                          boost::beast::bind_front_handler(&Session::onContinue, shared_from_this(), stream)));
 }
 
-void Session::onWrite(bool close, boost::beast::error_code ec, std::size_t bytes_transferred)
+void Session::onContinue(bool stream, boost::beast::error_code ec, std::size_t bytes_transferred)
 {
     boost::ignore_unused(bytes_transferred);
 
+    _writing = false;
+    _writeDeadline.expiresNever();
+
     if (ec)
     {
-        BOOST_LOG_TRIVIAL(error) << "write: " << ec.message();
+        // the operations of a connection that timed out are canceled
+        if (ec != boost::asio::error::operation_aborted)
+            BOOST_LOG_TRIVIAL(error) << "write: " << ec.message();
         return;
     }
 
-    if (close)
+    if (!stream)
+        return doReadMessage();
+
+    // the request may have been answered by another thread in the meantime
+    flush();
+
+    if (_answeredCount == _dispatchedCount)
+        return stopStream();
+
+    doReadBody();
+}
+
+void Session::startStream(StreamCallbacks callbacks, std::uint64_t bodyLimit, std::uint32_t route)
+{
+    // the request gets a copy of the header, the parser continues with the body
+    Exchange& exchange = nextExchange();
+    exchange.request.emplace(Request::Message(_parser->get().base()));
+    exchange.request->_route = route;
+    ++_receivedCount;
+    ++_dispatchedCount;
+
+    _bodyParser.emplace(std::move(*_parser));
+    _bodyParser->body_limit(bodyLimit);
+    _parser.reset();
+
+    _streamCallbacks = std::move(callbacks);
+    if (!_bodyBuffer)
+        _bodyBuffer = std::make_unique<char[]>(kBodyChunkSize);
+
+    // the request waits for its response until the body was read
+    processPipeline();
+
+    if (_streamCallbacks->header && !_streamCallbacks->header(shared_from_this(), *exchange.request))
     {
-        // this means we should close the connection, usually because
-        // the response indicated the "Connection: close" semantic.
-        return doClose();
+        if (_answeredCount < _dispatchedCount)
+        {
+            BOOST_LOG_TRIVIAL(error) << "stream: the request to " << exchange.request->target()
+                                     << " was rejected without a response";
+            sendBadRequest("The request was rejected.");
+        }
+
+        return stopStream();
     }
 
-    // we are done with the response
-    _res = nullptr;
+    // answered right away - the body isn't needed
+    if (_answeredCount == _dispatchedCount)
+        return stopStream();
+
+    if (!_bodyParser->is_done() && expectsContinue(*exchange.request))
+        return doContinue(true);
 
-    // read another request
-    doRead();
+    doReadBody();
 }
 
-template <bool isRequest, class Body, class Fields>
-void Session::send(boost::beast::http::message<isRequest, Body, Fields>&& response)
+void Session::doReadBody()
 {
-    auto res = std::make_shared<boost::beast::http::message<isRequest, Body, Fields>>(std::move(response));
-    _res = res;
+    auto& body = _bodyParser->get().body();
+    body.data = _bodyBuffer.get();
+    body.size = kBodyChunkSize;
 
-    // write the response
-    boost::beast::http::async_write(
-        _stream, *res, boost::beast::bind_front_handler(&Session::onWrite, shared_from_this(), res->need_eof()));
+    // the timeout applies to every chunk
+    _readDeadline.expiresAfter(*_context, _bodyTimeout);
+
+    boost::beast::http::async_read(
+        _stream, _buffer, *_bodyParser,
+        bindHandlerMemory(_readMemory, boost::beast::bind_front_handler(&Session::onReadBody, shared_from_this())));
 }
 
-void Session::handleRequest()
+void Session::onReadBody(boost::beast::error_code ec, std::size_t bytes_transferred)
 {
-    std::shared_ptr<RestServer> restServer = _restServer.lock();
+    boost::ignore_unused(bytes_transferred);
 
-    if (restServer)
+    // a paused body has no deadline
+    _readDeadline.expiresNever();
+
+    // the body buffer is full
+    if (ec == boost::beast::http::error::need_buffer)
+        ec = {};
+
+    if (ec == boost::beast::http::error::body_limit && _answeredCount < _dispatchedCount)
+    {
+        nlohmann::json message = {{"error", "The request body is too large."}};
+        sendJson(boost::beast::http::status::payload_too_large, message);
+    }
+    else if (ec && ec != boost::asio::error::operation_aborted)
+        BOOST_LOG_TRIVIAL(error) << "read: " << ec.message();
+
+    // nothing is read after an error or if the request was answered before its body was complete
+    if (ec || _answeredCount == _dispatchedCount)
+        return stopStream();
+
+    std::size_t size = kBodyChunkSize - _bodyParser->get().body().size;
+    bool last = _bodyParser->is_done();
+
+    if (size > 0 || last)
     {
-        restServer->handleRequest(_req, shared_from_this());
+        _deliveringBody = true;
+        _streamCallbacks->body(shared_from_this(), *_exchanges[_dispatchedCount - 1]->request,
+                               std::string_view(_bodyBuffer.get(), size), last);
+        _deliveringBody = false;
     }
+
+    if (last || _answeredCount == _dispatchedCount)
+        return stopStream();
+
+    if (!_bodyPaused)
+        doReadBody();
+}
+
+void Session::stopStream()
+{
+    _bodyParser.reset();
+    _streamCallbacks.reset();
+    _bodyPaused = false;
+}
+
+void Session::rejectRequest(boost::beast::http::status status, boost::beast::string_view why)
+{
+    // the body isn't read, so the connection can't be used for further requests
+    Exchange& exchange = nextExchange();
+    exchange.request.emplace(Request::Message(_parser->get().base()));
+    exchange.request->keep_alive(false);
+    ++_receivedCount;
+    ++_dispatchedCount;
+    _parser.reset();
+
+    nlohmann::json message = {{"error", std::string(why)}};
+    sendJson(status, message);
+}
+
+bool Session::prepareBufferedBody()
+{
+    std::shared_ptr<RestServer> restServer = _restServer.lock();
+    if (!restServer)
+        return false;
+
+    RestServer::BodyPolicy policy = restServer->bodyPolicy(_parser->get().target());
+
+    if (policy.stream || (_parser->content_length() && *_parser->content_length() > policy.limit))
+        return false;
+
+    _parser->body_limit(policy.limit);
+    return true;
+}
+
+void Session::doClose()
+{
+    // send a tcp shutdown
+    boost::beast::error_code ec;
+    _stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+
+    // at this point the connection is closed
+    BOOST_LOG_TRIVIAL(debug) << "closed connection";
+}
+
+void Session::onWrite(std::size_t count, bool close, boost::beast::error_code ec, std::size_t bytes_transferred)
+{
+    _writing = false;
+    _writeDeadline.expiresNever();
+
+    if (ec)
+    {
+        // the operations of a connection that timed out are canceled
+        if (ec != boost::asio::error::operation_aborted)
+            BOOST_LOG_TRIVIAL(error) << "write: " << ec.message();
+        _fileTransfer.reset();
+
+        // the producer of a streamed response stops once the queue is full
+        if (_responseStream.open)
+        {
+            _responseStream.failed = true;
+            _responseStream.drained = nullptr;
+        }
+
+        return;
+    }
+
+    if (_accessLog)
+    {
+        if (_serializerWrite)
+            _exchanges[_writtenCount]->bytes += bytes_transferred;
+
+        for (std::size_t i = 0; i < count; ++i) logAccess(*_exchanges[_writtenCount + i]);
+    }
+
+    if (close)
+    {
+        // this means we should close the connection, usually because
+        // the response indicated the "Connection: close" semantic.
+        return doClose();
+    }
+
+    // we are done with these responses
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        releaseChunks(*_exchanges[_writtenCount + i]);
+        _exchanges[_writtenCount + i]->release();
+    }
+    _writtenCount += count;
+
+    // the streamed response that follows them was written partially
+    if (_writtenCount < _exchanges.size())
+        releaseChunks(*_exchanges[_writtenCount]);
+
+    // the header of a file response was written - its body follows
+    if (_fileTransfer)
+    {
+        _writing = true;
+        return doSendFile();
+    }
+
+    checkDrained();
+
+    // read further requests once all were answered - otherwise write the responses that are ready by now
+    if (_writtenCount == _receivedCount)
+        doRead();
+    else
+        processPipeline();
+}
+
+void Session::doSendFile()
+{
+    // the timeout applies to every part the kernel sends
+    _writeDeadline.expiresAfter(*_context, _timeouts.write);
+
+    Exchange& exchange = *_exchanges[_writtenCount];
+    auto& socket = _stream.socket();
+
+    // sendfile and splice must not block the thread
+    boost::beast::error_code ec;
+    if (!socket.native_non_blocking())
+        socket.native_non_blocking(true, ec);
+
+    if (!ec)
+        _fileTransfer->send(socket.native_handle(), ec);
+
+    if (ec == boost::asio::error::would_block)
+    {
+        socket.async_wait(boost::asio::ip::tcp::socket::wait_write,
+                          bindHandlerMemory(_writeMemory, boost::beast::bind_front_handler(&Session::onSendFile,
+                                                                                           shared_from_this())));
+        return;
+    }
+
+    _fileTransfer.reset();
+    bool close = exchange.fileResponse.message->need_eof();
+
+    // the kernel can't send the file - the serializer continues after the header and reads the file
+    if (ec == boost::asio::error::operation_not_supported)
+    {
+        auto& serializer = *exchange.fileResponse.serializer;
+        serializer.next(ec, [&serializer](boost::beast::error_code&, const auto& buffers) {
+            serializer.consume(boost::beast::buffer_bytes(buffers));
+        });
+
+        _serializerWrite = true;
+        boost::beast::http::async_write(
+            _stream, serializer,
+            bindHandlerMemory(_writeMemory,
+                              boost::beast::bind_front_handler(&Session::onWrite, shared_from_this(), 1, close)));
+        return;
+    }
+
+    if (!ec)
+        exchange.bytes += exchange.fileResponse.message->body().parts().front().size;
+
+    onWrite(1, close, ec, 0);
+}
+
+void Session::onSendFile(boost::beast::error_code ec)
+{
+    if (ec)
+    {
+        _fileTransfer.reset();
+        return onWrite(1, false, ec, 0);
+    }
+
+    doSendFile();
+}
+
+void Session::onTimeout()
+{
+    // the deadlines may have been moved after the wheel found them
+    if (!_readDeadline.expired() && !_writeDeadline.expired())
+    {
+        _readDeadline.reschedule(*_context);
+        _writeDeadline.reschedule(*_context);
+        return;
+    }
+
+    // the pending operations are canceled
+    BOOST_LOG_TRIVIAL(debug) << "closing connection after a timeout";
+    _stream.close();
+}
+
+void Session::emplaceParser()
+{
+    ArenaAllocator allocator(&_arena);
+    _parser.emplace(std::piecewise_construct, std::make_tuple(allocator), std::make_tuple(allocator));
+
+    // the limit depends on the endpoint - it is checked after the header was parsed
+    _parser->body_limit(std::numeric_limits<std::uint64_t>::max());
+
+    if (_accessLog)
+        _requestStart = std::chrono::steady_clock::now();
+}
+
+Session::Exchange& Session::nextExchange()
+{
+    if (_exchanges.size() == _receivedCount)
+        _exchanges.push_back(std::make_unique<Exchange>());
+
+    Exchange& exchange = *_exchanges[_receivedCount];
+    exchange.start = _requestStart;
+    return exchange;
+}
+
+void Session::addExchange()
+{
+    // moves headers and body out of the parser - they stay in the arena
+    nextExchange().request.emplace(_parser->release());
+    ++_receivedCount;
+}
+
+std::size_t Session::parseBuffered()
+{
+    std::size_t count = 0;
+
+    // nothing is read after a request that closes the connection
+    while (_receivedCount < _maxPipelineDepth && _buffer.size() > 0
+           && (_receivedCount == 0 || _exchanges[_receivedCount - 1]->request->keep_alive()))
+    {
+        emplaceParser();
+
+        const char* data = static_cast<const char*>(_buffer.data().data());
+        std::size_t consumed = 0;
+        boost::beast::error_code ec;
+
+        // the parser stops after the header - requests that are streamed, too large or incomplete are left for the
+        // asynchronous read
+        consumed = _parser->put(boost::asio::buffer(data, _buffer.size()), ec);
+        if (ec || !_parser->is_header_done() || !prepareBufferedBody())
+            break;
+
+        // continue with the body
+        while (!ec && !_parser->is_done() && consumed < _buffer.size())
+            consumed += _parser->put(boost::asio::buffer(data + consumed, _buffer.size() - consumed), ec);
+
+        // an incomplete request stays in the buffer for the next read, which also reports invalid ones
+        if (ec || !_parser->is_done())
+            break;
+
+        _buffer.consume(consumed);
+        addExchange();
+        ++count;
+    }
+
+    return count;
+}
+
+void Session::processPipeline()
+{
+    // a request is dispatched after its predecessor was answered, so a response always belongs to the oldest request
+    // that waits for one
+    _dispatching = true;
+
+    while (_dispatchedCount < _receivedCount && _answeredCount == _dispatchedCount)
+        handleRequest(*_exchanges[_dispatchedCount++]);
+
+    _dispatching = false;
+
+    // a body that is compressed by a worker needs the io_context as well
+    if (_answeredCount == _dispatchedCount && _compressing == 0)
+        _answerWork.reset();
+    else if (!_answerWork)
+        _answerWork.emplace(
+            boost::asio::prefer(_stream.get_executor(), boost::asio::execution::outstanding_work.tracked));
+
+    flush();
+}
+
+void Session::flush()
+{
+    if (_writing)
+        return;
+
+    _writeBuffers.clear();
+    std::size_t count = 0;
+    bool close = false;
+
+    for (std::size_t i = _writtenCount; i < _answeredCount && !close; ++i)
+    {
+        Exchange& exchange = *_exchanges[i];
+        std::size_t first = _writeBuffers.size();
+
+        // the responses after it have to wait as well
+        if (exchange.pending)
+            break;
+
+        // the header of a file response is written with the responses before it - the kernel sends the body
+        // afterwards
+        if (exchange.fileResponse.message && _zeroCopyFiles && exchange.fileResponse.message->body().contiguous())
+        {
+            auto& body = exchange.fileResponse.message->body();
+            gather(exchange.fileResponse, true);
+            if (_accessLog)
+                exchange.bytes += gatheredBytes(first);
+
+            _fileTransfer.emplace(body.file().native_handle(), body.parts().front().offset,
+                                  body.parts().front().size);
+            break;
+        }
+
+        // a file is read in chunks while it is written - so it gets a write of its own
+        if (exchange.fileResponse.message)
+        {
+            if (count > 0)
+                break;
+
+            _writing = true;
+            _serializerWrite = true;
+            _writeDeadline.expiresAfter(*_context, _timeouts.write);
+            close = exchange.fileResponse.message->need_eof();
+            auto& serializer = exchange.fileResponse.serializer.emplace(*exchange.fileResponse.message);
+
+            boost::beast::http::async_write(
+                _stream, serializer,
+                bindHandlerMemory(_writeMemory,
+                                  boost::beast::bind_front_handler(&Session::onWrite, shared_from_this(), 1, close)));
+            return;
+        }
+
+        if (exchange.cachedResponse)
+        {
+            close = !exchange.cachedResponse->keepAlive;
+            gatherCached(*exchange.cachedResponse);
+        }
+        else if (exchange.templateResponse)
+        {
+            close = !exchange.templateResponse->keepAlive;
+            gatherTemplate(*exchange.templateResponse);
+        }
+        else if (exchange.streamed)
+        {
+            close = exchange.emptyResponse.message->need_eof();
+            gatherStream(exchange);
+        }
+        else if (exchange.stringResponse.message)
+        {
+            close = exchange.stringResponse.message->need_eof();
+            gather(exchange.stringResponse);
+        }
+        else
+        {
+            close = exchange.emptyResponse.message->need_eof();
+            gather(exchange.emptyResponse);
+        }
+
+        if (_accessLog)
+            exchange.bytes += gatheredBytes(first);
+
+        ++count;
+    }
+
+    // the response that is streamed right now is written as far as its chunks were queued
+    if (!close && _responseStream.open && !_responseStream.failed && _writtenCount + count == _answeredCount)
+    {
+        std::size_t first = _writeBuffers.size();
+        gatherStream(*_exchanges[_answeredCount]);
+
+        if (_accessLog)
+            _exchanges[_answeredCount]->bytes += gatheredBytes(first);
+    }
+
+    // a finished stream may have nothing left to write, but has to be completed by a write nevertheless
+    if (count == 0 && _writeBuffers.empty())
+        return;
+
+    _writing = true;
+    _serializerWrite = false;
+    _writeDeadline.expiresAfter(*_context, _timeouts.write);
+
+    // all responses with one gather write
+    boost::asio::async_write(
+        _stream, _writeBuffers,
+        bindHandlerMemory(_writeMemory,
+                          boost::beast::bind_front_handler(&Session::onWrite, shared_from_this(), count, close)));
+}
+
+template <class Body>
+void Session::gather(ResponseSlot<Body>& slot, bool headerOnly)
+{
+    auto& serializer = slot.serializer.emplace(*slot.message);
+    serializer.split(headerOnly);
+
+    // the body is complete, so the first buffers of the serializer contain the header and the whole body
+    boost::beast::error_code ec;
+    serializer.next(ec, [this](boost::beast::error_code&, const auto& buffers) {
+        for (auto buffer : boost::beast::buffers_range_ref(buffers)) _writeBuffers.push_back(buffer);
+    });
+
+    if (ec)
+        BOOST_LOG_TRIVIAL(error) << "serialize: " << ec.message();
+}
+
+void Session::gatherStream(Exchange& exchange)
+{
+    // the header is written once
+    if (!exchange.headerGathered)
+    {
+        gather(exchange.emptyResponse, true);
+        exchange.headerGathered = true;
+    }
+
+    static constexpr boost::beast::string_view crlf = "\r\n";
+
+    for (std::size_t i = exchange.gatheredChunks; i < exchange.chunks.size(); ++i)
+    {
+        const Chunk& chunk = exchange.chunks[i];
+
+        if (chunk.headerSize > 0)
+            _writeBuffers.emplace_back(chunk.header.data(), chunk.headerSize);
+
+        if (!chunk.data.empty())
+        {
+            _writeBuffers.emplace_back(chunk.data.data(), chunk.data.size());
+            if (chunk.headerSize > 0)
+                _writeBuffers.emplace_back(crlf.data(), crlf.size());
+        }
+    }
+
+    exchange.gatheredChunks = exchange.chunks.size();
+}
+
+void Session::gatherCached(CachedResponse& response)
+{
+    static constexpr boost::beast::string_view statusLines[2][2] = {
+        {"HTTP/1.1 200 OK\r\n", "HTTP/1.1 304 Not Modified\r\n"},
+        {"HTTP/1.0 200 OK\r\n", "HTTP/1.0 304 Not Modified\r\n"}};
+    static constexpr boost::beast::string_view close = "Connection: close\r\n\r\n";
+    static constexpr boost::beast::string_view keepAlive = "Connection: keep-alive\r\n\r\n";
+    static constexpr boost::beast::string_view end = "\r\n";
+
+    auto add = [this](boost::beast::string_view data) { _writeBuffers.emplace_back(data.data(), data.size()); };
+
+    add(statusLines[response.http10][response.notModified]);
+    add(response.notModified ? response.entry->notModifiedFields : response.entry->fields);
+    add({response.date.data(), HeaderTemplates::writeDate(response.date.data())});
+
+    // the connection header is only needed if it differs from the default of the version
+    if (response.keepAlive == response.http10)
+        add(response.keepAlive ? keepAlive : close);
+    else
+        add(end);
+
+    if (response.withBody)
+        add(response.entry->body);
+}
+
+void Session::gatherTemplate(TemplateResponse& response)
+{
+    std::size_t fieldsSize = HeaderTemplates::writeFields(response.fields.data(), response.body.size(),
+                                                          response.version, response.keepAlive, response.encoding,
+                                                          response.vary);
+
+    // [prefix | fields | body] - only the fields were serialized for this response
+    if (response.prefix.empty())
+        _writeBuffers.emplace_back(response.ownPrefix.data(), response.ownPrefix.size());
+    else
+        _writeBuffers.emplace_back(response.prefix.data(), response.prefix.size());
+    _writeBuffers.emplace_back(response.fields.data(), fieldsSize);
+
+    if (!response.body.empty())
+        _writeBuffers.emplace_back(response.body.data(), response.body.size());
+}
+
+void Session::queueChunk(std::string data, bool full)
+{
+    if (!_responseStream.open)
+    {
+        BOOST_LOG_TRIVIAL(error) << "write chunk: no response is streamed";
+        _queuedChunkBytes -= data.size();
+        return;
+    }
+
+    // the chunk is dropped and stays counted, so the producer sees a full queue
+    if (_responseStream.failed)
+        return;
+
+    if (full)
+        _responseStream.full = true;
+
+    // the body of a response to a HEAD request is dropped
+    if (_responseStream.head)
+    {
+        _queuedChunkBytes -= data.size();
+        return checkDrained();
+    }
+
+    Chunk& chunk = _exchanges[_answeredCount]->chunks.emplace_back();
+    chunk.data = std::move(data);
+
+    if (_responseStream.chunked)
+    {
+        char* end = std::to_chars(chunk.header.data(), chunk.header.data() + chunk.header.size() - 2,
+                                  chunk.data.size(), 16)
+                        .ptr;
+        *end++ = '\r';
+        *end++ = '\n';
+        chunk.headerSize = end - chunk.header.data();
+    }
+
+    flush();
+}
+
+void Session::releaseChunks(Exchange& exchange)
+{
+    for (; exchange.gatheredChunks > 0; --exchange.gatheredChunks)
+    {
+        _queuedChunkBytes -= exchange.chunks.front().data.size();
+        exchange.chunks.pop_front();
+    }
+}
+
+void Session::checkDrained()
+{
+    if (!_responseStream.full || _queuedChunkBytes >= kChunkQueueSize)
+        return;
+
+    _responseStream.full = false;
+
+    // the callback may queue further chunks right away
+    if (_responseStream.drained)
+        _responseStream.drained();
+}
+
+std::size_t Session::gatheredBytes(std::size_t first) const
+{
+    std::size_t size = 0;
+    for (std::size_t i = first; i < _writeBuffers.size(); ++i) size += _writeBuffers[i].size();
+
+    return size;
+}
+
+void Session::logAccess(const Exchange& exchange)
+{
+    const Request& request = *exchange.request;
+    auto now = std::chrono::steady_clock::now();
+
+    AccessLog::Record record {};
+    record.timestamp = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    record.latency = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - exchange.start).count());
+    record.bytes = exchange.bytes;
+    record.address = AccessLog::addressBytes(_peer.address());
+    record.route = request.route();
+    record.port = _peer.port();
+    record.method = static_cast<std::uint8_t>(request.method());
+
+    boost::beast::http::status status = boost::beast::http::status::ok;
+    if (exchange.cachedResponse)
+        status = exchange.cachedResponse->notModified ? boost::beast::http::status::not_modified
+                                                      : boost::beast::http::status::ok;
+    else if (exchange.templateResponse)
+        status = exchange.templateResponse->status;
+    else if (exchange.fileResponse.message)
+        status = exchange.fileResponse.message->result();
+    else if (exchange.stringResponse.message)
+        status = exchange.stringResponse.message->result();
+    else if (exchange.emptyResponse.message)
+        status = exchange.emptyResponse.message->result();
+
+    record.status = static_cast<std::uint16_t>(status);
+    _accessLog->log(record);
+}
+
+Session::Exchange* Session::answering()
+{
+    if (_answeredCount == _dispatchedCount)
+    {
+        BOOST_LOG_TRIVIAL(error) << "send: there is no request that waits for a response";
+        return nullptr;
+    }
+
+    if (_responseStream.open)
+    {
+        BOOST_LOG_TRIVIAL(error) << "send: the response to the request is streamed - it is finished by endStream";
+        return nullptr;
+    }
+
+    return _exchanges[_answeredCount].get();
+}
+
+void Session::answered()
+{
+    // the rest of a streamed body isn't read - the connection can't be used for further requests
+    if (_bodyParser && !_bodyParser->is_done())
+        _exchanges[_answeredCount]->close();
+
+    ++_answeredCount;
+    ++_answeredSequence;
+
+    // the callback answered later - continue with the pipeline
+    if (!_dispatching)
+        processPipeline();
+}
+
+bool Session::runningInSessionThread()
+{
+    // sessions of a shared context run on a strand - with a context per thread they run on the io_context directly
+    // (target() doesn't check the type of the executor - compare it first)
+    using Context = boost::asio::io_context::executor_type;
+    using Strand = boost::asio::strand<Context>;
+
+    auto executor = _stream.get_executor();
+
+    if (executor.target_type() == typeid(Strand))
+        return executor.target<Strand>()->running_in_this_thread();
+
+    if (executor.target_type() == typeid(Context))
+        return executor.target<Context>()->running_in_this_thread();
+
+    return true;
+}
+
+template <class Function>
+void Session::postToSession(Function function)
+{
+    boost::asio::post(_stream.get_executor(),
+                      [self = shared_from_this(), function = std::move(function)]() mutable { function(*self); });
+}
+
+void Session::handleRequest(Exchange& exchange)
+{
+    std::shared_ptr<RestServer> restServer = _restServer.lock();
+
+    if (restServer)
+    {
+        restServer->handleRequest(*exchange.request, shared_from_this());
+    }
+}
+
+void Session::sendJson(boost::beast::http::status status, const nlohmann::json& data)
+{
+    Exchange* exchange = answering();
+    if (!exchange)
+        return;
+
+    JsonCodec::Format format = JsonCodec::Format::Json;
+    if (_binaryJson)
+        format = JsonCodec::negotiate(fieldValue(*exchange->request, boost::beast::http::field::accept));
+
+    auto& response = emplaceTemplate(*exchange, status, JsonCodec::contentType(format));
+    if (_binaryJson)
+        response.vary = HeaderTemplates::kVaryAccept;
+
+    // serialized straight into the body - there is no temporary string that would be copied
+    // (the responses of a connection tend to have similar sizes, so the body rarely has to grow - one large response
+    // mustn't make every later one reserve more than the arena keeps, though)
+    response.body.reserve(_jsonSizeHint);
+    JsonOutput<ArenaStringBody::value_type>::serialize(data, response.body, format);
+    _jsonSizeHint = std::min(response.body.size(), SessionArena::kMaxRetainedSize);
+
+    sendTemplate(*exchange);
+}
+
+Session::TemplateResponse& Session::emplaceTemplate(Exchange& exchange, boost::beast::http::status status,
+                                                    std::string_view contentType)
+{
+    const Request& request = *exchange.request;
+    ArenaAllocator allocator(&_arena);
+    auto& response = exchange.templateResponse.emplace(
+        TemplateResponse {HeaderTemplates::prefix(status, request.version(), contentType), status,
+                          ArenaStringBody::value_type(allocator), request.version(), request.keep_alive(),
+                          Compression::Encoding::Identity, 0, {}, ArenaStringBody::value_type(allocator)});
+
+    if (response.prefix.empty())
+    {
+        std::string prefix = HeaderTemplates::serializePrefix(status, request.version(), contentType);
+        response.ownPrefix.assign(prefix.data(), prefix.size());
+    }
+
+    return response;
+}
+
+void Session::sendTemplate(Exchange& exchange)
+{
+    const Request& request = *exchange.request;
+    auto& response = *exchange.templateResponse;
+
+    // a body that is large enough to be compressed depends on Accept-Encoding
+    if (_compression.level > 0 && request.compressResponse() && response.body.size() >= _compression.minSize)
+    {
+        response.vary |= HeaderTemplates::kVaryAcceptEncoding;
+
+        Compression::Encoding encoding =
+            Compression::negotiate(fieldValue(request, boost::beast::http::field::accept_encoding),
+                                   {Compression::Encoding::Gzip, Compression::Encoding::Deflate});
+
+        if (encoding != Compression::Encoding::Identity)
+            return sendCompressed(exchange, encoding);
+    }
+
+    answered();
+}
+
+void Session::sendCachedRanges(Exchange& exchange, const StaticFileCache::Entry& entry,
+                               boost::beast::string_view contentType, ByteRanges::Result result,
+                               const std::vector<ByteRanges::Range>& ranges)
+{
+    std::uint64_t size = entry.body.size();
+    if (result == ByteRanges::Result::Unsatisfiable)
+        return sendRangeNotSatisfiable(exchange, size);
+
+    const Request& request = *exchange.request;
+    ArenaAllocator allocator(&_arena);
+    auto& response = exchange.stringResponse.message.emplace(boost::beast::http::status::partial_content,
+                                                             request.version(), allocator, allocator);
+
+    bool vary = entry.encoding != Compression::Encoding::Identity || !entry.variants.empty();
+    setFileFields(response, contentType, entry.encoding, vary, entry.etag, entry.lastModified);
+
+    auto& body = response.body();
+
+    if (ranges.size() == 1)
+    {
+        response.set(boost::beast::http::field::content_range, ByteRanges::contentRange(ranges.front(), size));
+        body.assign(entry.body.data() + ranges.front().first, ranges.front().size());
+    }
+    else
+    {
+        std::vector<FileRangeBody::Part> parts;
+        std::string suffix;
+        response.set(boost::beast::http::field::content_type, multipartParts(ranges, contentType, size, parts, suffix));
+
+        for (const auto& part : parts)
+        {
+            body.append(part.prefix.data(), part.prefix.size());
+            body.append(entry.body.data() + part.offset, part.size);
+        }
+        body.append(suffix.data(), suffix.size());
+    }
+
+    response.keep_alive(request.keep_alive());
+    response.prepare_payload();
+    answered();
+}
+
+void Session::sendRangeNotSatisfiable(Exchange& exchange, std::uint64_t size)
+{
+    const Request& request = *exchange.request;
+    auto& response = exchange.emptyResponse.message.emplace(boost::beast::http::status::range_not_satisfiable,
+                                                            request.version(),
+                                                            boost::beast::http::empty_body::value_type {},
+                                                            ArenaAllocator(&_arena));
+    response.set(boost::beast::http::field::server, BOOST_BEAST_VERSION_STRING);
+    response.set(boost::beast::http::field::date, currentDate());
+    response.set(boost::beast::http::field::content_range, ByteRanges::contentRange(size));
+    response.content_length(0);
+    response.keep_alive(request.keep_alive());
+    answered();
+}
+
+void Session::sendCompressed(Exchange& exchange, Compression::Encoding encoding)
+{
+    auto& response = *exchange.templateResponse;
+    std::string_view body(response.body.data(), response.body.size());
+
+    std::shared_ptr<RestServer> restServer = _restServer.lock();
+
+    // a large body would hold up the other connections of the thread - the request counts as answered, but its
+    // response (and the ones after it) are written once the worker is done
+    // (the worker reads the body in place: a pending response is neither released nor written in the meantime)
+    if (restServer && body.size() >= _compression.offloadSize)
+    {
+        bool queued = restServer->submitToWorkers(
+            [self = shared_from_this(), exchange = &exchange, body, encoding, level = _compression.level] {
+                std::string output;
+                bool compressed = Compression::compress(body, encoding, level, output);
+
+                self->postToSession([exchange, output = std::move(output), compressed, encoding](Session& session) {
+                    if (compressed)
+                        session.setCompressedBody(*exchange, output, encoding);
+                    exchange->pending = false;
+                    --session._compressing;
+                    session.processPipeline();
+                });
+            });
+
+        if (queued)
+        {
+            exchange.pending = true;
+            ++_compressing;
+            return answered();
+        }
+    }
+
+    // the output buffer of the thread keeps its capacity
+    thread_local std::string output;
+    if (Compression::compress(body, encoding, _compression.level, output))
+        setCompressedBody(exchange, output, encoding);
+
+    answered();
+}
+
+void Session::setCompressedBody(Exchange& exchange, std::string_view body, Compression::Encoding encoding)
+{
+    auto& response = *exchange.templateResponse;
+    response.encoding = encoding;
+    response.body.assign(body.data(), body.size());
+}
+
+void Session::Exchange::close()
+{
+    if (cachedResponse)
+        cachedResponse->keepAlive = false;
+    if (templateResponse)
+        templateResponse->keepAlive = false;
+    if (stringResponse.message)
+        stringResponse.message->keep_alive(false);
+    if (emptyResponse.message)
+        emptyResponse.message->keep_alive(false);
+    if (fileResponse.message)
+        fileResponse.message->keep_alive(false);
+}
+
+void Session::Exchange::release()
+{
+    streamed = false;
+    headerGathered = false;
+    pending = false;
+    chunks.clear();
+    gatheredChunks = 0;
+    bytes = 0;
+
+    stringResponse.serializer.reset();
+    stringResponse.message.reset();
+    emptyResponse.serializer.reset();
+    emptyResponse.message.reset();
+    fileResponse.serializer.reset();
+    fileResponse.message.reset();
+    cachedResponse.reset();
+    templateResponse.reset();
+    request.reset();
 }
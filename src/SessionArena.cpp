@@ -0,0 +1,142 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/SessionArena.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+using namespace rgpaul;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+SessionArena::SessionArena(std::size_t initialSize) : _initialSize(std::max<std::size_t>(initialSize, 64))
+{
+    addBlock(_initialSize);
+}
+
+SessionArena::~SessionArena()
+{
+    releaseBlocks();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Accessors
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::size_t SessionArena::capacity() const
+{
+    std::size_t capacity = 0;
+    for (const Block* block = _blocks; block; block = block->next) capacity += block->size;
+
+    return capacity;
+}
+
+std::size_t SessionArena::blockAllocations() const
+{
+    return _blockAllocations;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+void SessionArena::reset()
+{
+    // the last request didn't fit into one block => grow to the size of all blocks together - unless that would pin the
+    // memory of a large body for the rest of the connection (a growing body leaves its old buffers behind)
+    if (_blocks->next)
+    {
+        std::size_t size = capacity();
+        if (size > kMaxRetainedSize)
+            size = _initialSize;
+
+        releaseBlocks();
+        addBlock(size);
+        return;
+    }
+
+    _position = reinterpret_cast<char*>(_blocks + 1);
+    _remaining = _blocks->size;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+void* SessionArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* pointer = _position;
+    std::size_t space = _remaining;
+
+    if (!std::align(alignment, bytes, pointer, space))
+    {
+        // at least double the size, so that a growing request needs only a few blocks
+        addBlock(std::max(bytes + alignment, _blocks->size * 2));
+
+        pointer = _position;
+        space = _remaining;
+        std::align(alignment, bytes, pointer, space);
+    }
+
+    _position = static_cast<char*>(pointer) + bytes;
+    _remaining = space - bytes;
+
+    return pointer;
+}
+
+void SessionArena::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    // the memory is reused after the next reset
+    (void)pointer;
+    (void)bytes;
+    (void)alignment;
+}
+
+bool SessionArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void SessionArena::addBlock(std::size_t size)
+{
+    Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+    block->next = _blocks;
+    block->size = size;
+    _blocks = block;
+    ++_blockAllocations;
+
+    _position = reinterpret_cast<char*>(block + 1);
+    _remaining = size;
+}
+
+void SessionArena::releaseBlocks()
+{
+    while (_blocks)
+    {
+        Block* next = _blocks->next;
+        ::operator delete(_blocks);
+        _blocks = next;
+    }
+}
@@ -0,0 +1,570 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/StaticFileCache.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/version.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <rgpaul/CivilDate.hpp>
+#include <rgpaul/HeaderValues.hpp>
+#include <rgpaul/Session.hpp>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace rgpaul;
+
+namespace
+{
+constexpr const char* kWeekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+constexpr const char* kMonths[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// parses a number with exactly the given digits
+bool parseNumber(std::string_view text, std::size_t pos, std::size_t digits, unsigned& value)
+{
+    value = 0;
+    for (std::size_t i = pos; i < pos + digits; ++i)
+    {
+        if (text[i] < '0' || text[i] > '9')
+            return false;
+        value = value * 10 + static_cast<unsigned>(text[i] - '0');
+    }
+
+    return true;
+}
+
+// FNV-1a - the ETag only has to change with the content
+std::uint64_t hash(const std::string& data)
+{
+    std::uint64_t value = 14695981039346656037ULL;
+    for (unsigned char byte : data) value = (value ^ byte) * 1099511628211ULL;
+    return value;
+}
+
+// the file that a precompressed sibling belongs to - empty for other files
+std::string_view precompressedFile(std::string_view name)
+{
+    for (Compression::Encoding encoding : Compression::kPrecompressed)
+    {
+        std::string_view extension = Compression::extension(encoding);
+        if (name.size() > extension.size() && name.substr(name.size() - extension.size()) == extension)
+            return name.substr(0, name.size() - extension.size());
+    }
+
+    return {};
+}
+
+// the header fields of a cached file - a file with precompressed siblings depends on Accept-Encoding
+void serializeFields(StaticFileCache::Entry& entry, const std::string& path, bool vary)
+{
+    std::string validators = "ETag: " + entry.etag + "\r\nLast-Modified: " + entry.lastModified + "\r\n";
+    std::string server = std::string("Server: ") + BOOST_BEAST_VERSION_STRING + "\r\n";
+
+    if (entry.encoding != Compression::Encoding::Identity)
+        validators += "Content-Encoding: " + std::string(Compression::name(entry.encoding)) + "\r\n";
+
+    if (vary)
+        validators += "Vary: Accept-Encoding\r\n";
+
+    entry.fields = server + "Content-Type: " + std::string(Session::mimeType(path))
+                   + "\r\nContent-Length: " + std::to_string(entry.body.size()) + "\r\nAccept-Ranges: bytes\r\n"
+                   + validators;
+    entry.notModifiedFields = server + validators;
+}
+
+std::size_t entrySize(const StaticFileCache::Entry& entry)
+{
+    std::size_t size = entry.body.size() + entry.fields.size() + entry.notModifiedFields.size();
+    for (const auto& variant : entry.variants) size += entrySize(*variant);
+    return size;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+StaticFileCache::StaticFileCache(std::size_t capacity, std::size_t maxFileSize)
+    : _capacity(capacity), _maxFileSize(std::min(maxFileSize, capacity))
+{
+#if defined(__linux__)
+    _inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    _wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (_inotify < 0 || _wakeup < 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "static file cache: changed files can't be detected (inotify is not available)";
+        return;
+    }
+
+    _watcher = std::thread([this] { watch(); });
+#endif
+}
+
+StaticFileCache::~StaticFileCache()
+{
+#if defined(__linux__)
+    if (_watcher.joinable())
+    {
+        std::uint64_t one = 1;
+        if (::write(_wakeup, &one, sizeof(one)) < 0)
+            BOOST_LOG_TRIVIAL(error) << "static file cache: can't stop the watcher";
+        _watcher.join();
+    }
+
+    if (_inotify >= 0)
+        ::close(_inotify);
+    if (_wakeup >= 0)
+        ::close(_wakeup);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<const StaticFileCache::Entry> StaticFileCache::get(const std::string& path)
+{
+    std::string fileName;
+    int watch = -1;
+    std::uint64_t generation = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _index.find(path);
+        if (it != _index.end())
+        {
+            _lru.splice(_lru.begin(), _lru, it->second);
+            ++_metrics.hits;
+            return it->second->entry;
+        }
+
+        ++_metrics.misses;
+
+        // the directory is watched before the file is read, so no change can be missed
+        watch = watchDirectory(path, fileName);
+        if (watch >= 0)
+            ++_watchedFiles[watch][fileName].loading;
+
+        generation = _generation;
+    }
+
+    std::shared_ptr<Entry> entry = load(path);
+    std::size_t size = entry ? entrySize(*entry) : 0;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    forgetFile(watch, fileName, nullptr);
+
+    if (!entry)
+        return nullptr;
+
+    // a file changed while it was loaded - it may be outdated already
+    if (generation != _generation)
+        return entry;
+
+    // loaded by another thread in the meantime
+    auto it = _index.find(path);
+    if (it != _index.end())
+        erase(it->second);
+
+    _lru.push_front({path, entry, size, watch, fileName});
+    _index.emplace(_lru.front().path, _lru.begin());
+    _size += size;
+
+    if (watch >= 0)
+        _watchedFiles[watch][fileName].nodes.push_back(_lru.begin());
+
+    while (_size > _capacity && _lru.size() > 1)
+    {
+        erase(std::prev(_lru.end()));
+        ++_metrics.evictions;
+    }
+
+    return entry;
+}
+
+void StaticFileCache::invalidate(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+
+    auto it = _index.find(path);
+    if (it != _index.end())
+    {
+        erase(it->second);
+        ++_metrics.invalidations;
+    }
+}
+
+void StaticFileCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+
+    _index.clear();
+    _lru.clear();
+    _watchedFiles.clear();
+    _size = 0;
+}
+
+std::size_t StaticFileCache::count() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _lru.size();
+}
+
+std::size_t StaticFileCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+std::size_t StaticFileCache::capacity() const
+{
+    return _capacity;
+}
+
+std::size_t StaticFileCache::maxFileSize() const
+{
+    return _maxFileSize;
+}
+
+StaticFileCache::Metrics StaticFileCache::metrics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _metrics;
+}
+
+bool StaticFileCache::notModified(const Entry& entry, std::string_view ifNoneMatch, std::string_view ifModifiedSince)
+{
+    // a list of entity tags - If-None-Match uses the weak comparison
+    if (!ifNoneMatch.empty())
+    {
+        while (!ifNoneMatch.empty())
+        {
+            std::size_t end = std::min(ifNoneMatch.find(','), ifNoneMatch.size());
+            std::string_view tag = HeaderValues::trim(ifNoneMatch.substr(0, end));
+            ifNoneMatch.remove_prefix(std::min(end + 1, ifNoneMatch.size()));
+
+            if (tag.substr(0, 2) == "W/")
+                tag.remove_prefix(2);
+
+            if (tag == "*" || tag == entry.etag)
+                return true;
+        }
+
+        return false;
+    }
+
+    if (ifModifiedSince.empty())
+        return false;
+
+    std::time_t since = parseHttpDate(ifModifiedSince);
+    return since >= 0 && entry.modified <= since;
+}
+
+std::string StaticFileCache::formatHttpDate(std::time_t time)
+{
+    std::int64_t days = time >= 0 ? time / 86400 : (time - 86399) / 86400;
+    std::int64_t seconds = time - days * 86400;
+
+    CivilDate date = CivilDate::fromDays(days);
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%s, %02u %s %04lld %02u:%02u:%02u GMT",
+                  kWeekdays[(days % 7 + 11) % 7], date.day, kMonths[date.month - 1], static_cast<long long>(date.year),
+                  static_cast<unsigned>(seconds / 3600), static_cast<unsigned>(seconds / 60 % 60),
+                  static_cast<unsigned>(seconds % 60));
+
+    return buffer;
+}
+
+std::time_t StaticFileCache::parseHttpDate(std::string_view date)
+{
+    // only the fixed format that every sender has to use - "Sun, 06 Nov 1994 08:49:37 GMT"
+    if (date.size() != 29 || date.substr(3, 2) != ", " || date.substr(25) != " GMT")
+        return -1;
+
+    unsigned month = 0;
+    while (month < 12 && date.substr(8, 3) != kMonths[month]) ++month;
+
+    unsigned day, year, hours, minutes, seconds;
+    if (month == 12 || !parseNumber(date, 5, 2, day) || !parseNumber(date, 12, 4, year)
+        || !parseNumber(date, 17, 2, hours) || !parseNumber(date, 20, 2, minutes) || !parseNumber(date, 23, 2, seconds))
+        return -1;
+
+    if (day < 1 || day > 31 || hours > 23 || minutes > 59 || seconds > 60)
+        return -1;
+
+    return static_cast<std::time_t>(CivilDate {year, month + 1, day}.days() * 86400 + hours * 3600 + minutes * 60
+                                    + seconds);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<StaticFileCache::Entry> StaticFileCache::load(const std::string& path) const
+{
+    std::shared_ptr<Entry> entry = read(path);
+    if (!entry)
+        return nullptr;
+
+    for (Compression::Encoding encoding : Compression::kPrecompressed)
+    {
+        std::shared_ptr<Entry> variant = read(path + std::string(Compression::extension(encoding)));
+        if (!variant)
+            continue;
+
+        variant->encoding = encoding;
+        serializeFields(*variant, path, true);
+        entry->variants.push_back(std::move(variant));
+    }
+
+    serializeFields(*entry, path, !entry->variants.empty());
+
+    return entry;
+}
+
+std::shared_ptr<StaticFileCache::Entry> StaticFileCache::read(const std::string& path) const
+{
+    boost::beast::error_code ec;
+    boost::beast::file file;
+    file.open(path.c_str(), boost::beast::file_mode::scan, ec);
+    if (ec)
+        return nullptr;
+
+    std::uint64_t size = file.size(ec);
+    if (ec || size > _maxFileSize)
+        return nullptr;
+
+    auto entry = std::make_shared<Entry>();
+    entry->body.resize(static_cast<std::size_t>(size));
+
+    std::size_t read = 0;
+    while (!ec && read < entry->body.size())
+    {
+        std::size_t n = file.read(&entry->body[read], entry->body.size() - read, ec);
+        if (n == 0)
+            break;
+        read += n;
+    }
+
+    if (ec || read != entry->body.size())
+        return nullptr;
+
+    boost::system::error_code timeError;
+    entry->modified = boost::filesystem::last_write_time(path, timeError);
+    if (timeError)
+        entry->modified = 0;
+
+    char etag[48];
+    std::snprintf(etag, sizeof(etag), "\"%llx-%llx\"", static_cast<unsigned long long>(size),
+                  static_cast<unsigned long long>(hash(entry->body)));
+    entry->etag = etag;
+    entry->lastModified = formatHttpDate(entry->modified);
+
+    return entry;
+}
+
+int StaticFileCache::watchDirectory(const std::string& path, std::string& fileName)
+{
+    boost::filesystem::path filePath(path);
+    fileName = filePath.filename().string();
+
+    std::string directory = filePath.parent_path().string();
+    if (directory.empty())
+        directory = ".";
+
+    auto it = _watches.find(directory);
+    if (it != _watches.end())
+        return it->second;
+
+    int watch = -1;
+
+#if defined(__linux__)
+    if (_inotify >= 0)
+        watch = ::inotify_add_watch(_inotify, directory.c_str(),
+                                    IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                                        | IN_DELETE_SELF | IN_MOVE_SELF);
+#endif
+
+    // a directory that can't be watched is tried again with the next miss
+    if (watch >= 0)
+        _watches.emplace(directory, watch);
+
+    return watch;
+}
+
+void StaticFileCache::watch()
+{
+#if defined(__linux__)
+    pollfd descriptors[2] = {{_inotify, POLLIN, 0}, {_wakeup, POLLIN, 0}};
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (true)
+    {
+        if (::poll(descriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            BOOST_LOG_TRIVIAL(error) << "static file cache: " << std::strerror(errno);
+            return;
+        }
+
+        if (descriptors[1].revents != 0)
+            return;
+
+        ssize_t length = ::read(_inotify, buffer, sizeof(buffer));
+        if (length <= 0)
+            continue;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            // events were lost - everything may have changed
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                ++_generation;
+                _metrics.invalidations += _lru.size();
+                _index.clear();
+                _lru.clear();
+                _watchedFiles.clear();
+                _size = 0;
+                continue;
+            }
+
+            // the directory itself is gone - all of its files are dropped and it is watched again with the next miss
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+            {
+                for (auto it = _watches.begin(); it != _watches.end();)
+                    it = it->second == event->wd ? _watches.erase(it) : std::next(it);
+
+                auto files = _watchedFiles.find(event->wd);
+                if (files == _watchedFiles.end())
+                    continue;
+
+                auto gone = std::move(files->second);
+                _watchedFiles.erase(files);
+                ++_generation;
+
+                for (const auto& file : gone)
+                {
+                    for (auto node : file.second.nodes)
+                    {
+                        erase(node);
+                        ++_metrics.invalidations;
+                    }
+                }
+
+                continue;
+            }
+
+            // only changes of cached or loading files (or their precompressed siblings) matter
+            if (event->len == 0)
+                continue;
+
+            std::string_view name(event->name);
+            std::string_view sibling = precompressedFile(name);
+
+            bool changed = fileChanged(event->wd, std::string(name));
+            if (!sibling.empty())
+                changed = fileChanged(event->wd, std::string(sibling)) || changed;
+
+            if (changed)
+                ++_generation;
+        }
+    }
+#endif
+}
+
+bool StaticFileCache::fileChanged(int watch, const std::string& fileName)
+{
+    auto files = _watchedFiles.find(watch);
+    if (files == _watchedFiles.end())
+        return false;
+
+    auto file = files->second.find(fileName);
+    if (file == files->second.end())
+        return false;
+
+    // erase forgets the nodes of the file (and the file itself, unless it is still loading)
+    std::vector<std::list<Node>::iterator> nodes = file->second.nodes;
+    for (auto node : nodes)
+    {
+        erase(node);
+        ++_metrics.invalidations;
+    }
+
+    return true;
+}
+
+void StaticFileCache::forgetFile(int watch, const std::string& fileName, const Node* node)
+{
+    auto files = _watchedFiles.find(watch);
+    if (files == _watchedFiles.end())
+        return;
+
+    auto file = files->second.find(fileName);
+    if (file == files->second.end())
+        return;
+
+    // a node that was dropped - or a miss that finished loading
+    if (node)
+    {
+        auto& nodes = file->second.nodes;
+        nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [node](auto it) { return &*it == node; }), nodes.end());
+    }
+    else if (file->second.loading > 0)
+        --file->second.loading;
+
+    if (file->second.nodes.empty() && file->second.loading == 0)
+        files->second.erase(file);
+    if (files->second.empty())
+        _watchedFiles.erase(files);
+}
+
+void StaticFileCache::erase(std::list<Node>::iterator node)
+{
+    forgetFile(node->watch, node->fileName, &*node);
+    _size -= node->size;
+    _index.erase(node->path);
+    _lru.erase(node);
+}
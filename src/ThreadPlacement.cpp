@@ -0,0 +1,370 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/ThreadPlacement.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace rgpaul;
+
+namespace
+{
+// the memory policy of set_mempolicy(2) - allocate from the given node first and fall back to the others if it is full
+constexpr int kPreferredPolicy = 1;
+
+std::string readLine(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// parses lists like "0-3,8,10-11"
+std::vector<unsigned> parseCpuList(const std::string& list)
+{
+    std::vector<unsigned> cpus;
+    std::istringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ','))
+    {
+        if (range.empty())
+            continue;
+
+        try
+        {
+            std::size_t dash = range.find('-');
+            unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            unsigned last = first;
+            if (dash != std::string::npos)
+                last = static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+
+            for (unsigned cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        catch (const std::exception&)
+        {
+            return {};
+        }
+    }
+
+    return cpus;
+}
+
+// parses hex masks like "00000000,0000000f" - the lowest cpu is the last digit
+std::vector<unsigned> parseCpuMask(const std::string& mask)
+{
+    std::vector<unsigned> cpus;
+    unsigned cpu = 0;
+
+    for (auto it = mask.rbegin(); it != mask.rend(); ++it)
+    {
+        if (*it == ',' || *it == '\n')
+            continue;
+
+        unsigned digit = 0;
+        if (*it >= '0' && *it <= '9')
+            digit = static_cast<unsigned>(*it - '0');
+        else if (*it >= 'a' && *it <= 'f')
+            digit = static_cast<unsigned>(*it - 'a' + 10);
+        else if (*it >= 'A' && *it <= 'F')
+            digit = static_cast<unsigned>(*it - 'A' + 10);
+        else
+            return {};
+
+        for (unsigned bit = 0; bit < 4; ++bit)
+        {
+            if (digit & (1u << bit))
+                cpus.push_back(cpu + bit);
+        }
+
+        cpu += 4;
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+// the first of the given cpus the process may run on
+int firstAvailable(const std::vector<unsigned>& cpus, const std::vector<unsigned>& available)
+{
+    for (unsigned cpu : cpus)
+    {
+        if (std::find(available.begin(), available.end(), cpu) != available.end())
+            return static_cast<int>(cpu);
+    }
+
+    return -1;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+ThreadPlacement ThreadPlacement::onCpus(std::vector<unsigned> cpus)
+{
+    ThreadPlacement placement;
+    placement._policy = Policy::Cpus;
+    placement._cpus = std::move(cpus);
+    return placement;
+}
+
+ThreadPlacement ThreadPlacement::onPhysicalCores()
+{
+    ThreadPlacement placement;
+    placement._policy = Policy::PhysicalCores;
+    placement._cpus = physicalCoreCpus();
+    return placement;
+}
+
+ThreadPlacement ThreadPlacement::onNicQueues(const std::string& interface)
+{
+    ThreadPlacement placement;
+    placement._policy = Policy::NicQueues;
+    placement._cpus = nicQueueCpus(interface);
+
+    if (placement._cpus.empty())
+        BOOST_LOG_TRIVIAL(warning) << "thread placement: no receive queues found for '" << interface
+                                   << "' - threads are not pinned.";
+
+    return placement;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Accessors
+// ---------------------------------------------------------------------------------------------------------------------
+
+ThreadPlacement& ThreadPlacement::bindMemory(bool bind)
+{
+    _bindMemory = bind;
+    return *this;
+}
+
+ThreadPlacement::Policy ThreadPlacement::policy() const
+{
+    return _policy;
+}
+
+bool ThreadPlacement::bindsMemory() const
+{
+    return _bindMemory;
+}
+
+const std::vector<unsigned>& ThreadPlacement::cpus() const
+{
+    return _cpus;
+}
+
+int ThreadPlacement::cpuForThread(std::size_t index) const
+{
+    if (_cpus.empty())
+        return -1;
+
+    return static_cast<int>(_cpus[index % _cpus.size()]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ThreadPlacement::apply(std::size_t index, const std::string& name) const
+{
+    if (!name.empty())
+        setThreadName(name);
+
+    int cpu = cpuForThread(index);
+    if (cpu < 0)
+        return;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "pin thread '" << name << "' to cpu " << cpu << ": " << std::strerror(result);
+        return;
+    }
+
+    if (!_bindMemory)
+        return;
+
+    int node = numaNode(static_cast<unsigned>(cpu));
+    if (node < 0)
+        return;
+
+    // the kernel reads maxnode - 1 bits
+    constexpr std::size_t bitsPerLong = sizeof(unsigned long) * CHAR_BIT;
+    std::vector<unsigned long> nodes(static_cast<std::size_t>(node) / bitsPerLong + 1, 0);
+    nodes[static_cast<std::size_t>(node) / bitsPerLong] |= 1ul << (static_cast<std::size_t>(node) % bitsPerLong);
+
+    if (syscall(SYS_set_mempolicy, kPreferredPolicy, nodes.data(), nodes.size() * bitsPerLong + 1) != 0)
+        BOOST_LOG_TRIVIAL(error) << "bind memory of thread '" << name << "' to node " << node << ": "
+                                 << std::strerror(errno);
+#else
+    BOOST_LOG_TRIVIAL(warning) << "pin thread '" << name << "': pinning is not supported on this platform.";
+#endif
+}
+
+std::vector<unsigned> ThreadPlacement::availableCpus()
+{
+    std::vector<unsigned> cpus;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+        }
+
+        return cpus;
+    }
+#endif
+
+    for (unsigned cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); ++cpu) cpus.push_back(cpu);
+
+    return cpus;
+}
+
+std::vector<unsigned> ThreadPlacement::physicalCoreCpus()
+{
+    std::vector<unsigned> available = availableCpus();
+    std::vector<unsigned> cpus;
+
+    for (unsigned cpu : available)
+    {
+        // a core is represented by its first available sibling
+        std::vector<unsigned> siblings = parseCpuList(
+            readLine("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list"));
+
+        if (siblings.empty() || firstAvailable(siblings, available) == static_cast<int>(cpu))
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+std::vector<unsigned> ThreadPlacement::nicQueueCpus(const std::string& interface)
+{
+    std::vector<unsigned> available = availableCpus();
+    std::vector<unsigned> cpus;
+
+    auto add = [&cpus](int cpu) {
+        if (cpu >= 0 && std::find(cpus.begin(), cpus.end(), static_cast<unsigned>(cpu)) == cpus.end())
+            cpus.push_back(static_cast<unsigned>(cpu));
+    };
+
+    if (interface.empty())
+        return cpus;
+
+    // the interrupts of the queues are named after the interface (e.g. "eth0-TxRx-3")
+    std::ifstream interrupts("/proc/interrupts");
+    std::string line;
+
+    while (std::getline(interrupts, line))
+    {
+        std::istringstream stream(line);
+        std::string irq;
+        std::string token;
+        std::string name;
+
+        stream >> irq;
+        while (stream >> token) name = token;
+
+        if (irq.empty() || irq.back() != ':' || name.compare(0, interface.size(), interface) != 0)
+            continue;
+
+        if (name.size() > interface.size() && name[interface.size()] != '-')
+            continue;
+
+        irq.pop_back();
+        add(firstAvailable(parseCpuList(readLine("/proc/irq/" + irq + "/smp_affinity_list")), available));
+    }
+
+    if (!cpus.empty())
+        return cpus;
+
+    // without dedicated interrupts the receive packet steering decides where the packets are processed
+    for (unsigned queue = 0;; ++queue)
+    {
+        std::string path = "/sys/class/net/" + interface + "/queues/rx-" + std::to_string(queue) + "/rps_cpus";
+        if (!boost::filesystem::exists(path))
+            break;
+
+        add(firstAvailable(parseCpuMask(readLine(path)), available));
+    }
+
+    return cpus;
+}
+
+int ThreadPlacement::numaNode(unsigned cpu)
+{
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator it("/sys/devices/system/cpu/cpu" + std::to_string(cpu), ec);
+
+    // the cpu directory links to its node ("node0")
+    for (; !ec && it != boost::filesystem::directory_iterator(); it.increment(ec))
+    {
+        std::string name = it->path().filename().string();
+
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+            return std::stoi(name.substr(4));
+    }
+
+    return -1;
+}
+
+void ThreadPlacement::setThreadName(const std::string& name)
+{
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#endif
+}
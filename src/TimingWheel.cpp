@@ -0,0 +1,277 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/TimingWheel.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace rgpaul;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+TimingWheel::TimingWheel(boost::asio::io_context& context) : _context(context), _timer(context), _visited(now()) {}
+
+TimingWheel::Deadline::~Deadline()
+{
+    if (!_wheel)
+        return;
+
+    std::lock_guard<std::mutex> lock(_wheel->_mutex);
+    if (_linked.load(std::memory_order_relaxed))
+        _wheel->unlink(*this);
+
+    // nothing left - the pending tick would keep the context busy
+    if (_wheel->_size == 0 && _wheel->_waiting)
+    {
+        _wheel->_timer.cancel();
+        _wheel->_waiting = false;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+void TimingWheel::Deadline::setHandler(std::function<void()> handler)
+{
+    _handler = std::move(handler);
+}
+
+void TimingWheel::Deadline::expiresAfter(boost::asio::io_context& context, std::chrono::milliseconds timeout)
+{
+    // rounded up and the current tick has already begun - a deadline never expires early
+    std::uint64_t ticks = static_cast<std::uint64_t>((std::max(timeout, kTick) + kTick - std::chrono::milliseconds(1))
+                                                     / kTick);
+    std::uint64_t tick = now() + ticks + 1;
+    bool earlier = tick < _armedTick;
+
+    // sequentially consistent with the wheel that drops disarmed deadlines - one of both sees the other
+    _tick.store(tick);
+    _armedTick = tick;
+
+    if (!_linked.load())
+        return reschedule(context);
+
+    // the usual case for a keep-alive connection - the wheel picks up the later time when it visits the slot
+    if (!earlier)
+        return;
+
+    // the slot would be visited too late
+    {
+        std::lock_guard<std::mutex> lock(_wheel->_mutex);
+        if (_linked.load(std::memory_order_relaxed))
+        {
+            _wheel->unlink(*this);
+            _wheel->link(*this, tick);
+            return;
+        }
+    }
+
+    reschedule(context);
+}
+
+void TimingWheel::Deadline::expiresNever()
+{
+    _tick.store(kNever, std::memory_order_relaxed);
+}
+
+void TimingWheel::Deadline::reschedule(boost::asio::io_context& context)
+{
+    if (!armed())
+        return;
+
+    // the wheel it was in last may have kept it after all
+    if (_wheel)
+    {
+        std::lock_guard<std::mutex> lock(_wheel->_mutex);
+        if (_linked.load(std::memory_order_relaxed))
+            return;
+    }
+
+    // not in a wheel - the wheel it was in last doesn't touch it anymore
+    _wheel = TimingWheel::local(context);
+
+    std::lock_guard<std::mutex> lock(_wheel->_mutex);
+    _wheel->add(*this);
+}
+
+bool TimingWheel::Deadline::armed() const
+{
+    return _tick.load(std::memory_order_relaxed) != kNever;
+}
+
+bool TimingWheel::Deadline::expired() const
+{
+    std::uint64_t tick = _tick.load(std::memory_order_relaxed);
+    return tick != kNever && tick <= now();
+}
+
+std::shared_ptr<TimingWheel> TimingWheel::local(boost::asio::io_context& context)
+{
+    // a thread runs one context at a time - a thread that runs another one later gets a new wheel
+    // (only the deadlines keep a wheel alive, so it never outlives the sessions of its context)
+    thread_local std::weak_ptr<TimingWheel> local;
+
+    std::shared_ptr<TimingWheel> wheel = local.lock();
+    if (!wheel || &wheel->_context != &context)
+    {
+        wheel = std::make_shared<TimingWheel>(context);
+        local = wheel;
+    }
+
+    return wheel;
+}
+
+std::uint64_t TimingWheel::now()
+{
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch() / kTick);
+}
+
+std::size_t TimingWheel::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+void TimingWheel::add(Deadline& deadline)
+{
+    link(deadline, deadline._tick.load(std::memory_order_relaxed));
+
+    if (!_waiting)
+        wait();
+}
+
+void TimingWheel::link(Deadline& deadline, std::uint64_t tick)
+{
+    // a deadline that passed already is found with the next tick
+    deadline._slot = std::max(tick, _visited + 1) % kSlots;
+    deadline._previous = nullptr;
+    deadline._next = _slots[deadline._slot];
+
+    if (deadline._next)
+        deadline._next->_previous = &deadline;
+
+    _slots[deadline._slot] = &deadline;
+    ++_size;
+
+    deadline._linked.store(true, std::memory_order_release);
+}
+
+void TimingWheel::unlink(Deadline& deadline)
+{
+    if (deadline._previous)
+        deadline._previous->_next = deadline._next;
+    else
+        _slots[deadline._slot] = deadline._next;
+
+    if (deadline._next)
+        deadline._next->_previous = deadline._previous;
+
+    deadline._previous = nullptr;
+    deadline._next = nullptr;
+    --_size;
+
+    deadline._linked.store(false);
+}
+
+void TimingWheel::wait()
+{
+    _waiting = true;
+
+    // setting the expiry cancels a wait that may still be pending
+    _timer.expires_at(std::chrono::steady_clock::time_point(kTick * (_visited + 1)));
+    _timer.async_wait([self = weak_from_this()](boost::system::error_code ec) {
+        if (std::shared_ptr<TimingWheel> wheel = self.lock())
+            wheel->onTick(ec);
+    });
+}
+
+void TimingWheel::onTick(boost::system::error_code ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    std::vector<std::function<void()>> expired;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::uint64_t current = now();
+
+        // after a long stall every slot is visited once
+        if (current > _visited + kSlots)
+            _visited = current - kSlots;
+
+        while (_visited < current)
+        {
+            ++_visited;
+
+            Deadline* deadline = _slots[_visited % kSlots];
+            while (deadline)
+            {
+                Deadline* next = deadline->_next;
+                std::uint64_t tick = deadline->_tick.load(std::memory_order_relaxed);
+
+                if (tick == Deadline::kNever)
+                {
+                    unlink(*deadline);
+
+                    // the owner may have armed it again without seeing it leave the wheel
+                    tick = deadline->_tick.load();
+                    if (tick != Deadline::kNever)
+                        link(*deadline, tick);
+                }
+                else if (tick <= current)
+                {
+                    unlink(*deadline);
+                    expired.push_back(deadline->_handler);
+                }
+                else if (tick % kSlots != deadline->_slot)
+                {
+                    // the deadline was moved - it waits in the slot of its new time
+                    unlink(*deadline);
+                    link(*deadline, tick);
+                }
+
+                deadline = next;
+            }
+        }
+
+        _waiting = false;
+        if (_size > 0)
+            wait();
+    }
+
+    // the handlers may destroy deadlines of this wheel
+    for (auto& handler : expired)
+    {
+        if (handler)
+            handler();
+    }
+}
@@ -38,15 +38,12 @@ std::string UriNode::id() const
     return _id;
 }
 
-std::function<void(std::shared_ptr<Session>, const boost::beast::http::request<boost::beast::http::string_body>&)>
-UriNode::callback() const
+RestServerCallback UriNode::callback() const
 {
     return _callback;
 }
 
-void UriNode::setCallback(
-    std::function<void(std::shared_ptr<Session>, const boost::beast::http::request<boost::beast::http::string_body>&)>
-        callback)
+void UriNode::setCallback(RestServerCallback callback)
 {
     _callback = std::move(callback);
 }
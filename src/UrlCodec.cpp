@@ -0,0 +1,408 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/UrlCodec.hpp>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RGP_URLCODEC_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// gcc and clang only emit avx2 instructions for functions that are marked for it
+#if defined(RGP_URLCODEC_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RGP_TARGET_SSE2 __attribute__((target("sse2")))
+#define RGP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RGP_TARGET_SSE2
+#define RGP_TARGET_AVX2
+#endif
+
+using namespace rgpaul;
+
+namespace
+{
+// only alphanum are safe characters
+constexpr char kSafe[256] = {/*      0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F */
+                             /* 0 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* 1 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* 2 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* 3 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+
+                             /* 4 */ 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                             /* 5 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+                             /* 6 */ 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                             /* 7 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+
+                             /* 8 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* 9 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* A */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* B */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+
+                             /* C */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* D */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* E */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                             /* F */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+constexpr char kDec2hex[16 + 1] = "0123456789ABCDEF";
+
+// Note from RFC1630: "Sequences which start with a percent
+// sign but are not followed by two hexadecimal characters
+// (0-9, A-F) are reserved for future extension"
+constexpr char kHex2Dec[256] = {/*       0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F */
+                                /* 0 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 1 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 2 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 3 */ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  -1, -1, -1, -1, -1, -1,
+
+                                /* 4 */ -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 5 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 6 */ -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 7 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+
+                                /* 8 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* 9 */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* A */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* B */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+
+                                /* C */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* D */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* E */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                /* F */ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+// escapes a single character
+inline unsigned char* encodeByte(unsigned char c, unsigned char* output)
+{
+    *output++ = '%';
+    *output++ = kDec2hex[c >> 4];
+    *output++ = kDec2hex[c & 0x0F];
+    return output;
+}
+
+// decodes the "%" at input (if it is followed by two hex digits) and advances both pointers
+inline void decodePercent(const unsigned char*& input, const unsigned char* end, unsigned char*& output)
+{
+    char dec1, dec2;
+    if (input + 2 < end && -1 != (dec1 = kHex2Dec[input[1]]) && -1 != (dec2 = kHex2Dec[input[2]]))
+    {
+        *output++ = static_cast<unsigned char>((dec1 << 4) + dec2);
+        input += 3;
+        return;
+    }
+
+    *output++ = *input++;
+}
+
+std::size_t encodeScalar(const unsigned char* input, std::size_t length, unsigned char* output)
+{
+    const unsigned char* const end = input + length;
+    unsigned char* const start = output;
+
+    for (; input < end; ++input)
+    {
+        // check if this character is a safe one (that don't needs to be escaped)
+        if (kSafe[*input])
+            *output++ = *input;
+        else
+            output = encodeByte(*input, output);
+    }
+
+    return output - start;
+}
+
+std::size_t decodeScalar(const unsigned char* input, std::size_t length, unsigned char* output)
+{
+    const unsigned char* const end = input + length;
+    unsigned char* const start = output;
+
+    while (input < end)
+    {
+        if (*input == '%')
+            decodePercent(input, end, output);
+        else
+            *output++ = *input++;
+    }
+
+    return output - start;
+}
+
+#if defined(RGP_URLCODEC_X86)
+
+inline unsigned countTrailingZeros(unsigned value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// sets all bytes of the result to 0xFF whose value is in [low, low + range]
+RGP_TARGET_SSE2 inline __m128i inRange(__m128i block, char low, char range)
+{
+    __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8(low));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(range)), shifted);
+}
+
+RGP_TARGET_SSE2 inline unsigned safeMask(__m128i block)
+{
+    __m128i digits = inRange(block, '0', 9);
+    __m128i letters = inRange(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 25);
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(digits, letters)));
+}
+
+RGP_TARGET_SSE2 std::size_t encodeSse2(const unsigned char* input, std::size_t length, unsigned char* output)
+{
+    const unsigned char* const end = input + length;
+    unsigned char* const start = output;
+
+    while (end - input >= 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        unsigned safe = safeMask(block);
+
+        // the output has space for 3 characters per input character, so we can always store the whole block
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), block);
+
+        if (safe == 0xFFFF)
+        {
+            input += 16;
+            output += 16;
+            continue;
+        }
+
+        // keep the safe prefix and escape the first unsafe character
+        unsigned prefix = countTrailingZeros(~safe);
+        input += prefix;
+        output = encodeByte(*input++, output + prefix);
+    }
+
+    return (output - start) + encodeScalar(input, end - input, output);
+}
+
+RGP_TARGET_SSE2 std::size_t decodeSse2(const unsigned char* input, std::size_t length, unsigned char* output)
+{
+    const unsigned char* const end = input + length;
+    unsigned char* const start = output;
+    const __m128i percent = _mm_set1_epi8('%');
+
+    while (end - input >= 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, percent)));
+
+        // output is never ahead of input, so storing a block that was read completely is safe when decoding in place
+        if (mask == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), block);
+            input += 16;
+            output += 16;
+            continue;
+        }
+
+        unsigned prefix = countTrailingZeros(mask);
+        std::memmove(output, input, prefix);
+        input += prefix;
+        output += prefix;
+
+        decodePercent(input, end, output);
+    }
+
+    return (output - start) + decodeScalar(input, end - input, output);
+}
+
+RGP_TARGET_AVX2 inline __m256i inRange256(__m256i block, char low, char range)
+{
+    __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8(low));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(range)), shifted);
+}
+
+RGP_TARGET_AVX2 std::size_t encodeAvx2(const unsigned char* input, std::size_t length, unsigned char* output)
+{
+    const unsigned char* const end = input + length;
+    unsigned char* const start = output;
+
+    while (end - input >= 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+        __m256i digits = inRange256(block, '0', 9);
+        __m256i letters = inRange256(_mm256_or_si256(block, _mm256_set1_epi8(0x20)), 'a', 25);
+        unsigned safe = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(digits, letters)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), block);
+
+        if (safe == 0xFFFFFFFF)
+        {
+            input += 32;
+            output += 32;
+            continue;
+        }
+
+        unsigned prefix = countTrailingZeros(~safe);
+        input += prefix;
+        output = encodeByte(*input++, output + prefix);
+    }
+
+    return (output - start) + encodeSse2(input, end - input, output);
+}
+
+RGP_TARGET_AVX2 std::size_t decodeAvx2(const unsigned char* input, std::size_t length, unsigned char* output)
+{
+    const unsigned char* const end = input + length;
+    unsigned char* const start = output;
+    const __m256i percent = _mm256_set1_epi8('%');
+
+    while (end - input >= 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, percent)));
+
+        if (mask == 0)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), block);
+            input += 32;
+            output += 32;
+            continue;
+        }
+
+        unsigned prefix = countTrailingZeros(mask);
+        std::memmove(output, input, prefix);
+        input += prefix;
+        output += prefix;
+
+        decodePercent(input, end, output);
+    }
+
+    return (output - start) + decodeSse2(input, end - input, output);
+}
+
+bool cpuSupportsAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // the os has to save the ymm registers
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // RGP_URLCODEC_X86
+
+UrlCodec::Kernel detectKernel()
+{
+#if defined(RGP_URLCODEC_X86)
+    if (cpuSupportsAvx2())
+        return UrlCodec::Kernel::avx2;
+
+    return UrlCodec::Kernel::sse2;
+#else
+    return UrlCodec::Kernel::scalar;
+#endif
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+UrlCodec::Kernel UrlCodec::activeKernel()
+{
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+bool UrlCodec::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::scalar:
+            return true;
+        case Kernel::sse2:
+            return activeKernel() != Kernel::scalar;
+        case Kernel::avx2:
+            return activeKernel() == Kernel::avx2;
+    }
+
+    return false;
+}
+
+std::size_t UrlCodec::encode(const char* input, std::size_t length, char* output)
+{
+    return encode(input, length, output, activeKernel());
+}
+
+std::size_t UrlCodec::encode(const char* input, std::size_t length, char* output, Kernel kernel)
+{
+    auto source = reinterpret_cast<const unsigned char*>(input);
+    auto destination = reinterpret_cast<unsigned char*>(output);
+
+    switch (kernel)
+    {
+#if defined(RGP_URLCODEC_X86)
+        case Kernel::avx2:
+            return encodeAvx2(source, length, destination);
+        case Kernel::sse2:
+            return encodeSse2(source, length, destination);
+#endif
+        default:
+            return encodeScalar(source, length, destination);
+    }
+}
+
+std::size_t UrlCodec::decode(const char* input, std::size_t length, char* output)
+{
+    return decode(input, length, output, activeKernel());
+}
+
+std::size_t UrlCodec::decode(const char* input, std::size_t length, char* output, Kernel kernel)
+{
+    auto source = reinterpret_cast<const unsigned char*>(input);
+    auto destination = reinterpret_cast<unsigned char*>(output);
+
+    switch (kernel)
+    {
+#if defined(RGP_URLCODEC_X86)
+        case Kernel::avx2:
+            return decodeAvx2(source, length, destination);
+        case Kernel::sse2:
+            return decodeSse2(source, length, destination);
+#endif
+        default:
+            return decodeScalar(source, length, destination);
+    }
+}
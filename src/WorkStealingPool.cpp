@@ -0,0 +1,260 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#include <rgpaul/WorkStealingPool.hpp>
+
+#include <algorithm>
+#include <exception>
+
+#include <boost/log/trivial.hpp>
+
+#include <rgpaul/ThreadPlacement.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the index of the worker that runs on the current thread and its pool
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local std::size_t currentWorker = 0;
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Constructors / Destructor
+// ---------------------------------------------------------------------------------------------------------------------
+
+WorkStealingPool::WorkStealingPool(std::size_t threads, std::size_t queueCapacity)
+{
+    threads = std::max<std::size_t>(threads, 1);
+    queueCapacity = std::max<std::size_t>(queueCapacity, 1);
+
+    _workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        _workers.push_back(std::make_unique<Worker>());
+        _workers.back()->own.tasks.resize(queueCapacity);
+        _workers.back()->submitted.tasks.resize(queueCapacity);
+    }
+
+    // the workers are started after all deques exist, because they steal from each other
+    for (std::size_t i = 0; i < threads; ++i) _workers[i]->thread = std::thread([this, i] { run(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+
+    _wakeup.notify_all();
+
+    for (auto& worker : _workers) worker->thread.join();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Accessors
+// ---------------------------------------------------------------------------------------------------------------------
+
+std::size_t WorkStealingPool::threadCount() const
+{
+    return _workers.size();
+}
+
+WorkStealingPool::Metrics WorkStealingPool::metrics() const
+{
+    Metrics metrics;
+    metrics.queueDepths.reserve(_workers.size());
+
+    for (const auto& worker : _workers)
+    {
+        metrics.queueDepths.push_back(worker->depth.load(std::memory_order_relaxed));
+        metrics.executed += worker->executed.load(std::memory_order_relaxed);
+        metrics.stolen += worker->stolen.load(std::memory_order_relaxed);
+    }
+
+    metrics.rejected = _rejected.load(std::memory_order_relaxed);
+
+    return metrics;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool WorkStealingPool::submit(Task task)
+{
+    // a worker keeps its own tasks - others are distributed round robin, a full queue passes the task on to the next
+    bool fromOwner = currentPool == this && _workers[currentWorker]->push(task, true);
+
+    if (!fromOwner)
+    {
+        std::size_t first = _nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+
+        std::size_t i = 0;
+        while (i < _workers.size() && !_workers[(first + i) % _workers.size()]->push(task, false)) ++i;
+
+        if (i == _workers.size())
+        {
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    _pending.fetch_add(1);
+
+    // taking the lock makes sure a worker that is about to sleep sees the task
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+
+    _wakeup.notify_one();
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Private
+// ---------------------------------------------------------------------------------------------------------------------
+
+void WorkStealingPool::run(std::size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    ThreadPlacement::setThreadName("rgp-worker-" + std::to_string(index));
+
+    Worker& worker = *_workers[index];
+    Task task;
+
+    while (true)
+    {
+        if (findTask(index, task))
+        {
+            _pending.fetch_sub(1);
+
+            try
+            {
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                BOOST_LOG_TRIVIAL(error) << "worker task: " << e.what();
+            }
+
+            task = nullptr;
+            worker.executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+
+        // the remaining tasks are still executed when stopping
+        if (_stopping && _pending == 0)
+            return;
+
+        _wakeup.wait(lock, [this] { return _stopping || _pending > 0; });
+    }
+}
+
+bool WorkStealingPool::findTask(std::size_t index, Task& task)
+{
+    if (_workers[index]->pop(task))
+        return true;
+
+    for (std::size_t i = 1; i < _workers.size(); ++i)
+    {
+        if (_workers[(index + i) % _workers.size()]->steal(task))
+        {
+            _workers[index]->stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WorkStealingPool::Worker::push(Task& task, bool fromOwner)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!(fromOwner ? own : submitted).pushBack(task))
+        return false;
+
+    depth.store(own.size + submitted.size, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingPool::Worker::pop(Task& task)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // the newest task of the owner is still warm in its cache - submitted tasks wait in order
+    if (!own.popBack(task) && !submitted.popFront(task))
+        return false;
+
+    depth.store(own.size + submitted.size, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingPool::Worker::steal(Task& task)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!submitted.popFront(task) && !own.popFront(task))
+        return false;
+
+    depth.store(own.size + submitted.size, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingPool::Ring::pushBack(Task& task)
+{
+    if (size == tasks.size())
+        return false;
+
+    tasks[(head + size) % tasks.size()] = std::move(task);
+    ++size;
+
+    return true;
+}
+
+bool WorkStealingPool::Ring::popBack(Task& task)
+{
+    if (size == 0)
+        return false;
+
+    task = std::move(tasks[(head + size - 1) % tasks.size()]);
+    --size;
+
+    return true;
+}
+
+bool WorkStealingPool::Ring::popFront(Task& task)
+{
+    if (size == 0)
+        return false;
+
+    task = std::move(tasks[head]);
+    head = (head + 1) % tasks.size();
+    --size;
+
+    return true;
+}
@@ -40,6 +40,9 @@ std::string serverHost {"127.0.0.1"};
 // port that should be used
 unsigned short serverPort {8080};
 
+// binary access log that should be written (none if empty)
+std::string accessLogPath;
+
 // this will hold all possible program options that can be specified
 std::unique_ptr<boost::program_options::options_description> optionsDescription;
 
@@ -49,7 +52,6 @@ void processArgs(int argc, const char** argv);
 int main(int argc, const char** argv)
 {
     using namespace rgpaul;
-    namespace http = boost::beast::http;
 
     // output some info if the program was started
     std::cout << "Rest Server v" << APP_VERSION << std::endl
@@ -69,27 +71,25 @@ int main(int argc, const char** argv)
 
     auto restServer = std::make_shared<RestServer>(serverHost);
 
-    restServer->registerEndpoint("/",
-                                 [](std::shared_ptr<Session> session, const http::request<http::string_body>& request) {
-                                     BOOST_LOG_TRIVIAL(info) << "in callback for /";
+    if (!accessLogPath.empty())
+        restServer->setAccessLog(std::make_shared<AccessLog>(accessLogPath));
 
-                                     nlohmann::json data {{"message", "Test Response"}};
+    restServer->registerEndpoint("/", [](std::shared_ptr<Session> session, const Request& request) {
+        BOOST_LOG_TRIVIAL(info) << "in callback for /";
 
-                                     session->sendResponse(data);
-                                 });
+        nlohmann::json data {{"message", "Test Response"}};
 
-    restServer->registerEndpoint("/test/$/detail",
-                                 [](std::shared_ptr<Session> session, const http::request<http::string_body>& request) {
-                                     BOOST_LOG_TRIVIAL(info) << "in callback for /test/$/detail";
+        session->sendResponse(data);
+    });
 
-                                     std::string target = std::string(request.target());
-                                     std::vector<std::string> paths = RestServer::splitUri(target);
+    restServer->registerEndpoint("/test/{id}/detail", [](std::shared_ptr<Session> session, const Request& request) {
+        BOOST_LOG_TRIVIAL(info) << "in callback for /test/{id}/detail";
 
-                                     nlohmann::json data;
-                                     data["message"] = "detail ressource for id: " + paths.at(2);
+        nlohmann::json data;
+        data["message"] = "detail ressource for id: " + std::string(request.pathParameters().get("id").value_or(""));
 
-                                     session->sendResponse(data);
-                                 });
+        session->sendResponse(data);
+    });
 
     restServer->startListening(10);
 
@@ -108,7 +108,9 @@ void processArgs(int argc, const char** argv)
     optionsDescription->add_options()("host,h", boost::program_options::value<std::string>(),
                                       "Specify the hostname that should be used. default: 0.0.0.0")(
         "port,p", boost::program_options::value<std::string>(), "Specify the port that should be used. default: 8080")(
-        "help", "Show all available options.");
+        "access-log", boost::program_options::value<std::string>(), "Write a binary access log to the given file.")(
+        "format-access-log", boost::program_options::value<std::string>(),
+        "Print the records of a binary access log as text and exit.")("help", "Show all available options.");
 
     boost::program_options::variables_map map;
     boost::program_options::store(boost::program_options::parse_command_line(argc, argv, *optionsDescription), map);
@@ -121,6 +123,21 @@ void processArgs(int argc, const char** argv)
         std::exit(EXIT_SUCCESS);
     }
 
+    // formatting a log doesn't need a server
+    if (map.count("format-access-log"))
+    {
+        for (const auto& record : rgpaul::AccessLog::read(map["format-access-log"].as<std::string>()))
+            std::cout << rgpaul::AccessLog::format(record) << std::endl;
+
+        std::exit(EXIT_SUCCESS);
+    }
+
+    // if the access-log parameter was specified, the server records every answered request
+    if (map.count("access-log"))
+    {
+        accessLogPath = map["access-log"].as<std::string>();
+    }
+
     // if the host parameter was specified, we store that information in the host variable
     if (map.count("host"))
     {
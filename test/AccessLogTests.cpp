@@ -0,0 +1,140 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPAccessLog"
+
+#include <rgpaul/AccessLog.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/beast/http/verb.hpp>
+
+#include <rgpaul/Request.hpp>
+
+#include "TemporaryDirectory.hpp"
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+AccessLog::Record makeRecord(std::uint32_t route, std::uint16_t status)
+{
+    AccessLog::Record record {};
+    record.timestamp = 1588334400000123;  // 2020-05-01T12:00:00.000123Z
+    record.latency = 52;
+    record.bytes = 128;
+    record.address = AccessLog::addressBytes(boost::asio::ip::make_address("127.0.0.1"));
+    record.route = route;
+    record.port = 54321;
+    record.status = status;
+    record.method = static_cast<std::uint8_t>(boost::beast::http::verb::get);
+    return record;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPAccessLog)
+
+BOOST_AUTO_TEST_CASE(roundTrip)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.path("access.log");
+
+    {
+        AccessLog log(path);
+        BOOST_REQUIRE(log.isOpen());
+
+        log.log(makeRecord(3, 200));
+
+        // every thread has a ring of its own
+        std::thread([&log] { log.log(makeRecord(Request::kNoRoute, 404)); }).join();
+
+        log.flush();
+        BOOST_CHECK_EQUAL(log.metrics().written, 2);
+        BOOST_CHECK_EQUAL(log.metrics().dropped, 0);
+    }
+
+    // an existing file is continued
+    {
+        AccessLog log(path);
+        log.log(makeRecord(1, 201));
+    }
+
+    std::vector<AccessLog::Record> records = AccessLog::read(path);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+
+    std::vector<std::uint16_t> statuses;
+    for (const auto& record : records) statuses.push_back(record.status);
+    std::sort(statuses.begin(), statuses.begin() + 2);
+    BOOST_CHECK((statuses == std::vector<std::uint16_t> {200, 404, 201}));
+
+    BOOST_CHECK_EQUAL(AccessLog::address(records[2]), boost::asio::ip::make_address("127.0.0.1"));
+    BOOST_CHECK_EQUAL(records[2].route, 1);
+}
+
+BOOST_AUTO_TEST_CASE(format)
+{
+    BOOST_CHECK_EQUAL(AccessLog::format(makeRecord(3, 200)),
+                      "2020-05-01T12:00:00.000123Z 127.0.0.1:54321 GET /3 200 128 B 52 us");
+
+    AccessLog::Record record = makeRecord(Request::kNoRoute, 404);
+    record.address = AccessLog::addressBytes(boost::asio::ip::make_address("::1"));
+    record.method = static_cast<std::uint8_t>(boost::beast::http::verb::post);
+    BOOST_CHECK_EQUAL(AccessLog::format(record), "2020-05-01T12:00:00.000123Z [::1]:54321 POST - 404 128 B 52 us");
+}
+
+BOOST_AUTO_TEST_CASE(fullRing)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.path("access.log");
+    AccessLog log(path);
+
+    // the drain thread may catch up in between - every record is either written or dropped
+    const std::uint64_t count = 4 * AccessLog::kRingSize;
+    for (std::uint64_t i = 0; i < count; ++i) log.log(makeRecord(0, 200));
+
+    log.flush();
+    AccessLog::Metrics metrics = log.metrics();
+    BOOST_CHECK_EQUAL(metrics.written + metrics.dropped, count);
+    BOOST_CHECK(metrics.written >= AccessLog::kRingSize);
+}
+
+BOOST_AUTO_TEST_CASE(invalidFile)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("access.log", "no access log");
+    BOOST_CHECK(AccessLog::read(path).empty());
+
+    AccessLog log(path + "/missing");
+    BOOST_CHECK(!log.isOpen());
+    log.log(makeRecord(0, 200));
+    BOOST_CHECK_EQUAL(log.metrics().written, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPByteRanges"
+
+#include <rgpaul/ByteRanges.hpp>
+
+#include <string>
+#include <vector>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the ranges as "first-last" pairs
+std::string format(const std::vector<ByteRanges::Range>& ranges)
+{
+    std::string text;
+    for (const auto& range : ranges)
+        text += (text.empty() ? "" : ",") + std::to_string(range.first) + "-" + std::to_string(range.last);
+    return text;
+}
+
+ByteRanges::Result parse(const std::string& header, std::uint64_t size, std::string& ranges)
+{
+    std::vector<ByteRanges::Range> parsed;
+    ByteRanges::Result result = ByteRanges::parse(header, size, parsed);
+    ranges = format(parsed);
+    return result;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPByteRanges)
+
+BOOST_AUTO_TEST_CASE(single)
+{
+    std::string ranges;
+
+    BOOST_CHECK(parse("bytes=0-499", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "0-499");
+
+    // open ranges and ranges beyond the end end with the last byte
+    BOOST_CHECK(parse("bytes=9500-", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "9500-9999");
+    BOOST_CHECK(parse("bytes=9500-20000", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "9500-9999");
+    BOOST_CHECK(parse("bytes=0-99999999999999999999999", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "0-9999");
+
+    // suffix ranges
+    BOOST_CHECK(parse("bytes=-500", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "9500-9999");
+    BOOST_CHECK(parse("bytes=-20000", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "0-9999");
+    BOOST_CHECK(parse("BYTES= -1", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "9999-9999");
+}
+
+BOOST_AUTO_TEST_CASE(multiple)
+{
+    std::string ranges;
+
+    BOOST_CHECK(parse("bytes=500-599, 0-99,-100", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "0-99,500-599,9900-9999");
+
+    // overlapping and adjacent ranges are merged
+    BOOST_CHECK(parse("bytes=0-99,50-149,150-199,,300-", 400, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "0-199,300-399");
+
+    // unsatisfiable ranges are dropped if others can be satisfied
+    BOOST_CHECK(parse("bytes=20000-,0-0", 10000, ranges) == ByteRanges::Result::Satisfiable);
+    BOOST_CHECK_EQUAL(ranges, "0-0");
+
+    // too many ranges
+    std::string header = "bytes=";
+    for (std::size_t i = 0; i <= ByteRanges::kMaxRanges; ++i)
+        header += std::to_string(i * 10) + "-" + std::to_string(i * 10 + 1) + ",";
+    BOOST_CHECK(parse(header, 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(ranges.empty());
+}
+
+BOOST_AUTO_TEST_CASE(unsatisfiable)
+{
+    std::string ranges;
+
+    BOOST_CHECK(parse("bytes=10000-", 10000, ranges) == ByteRanges::Result::Unsatisfiable);
+    BOOST_CHECK(parse("bytes=10000-10001,20000-", 10000, ranges) == ByteRanges::Result::Unsatisfiable);
+    BOOST_CHECK(parse("bytes=-0", 10000, ranges) == ByteRanges::Result::Unsatisfiable);
+
+    // an empty representation has no bytes at all
+    BOOST_CHECK(parse("bytes=0-", 0, ranges) == ByteRanges::Result::Unsatisfiable);
+    BOOST_CHECK(parse("bytes=-10", 0, ranges) == ByteRanges::Result::Unsatisfiable);
+    BOOST_CHECK(ranges.empty());
+}
+
+BOOST_AUTO_TEST_CASE(invalid)
+{
+    std::string ranges;
+
+    // invalid headers are ignored as a whole
+    BOOST_CHECK(parse("", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("bytes=", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("items=0-5", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("bytes=5-1", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("bytes=0-5,7", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("bytes=a-5", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("bytes=-", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(parse("bytes=0-1,-x", 10000, ranges) == ByteRanges::Result::Ignored);
+    BOOST_CHECK(ranges.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ifRange)
+{
+    std::time_t modified = 784111777;
+
+    BOOST_CHECK(ByteRanges::ifRangeMatches("", "\"a\"", modified));
+    BOOST_CHECK(ByteRanges::ifRangeMatches("\"a\"", "\"a\"", modified));
+    BOOST_CHECK(!ByteRanges::ifRangeMatches("\"b\"", "\"a\"", modified));
+
+    // entity tags are compared strongly
+    BOOST_CHECK(!ByteRanges::ifRangeMatches("W/\"a\"", "\"a\"", modified));
+    BOOST_CHECK(!ByteRanges::ifRangeMatches("\"a\"", "", modified));
+
+    // dates have to match exactly
+    BOOST_CHECK(ByteRanges::ifRangeMatches("Sun, 06 Nov 1994 08:49:37 GMT", "\"a\"", modified));
+    BOOST_CHECK(!ByteRanges::ifRangeMatches("Sun, 06 Nov 1994 08:49:38 GMT", "\"a\"", modified));
+    BOOST_CHECK(!ByteRanges::ifRangeMatches("yesterday", "\"a\"", modified));
+}
+
+BOOST_AUTO_TEST_CASE(contentRange)
+{
+    BOOST_CHECK_EQUAL(ByteRanges::contentRange({0, 499}, 1234), "bytes 0-499/1234");
+    BOOST_CHECK_EQUAL(ByteRanges::contentRange(1234), "bytes */1234");
+    BOOST_CHECK_EQUAL((ByteRanges::Range {10, 19}.size()), 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPCompression"
+
+#include <rgpaul/Compression.hpp>
+
+#include <string>
+
+#include "Decompress.hpp"
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+std::string json(std::size_t count)
+{
+    std::string data = "[";
+    for (std::size_t i = 0; i < count; ++i) data += "{\"id\":" + std::to_string(i) + ",\"name\":\"item\"},";
+    data.back() = ']';
+    return data;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPCompression)
+
+BOOST_AUTO_TEST_CASE(quality)
+{
+    using Encoding = Compression::Encoding;
+
+    BOOST_CHECK_EQUAL(Compression::quality("gzip, deflate, br", Encoding::Gzip), 1000);
+    BOOST_CHECK_EQUAL(Compression::quality("gzip;q=0.5, deflate", Encoding::Gzip), 500);
+    BOOST_CHECK_EQUAL(Compression::quality("GZIP ; Q=0.25", Encoding::Gzip), 250);
+    BOOST_CHECK_EQUAL(Compression::quality("x-gzip", Encoding::Gzip), 1000);
+    BOOST_CHECK_EQUAL(Compression::quality("deflate", Encoding::Gzip), 0);
+    BOOST_CHECK_EQUAL(Compression::quality("gzip;q=0", Encoding::Gzip), 0);
+
+    // the wildcard applies to the codings that aren't listed
+    BOOST_CHECK_EQUAL(Compression::quality("*;q=0.1", Encoding::Zstd), 100);
+    BOOST_CHECK_EQUAL(Compression::quality("zstd;q=0, *", Encoding::Zstd), 0);
+
+    // identity is acceptable unless it is excluded
+    BOOST_CHECK_EQUAL(Compression::quality("", Encoding::Identity), 1000);
+    BOOST_CHECK_EQUAL(Compression::quality("gzip", Encoding::Identity), 1000);
+    BOOST_CHECK_EQUAL(Compression::quality("identity;q=0", Encoding::Identity), 0);
+    BOOST_CHECK_EQUAL(Compression::quality("*;q=0", Encoding::Identity), 0);
+
+    // invalid weights are ignored
+    BOOST_CHECK_EQUAL(Compression::quality("gzip;q=2", Encoding::Gzip), 0);
+    BOOST_CHECK_EQUAL(Compression::quality("gzip;level=1", Encoding::Gzip), 0);
+}
+
+BOOST_AUTO_TEST_CASE(negotiate)
+{
+    using Encoding = Compression::Encoding;
+
+    BOOST_CHECK(Compression::negotiate("gzip, deflate", {Encoding::Gzip, Encoding::Deflate}) == Encoding::Gzip);
+    BOOST_CHECK(Compression::negotiate("gzip, deflate", {Encoding::Deflate, Encoding::Gzip}) == Encoding::Deflate);
+    BOOST_CHECK(Compression::negotiate("gzip;q=0.5, deflate", {Encoding::Gzip, Encoding::Deflate})
+                == Encoding::Deflate);
+    BOOST_CHECK(Compression::negotiate("br", {Encoding::Gzip, Encoding::Deflate}) == Encoding::Identity);
+    BOOST_CHECK(Compression::negotiate("", {Encoding::Gzip}) == Encoding::Identity);
+    BOOST_CHECK(Compression::negotiate("*", {Encoding::Gzip}) == Encoding::Gzip);
+
+    // a client that weights identity higher gets the uncompressed body - a tie goes to the compression
+    BOOST_CHECK_EQUAL(Compression::minimumQuality("gzip;q=0.5"), 0);
+    BOOST_CHECK_EQUAL(Compression::minimumQuality("gzip;q=0.1, identity"), 1000);
+    BOOST_CHECK_EQUAL(Compression::minimumQuality("gzip, *;q=0.5"), 500);
+    BOOST_CHECK(Compression::negotiate("gzip;q=0.5", {Encoding::Gzip}) == Encoding::Gzip);
+    BOOST_CHECK(Compression::negotiate("gzip;q=0.1, identity", {Encoding::Gzip}) == Encoding::Identity);
+    BOOST_CHECK(Compression::negotiate("gzip, identity", {Encoding::Gzip}) == Encoding::Gzip);
+    BOOST_CHECK(Compression::negotiate("gzip;q=0.1, identity;q=0", {Encoding::Gzip}) == Encoding::Gzip);
+
+    BOOST_CHECK_EQUAL(Compression::name(Encoding::Brotli), "br");
+    BOOST_CHECK_EQUAL(Compression::extension(Encoding::Zstd), ".zst");
+    BOOST_CHECK(Compression::extension(Encoding::Deflate).empty());
+}
+
+BOOST_AUTO_TEST_CASE(compress)
+{
+    std::string data = json(10000);
+    std::string output;
+
+    for (auto encoding : {Compression::Encoding::Gzip, Compression::Encoding::Deflate})
+    {
+        for (int level : {1, 6, 9, 6})
+        {
+            BOOST_REQUIRE(Compression::compress(data, encoding, level, output));
+            BOOST_CHECK(output.size() < data.size() / 4);
+            BOOST_CHECK(decompress(output) == data);
+        }
+    }
+
+    // the gzip and the zlib header
+    Compression::compress(data, Compression::Encoding::Gzip, 6, output);
+    BOOST_CHECK_EQUAL(static_cast<unsigned char>(output[0]), 0x1f);
+    Compression::compress(data, Compression::Encoding::Deflate, 6, output);
+    BOOST_CHECK_EQUAL(static_cast<unsigned char>(output[0]) & 0x0f, 8);
+
+    BOOST_REQUIRE(Compression::compress("", Compression::Encoding::Gzip, 6, output));
+    BOOST_CHECK(decompress(output).empty());
+
+    // brotli and zstd are only served precompressed
+    BOOST_CHECK(!Compression::compress(data, Compression::Encoding::Brotli, 6, output));
+    BOOST_CHECK(!Compression::compress(data, Compression::Encoding::Identity, 6, output));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
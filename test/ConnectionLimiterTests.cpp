@@ -0,0 +1,136 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPConnectionLimiter"
+
+#include <rgpaul/ConnectionLimiter.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+const boost::asio::ip::address kFirst = boost::asio::ip::make_address("10.0.0.1");
+const boost::asio::ip::address kSecond = boost::asio::ip::make_address("10.0.0.2");
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPConnectionLimiter)
+
+BOOST_AUTO_TEST_CASE(unlimited)
+{
+    auto limiter = std::make_shared<ConnectionLimiter>();
+    std::vector<ConnectionLimiter::Ticket> tickets;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        BOOST_REQUIRE(limiter->reserve([] { BOOST_ERROR("an unlimited acceptor is never paused"); }));
+        tickets.push_back(limiter->admit(kFirst));
+        BOOST_CHECK(tickets.back());
+    }
+
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 100);
+
+    tickets.clear();
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 0);
+    BOOST_CHECK_EQUAL(limiter->metrics().rejected, 0);
+    BOOST_CHECK_EQUAL(limiter->metrics().deferred, 0);
+}
+
+BOOST_AUTO_TEST_CASE(pauseAndResume)
+{
+    auto limiter = std::make_shared<ConnectionLimiter>(ConnectionLimiter::Limits {2, 0});
+    int resumed = 0;
+
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    ConnectionLimiter::Ticket first = limiter->admit(kFirst);
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    ConnectionLimiter::Ticket second = limiter->admit(kSecond);
+
+    // the acceptor waits until a connection is released
+    BOOST_CHECK(!limiter->reserve([&resumed] { ++resumed; }));
+    BOOST_CHECK_EQUAL(limiter->metrics().deferred, 1);
+    BOOST_CHECK_EQUAL(resumed, 0);
+
+    first = {};
+    BOOST_CHECK_EQUAL(resumed, 1);
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 1);
+
+    // a pending accept counts against the limit, a failed one gives the reservation back
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    BOOST_CHECK(!limiter->reserve([&resumed] { ++resumed; }));
+    limiter->cancel();
+    BOOST_CHECK_EQUAL(resumed, 2);
+
+    // moved tickets are released once
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    ConnectionLimiter::Ticket moved = std::move(second);
+    BOOST_CHECK(!second);
+    ConnectionLimiter::Ticket third = limiter->admit(kFirst);
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 2);
+
+    moved = std::move(third);
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 1);
+    moved = {};
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 0);
+    BOOST_CHECK_EQUAL(limiter->metrics().rejected, 0);
+}
+
+BOOST_AUTO_TEST_CASE(perAddress)
+{
+    auto limiter = std::make_shared<ConnectionLimiter>(ConnectionLimiter::Limits {3, 2});
+    int resumed = 0;
+    std::vector<ConnectionLimiter::Ticket> tickets;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        BOOST_REQUIRE(limiter->reserve(nullptr));
+        tickets.push_back(limiter->admit(kFirst));
+    }
+
+    // the third connection from the address is rejected and its reservation given back
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    BOOST_CHECK(!limiter->admit(kFirst));
+    BOOST_CHECK_EQUAL(limiter->metrics().rejected, 1);
+
+    // other addresses are only limited by the total
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    tickets.push_back(limiter->admit(kSecond));
+    BOOST_CHECK(tickets.back());
+    BOOST_CHECK(!limiter->reserve([&resumed] { ++resumed; }));
+
+    // a released connection makes room for the address again
+    tickets.erase(tickets.begin());
+    BOOST_CHECK_EQUAL(resumed, 1);
+    BOOST_REQUIRE(limiter->reserve(nullptr));
+    BOOST_CHECK(limiter->admit(kFirst));
+
+    BOOST_CHECK_EQUAL(limiter->metrics().connections, 2);
+    BOOST_CHECK_EQUAL(limiter->limits().connectionsPerAddress, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
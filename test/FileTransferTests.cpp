@@ -0,0 +1,166 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPFileTransfer"
+
+#include <rgpaul/FileTransfer.hpp>
+
+#include <string>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/beast/core/file.hpp>
+
+#if defined(__linux__)
+#include <csignal>
+#include <pthread.h>
+#endif
+
+#include "TemporaryDirectory.hpp"
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// sends the range of the file over a loopback connection and returns what arrived
+std::string transfer(const std::string& path, std::uint64_t offset, std::uint64_t size, FileTransfer::Method& method)
+{
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor acceptor(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0});
+    boost::asio::ip::tcp::socket client(ioc);
+    client.connect(acceptor.local_endpoint());
+    boost::asio::ip::tcp::socket server = acceptor.accept();
+    server.native_non_blocking(true);
+
+    std::string received(size, '\0');
+    std::thread reader([&] {
+        boost::system::error_code ec;
+        received.resize(boost::asio::read(client, boost::asio::buffer(received), ec));
+    });
+
+    boost::beast::error_code ec;
+    boost::beast::file file;
+    file.open(path.c_str(), boost::beast::file_mode::scan, ec);
+
+    FileTransfer fileTransfer(file.native_handle(), offset, size);
+    while (!fileTransfer.done())
+    {
+        fileTransfer.send(server.native_handle(), ec);
+
+        // wait until the reader made room
+        if (ec == boost::asio::error::would_block)
+            server.wait(boost::asio::ip::tcp::socket::wait_write);
+        else if (ec)
+            break;
+    }
+
+    method = fileTransfer.method();
+
+    // the reader stops early if the transfer failed
+    server.close();
+    reader.join();
+    return received;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPFileTransfer)
+
+BOOST_AUTO_TEST_CASE(send)
+{
+    std::string content;
+    for (int i = 0; i < 4 * 1024 * 1024 / 8; ++i) content += "01234567";
+    content += "end";
+
+    TemporaryDirectory directory;
+    std::string path = directory.write("content.txt", content);
+    FileTransfer::Method method;
+
+#if defined(__linux__)
+    // larger than the buffers of the socket, so the transfer has to wait for the reader
+    BOOST_CHECK(transfer(path, 0, content.size(), method) == content);
+    BOOST_CHECK(method != FileTransfer::Method::None);
+
+    BOOST_CHECK_EQUAL(transfer(path, 5, 6, method), content.substr(5, 6));
+    BOOST_CHECK_EQUAL(transfer(path, content.size() - 3, 3, method), "end");
+#else
+    // the caller has to fall back to reading the file
+    BOOST_CHECK(transfer(path, 0, content.size(), method).size() < content.size());
+    BOOST_CHECK(method == FileTransfer::Method::None);
+#endif
+}
+
+#if defined(__linux__)
+BOOST_AUTO_TEST_CASE(brokenPipe)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("content.txt", std::string(1024 * 1024, 'x'));
+
+    // the caller blocks SIGPIPE - the disposition of the process stays as it is
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    sigset_t previous;
+    pthread_sigmask(SIG_BLOCK, &signals, &previous);
+
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor acceptor(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0});
+    boost::asio::ip::tcp::socket client(ioc);
+    client.connect(acceptor.local_endpoint());
+    boost::asio::ip::tcp::socket server = acceptor.accept();
+    server.native_non_blocking(true);
+    client.close();
+
+    boost::beast::error_code ec;
+    boost::beast::file file;
+    file.open(path.c_str(), boost::beast::file_mode::scan, ec);
+
+    FileTransfer fileTransfer(file.native_handle(), 0, 1024 * 1024);
+    do
+    {
+        fileTransfer.send(server.native_handle(), ec);
+    } while (ec == boost::asio::error::would_block);
+
+    BOOST_CHECK(ec == boost::asio::error::broken_pipe || ec == boost::asio::error::connection_reset);
+
+    struct sigaction action {};
+    sigaction(SIGPIPE, nullptr, &action);
+    BOOST_CHECK(action.sa_handler == SIG_DFL);
+
+    // the signal that is pending now is discarded with the block
+    timespec timeout {};
+    sigtimedwait(&signals, nullptr, &timeout);
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    FileTransfer fileTransfer(boost::beast::file::native_handle_type {}, 0, 0);
+    BOOST_CHECK(fileTransfer.done());
+    BOOST_CHECK_EQUAL(fileTransfer.remaining(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
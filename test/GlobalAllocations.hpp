@@ -0,0 +1,85 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// replaces the global operator new and delete of a test executable to count the allocations of the heap - only one
+// test file of the executable includes it
+
+namespace
+{
+// counts every allocation of the global heap in this test
+std::atomic<std::size_t> globalAllocations {0};
+}  // namespace
+
+// not inlined - otherwise gcc warns that the memory of new is released with free
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+NOINLINE void* operator new(std::size_t size)
+{
+    ++globalAllocations;
+
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+NOINLINE void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+NOINLINE void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// the default memory resource of std::pmr uses the aligned versions
+NOINLINE void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++globalAllocations;
+
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+NOINLINE void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+NOINLINE void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
@@ -0,0 +1,129 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPHandlerMemory"
+
+#include <rgpaul/HandlerMemory.hpp>
+
+#include <chrono>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "GlobalAllocations.hpp"
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// waits for the timer again and again - like the read loop of a session
+struct TimerLoop
+{
+    boost::asio::steady_timer& timer;
+    HandlerMemory& memory;
+    int remaining;
+
+    void start()
+    {
+        timer.expires_after(std::chrono::seconds(0));
+        timer.async_wait(bindHandlerMemory(memory, [this](boost::system::error_code) {
+            if (--remaining > 0)
+                start();
+        }));
+    }
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPHandlerMemory)
+
+BOOST_AUTO_TEST_CASE(allocate)
+{
+    HandlerMemory memory;
+
+    void* first = memory.allocate(128);
+    BOOST_CHECK_EQUAL(memory.heapAllocations(), 0);
+
+    // the block is in use => the next allocation comes from the heap
+    void* second = memory.allocate(128);
+    BOOST_CHECK(first != second);
+    BOOST_CHECK_EQUAL(memory.heapAllocations(), 1);
+    memory.deallocate(second);
+
+    // the block is reused after it was released
+    memory.deallocate(first);
+    BOOST_CHECK_EQUAL(memory.allocate(64), first);
+    memory.deallocate(first);
+
+    // too large for the block
+    void* large = memory.allocate(64 * 1024);
+    BOOST_CHECK_EQUAL(memory.heapAllocations(), 2);
+    memory.deallocate(large);
+}
+
+BOOST_AUTO_TEST_CASE(allocator)
+{
+    HandlerMemory memory;
+    HandlerAllocator<int> allocator(memory);
+    HandlerAllocator<char> other(allocator);
+
+    BOOST_CHECK(allocator == other);
+    HandlerMemory otherMemory;
+    BOOST_CHECK(allocator != HandlerAllocator<int>(otherMemory));
+
+    int* value = allocator.allocate(4);
+    allocator.deallocate(value, 4);
+    BOOST_CHECK_EQUAL(memory.heapAllocations(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(asyncOperations)
+{
+    boost::asio::io_context ioc;
+    boost::asio::steady_timer timer(ioc);
+    HandlerMemory memory;
+
+    // warm up - the io_context allocates its internal structures on the first run
+    TimerLoop loop {timer, memory, 10};
+    loop.start();
+    ioc.run();
+    ioc.restart();
+
+    std::size_t allocations = globalAllocations.load();
+
+    loop.remaining = 1000;
+    loop.start();
+
+    // the pending wait uses the block
+    memory.deallocate(memory.allocate(16));
+    BOOST_CHECK_EQUAL(memory.heapAllocations(), 1);
+
+    ioc.run();
+
+    BOOST_CHECK_EQUAL(loop.remaining, 0);
+    BOOST_CHECK_EQUAL(globalAllocations.load() - allocations, 1);
+    BOOST_CHECK_EQUAL(memory.heapAllocations(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPHeaderTemplates"
+
+#include <rgpaul/HeaderTemplates.hpp>
+
+#include <ctime>
+#include <string>
+#include <thread>
+
+#include <boost/beast/http.hpp>
+#include <boost/beast/version.hpp>
+
+#include <rgpaul/StaticFileCache.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// parses a header that was assembled from a prefix and the fields
+boost::beast::http::response<boost::beast::http::string_body> parse(std::string_view prefix, std::string_view fields,
+                                                                     const std::string& body)
+{
+    std::string data = std::string(prefix) + std::string(fields) + body;
+
+    boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+    boost::beast::error_code ec;
+
+    // the parser stops after the header
+    std::size_t parsed = 0;
+    while (!ec && !parser.is_done() && parsed < data.size())
+        parsed += parser.put(boost::asio::buffer(data.data() + parsed, data.size() - parsed), ec);
+
+    BOOST_CHECK(!ec);
+    BOOST_CHECK(parser.is_done());
+
+    return parser.release();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPHeaderTemplates)
+
+BOOST_AUTO_TEST_CASE(prefix)
+{
+    std::string_view ok = HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json");
+    BOOST_CHECK_EQUAL(ok, "HTTP/1.1 200 OK\r\nServer: " BOOST_BEAST_VERSION_STRING
+                          "\r\nContent-Type: application/json\r\n");
+
+    std::string_view notFound = HeaderTemplates::prefix(boost::beast::http::status::not_found, 10, "text/plain");
+    BOOST_CHECK_EQUAL(notFound, "HTTP/1.0 404 Not Found\r\nServer: " BOOST_BEAST_VERSION_STRING
+                                "\r\nContent-Type: text/plain\r\n");
+
+    // a prefix is serialized once - every thread gets the same block
+    BOOST_CHECK(HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json").data() == ok.data());
+
+    const char* otherThread = nullptr;
+    std::thread([&otherThread] {
+        otherThread = HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json").data();
+    }).join();
+    BOOST_CHECK(otherThread == ok.data());
+
+    // the content type and the version are part of the key
+    BOOST_CHECK(HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "text/plain").data() != ok.data());
+    BOOST_CHECK(HeaderTemplates::prefix(boost::beast::http::status::ok, 10, "application/json").data() != ok.data());
+}
+
+BOOST_AUTO_TEST_CASE(boundedPrefixes)
+{
+    std::string_view ok = HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json");
+
+    // content types that are made up per response don't grow the prefixes beyond kMaxPrefixes
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < HeaderTemplates::kMaxPrefixes + 16; ++i)
+    {
+        std::string contentType = "text/x-" + std::to_string(i);
+        std::string_view prefix = HeaderTemplates::prefix(boost::beast::http::status::ok, 11, contentType);
+        if (!prefix.empty())
+        {
+            BOOST_CHECK_EQUAL(prefix, HeaderTemplates::serializePrefix(boost::beast::http::status::ok, 11, contentType));
+            ++kept;
+        }
+    }
+
+    BOOST_CHECK(kept < HeaderTemplates::kMaxPrefixes);
+    BOOST_CHECK(HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "text/x-new").empty());
+    BOOST_CHECK_EQUAL(HeaderTemplates::serializePrefix(boost::beast::http::status::ok, 10, "text/x-new"),
+                      "HTTP/1.0 200 OK\r\nServer: " BOOST_BEAST_VERSION_STRING "\r\nContent-Type: text/x-new\r\n");
+
+    // the prefixes that are kept already are still found
+    BOOST_CHECK(HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json").data() == ok.data());
+}
+
+BOOST_AUTO_TEST_CASE(date)
+{
+    std::string_view date = HeaderTemplates::date();
+    BOOST_REQUIRE_EQUAL(date.size(), 29);
+
+    std::time_t parsed = StaticFileCache::parseHttpDate(date);
+    std::time_t now = std::time(nullptr);
+    BOOST_CHECK(parsed <= now && parsed >= now - 2);
+
+    char field[HeaderTemplates::kDateFieldSize];
+    BOOST_REQUIRE_EQUAL(HeaderTemplates::writeDate(field), HeaderTemplates::kDateFieldSize);
+
+    std::string_view text(field, sizeof(field));
+    BOOST_CHECK_EQUAL(text.substr(0, 6), "Date: ");
+    BOOST_CHECK_EQUAL(text.substr(35), "\r\n");
+    BOOST_CHECK(StaticFileCache::parseHttpDate(text.substr(6, 29)) >= parsed);
+}
+
+BOOST_AUTO_TEST_CASE(fields)
+{
+    std::string_view prefix = HeaderTemplates::prefix(boost::beast::http::status::ok, 11, "application/json");
+    char fields[HeaderTemplates::kMaxFieldsSize];
+
+    std::size_t size = HeaderTemplates::writeFields(fields, 10, 11, true);
+    auto response = parse(prefix, {fields, size}, "{\"id\":\"1\"}");
+    BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_length], "10");
+    BOOST_CHECK(!response[boost::beast::http::field::date].empty());
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::connection), 0);
+    BOOST_CHECK(response.keep_alive());
+
+    // the connection field is written if it differs from the default of the version
+    size = HeaderTemplates::writeFields(fields, 0, 11, false);
+    response = parse(prefix, {fields, size}, "");
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::connection], "close");
+    BOOST_CHECK(!response.keep_alive());
+
+    std::string_view prefix10 = HeaderTemplates::prefix(boost::beast::http::status::ok, 10, "application/json");
+    size = HeaderTemplates::writeFields(fields, 0, 10, true);
+    response = parse(prefix10, {fields, size}, "");
+    BOOST_CHECK_EQUAL(response.version(), 10);
+    BOOST_CHECK(response.keep_alive());
+
+    size = HeaderTemplates::writeFields(fields, 0, 10, false);
+    BOOST_CHECK_EQUAL(parse(prefix10, {fields, size}, "").count(boost::beast::http::field::connection), 0);
+
+    // the largest set of fields still fits
+    size = HeaderTemplates::writeFields(fields, UINT64_MAX, 10, true, Compression::Encoding::Deflate,
+                                        HeaderTemplates::kVaryAccept | HeaderTemplates::kVaryAcceptEncoding);
+    BOOST_CHECK(size <= HeaderTemplates::kMaxFieldsSize);
+
+    std::string_view text(fields, size);
+    BOOST_CHECK(text.find("Content-Length: 18446744073709551615\r\n") != std::string_view::npos);
+    BOOST_CHECK(text.find("Content-Encoding: deflate\r\n") != std::string_view::npos);
+    BOOST_CHECK(text.find("Vary: Accept, Accept-Encoding\r\n") != std::string_view::npos);
+    BOOST_CHECK(text.find("Connection: keep-alive\r\n") != std::string_view::npos);
+    BOOST_CHECK_EQUAL(text.substr(text.size() - 4), "\r\n\r\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,191 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPJsonBody"
+
+#include <rgpaul/JsonBody.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <rgpaul/SessionArena.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+const std::string kDocument = R"({
+    "id": 42,
+    "user": {"name": "caf\u00e9", "active": true, "score": 9.5, "tags": null},
+    "items": [{"id": 1}, {"id": 2, "count": 18446744073709551615}, [], {}],
+    "a/b": 1,
+    "m~n": 2,
+    "": "empty"
+})";
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPJsonBody)
+
+BOOST_AUTO_TEST_CASE(pointers)
+{
+    JsonBody body(kDocument);
+    BOOST_REQUIRE(body.valid());
+
+    BOOST_CHECK_EQUAL(*body.at("/id").integer(), 42);
+    BOOST_CHECK_EQUAL(*body.at("/user/name").string(), "caf\xC3\xA9");
+    BOOST_CHECK_EQUAL(*body.at("/user/active").boolean(), true);
+    BOOST_CHECK_EQUAL(*body.at("/user/score").number(), 9.5);
+    BOOST_CHECK(body.at("/user/tags").exists());
+    BOOST_CHECK(body.at("/user/tags").isNull());
+    BOOST_CHECK_EQUAL(*body.at("/items/1/id").integer(), 2);
+
+    // escaped tokens and the empty name
+    BOOST_CHECK_EQUAL(*body.at("/a~1b").integer(), 1);
+    BOOST_CHECK_EQUAL(*body.at("/m~0n").integer(), 2);
+    BOOST_CHECK_EQUAL(*body.at("/").string(), "empty");
+    BOOST_CHECK(!body.at("/m~2n"));
+
+    // the root and relative pointers
+    BOOST_CHECK(body.at("").isObject());
+    BOOST_CHECK_EQUAL(body.root().size(), 6);
+    JsonBody::Value items = body.at("/items");
+    BOOST_CHECK(items.isArray());
+    BOOST_CHECK_EQUAL(items.size(), 4);
+    BOOST_CHECK_EQUAL(*items.at("/0/id").integer(), 1);
+    BOOST_CHECK_EQUAL(items.element(2).size(), 0);
+    BOOST_CHECK_EQUAL(items.name(), "items");
+    BOOST_CHECK_EQUAL(body.root().element(1).name(), "user");
+
+    // values that don't exist
+    BOOST_CHECK(!body.at("/missing"));
+    BOOST_CHECK(!body.at("/items/4"));
+    BOOST_CHECK(!body.at("/items/01"));
+    BOOST_CHECK(!body.at("/items/-"));
+    BOOST_CHECK(!body.at("/id/0"));
+    BOOST_CHECK(!body.at("id"));
+    BOOST_CHECK(!body.at("/missing/deeper").string());
+}
+
+BOOST_AUTO_TEST_CASE(conversions)
+{
+    JsonBody body(R"([1, -1, 2.0, 2.5, 18446744073709551615, "1", true, 1e300])");
+    BOOST_REQUIRE(body.valid());
+
+    BOOST_CHECK_EQUAL(*body.at("/0").integer(), 1);
+    BOOST_CHECK_EQUAL(*body.at("/1").integer(), -1);
+    BOOST_CHECK_EQUAL(*body.at("/2").integer(), 2);
+    BOOST_CHECK(!body.at("/3").integer());
+    BOOST_CHECK_EQUAL(*body.at("/3").number(), 2.5);
+    BOOST_CHECK(!body.at("/4").integer());
+    BOOST_CHECK_EQUAL(*body.at("/4").number(), 18446744073709551615.0);
+    BOOST_CHECK(body.at("/4").type() == JsonBody::Type::Unsigned);
+    BOOST_CHECK(!body.at("/5").integer());
+    BOOST_CHECK(!body.at("/6").string());
+    BOOST_CHECK(!body.at("/7").integer());
+}
+
+BOOST_AUTO_TEST_CASE(toJson)
+{
+    JsonBody body(kDocument);
+    BOOST_CHECK_EQUAL(body.root().toJson(), nlohmann::json::parse(kDocument));
+    BOOST_CHECK_EQUAL(body.at("/items/1").toJson(),
+                      nlohmann::json::parse(R"({"id": 2, "count": 18446744073709551615})"));
+    BOOST_CHECK(body.at("/missing").toJson().is_null());
+
+    // the first of several members with the same name is used
+    JsonBody duplicates(R"({"a": 1, "a": 2})");
+    BOOST_CHECK_EQUAL(*duplicates.at("/a").integer(), 1);
+    BOOST_CHECK_EQUAL(duplicates.root().toJson(), nlohmann::json::parse(R"({"a": 1})"));
+
+    // scalar documents
+    BOOST_CHECK_EQUAL(*JsonBody("\"text\"").root().string(), "text");
+    BOOST_CHECK(JsonBody("null").root().isNull());
+    BOOST_CHECK(JsonBody("null").valid());
+}
+
+BOOST_AUTO_TEST_CASE(invalid)
+{
+    for (std::string_view text : {"", "{", "{\"a\": }", "[1, 2", "{} {}", "\"\\uD800\"", "nul"})
+    {
+        JsonBody body(text);
+        BOOST_CHECK_MESSAGE(!body.valid(), text);
+        BOOST_CHECK(!body.error().empty());
+        BOOST_CHECK(!body.root());
+        BOOST_CHECK(!body.at(""));
+    }
+
+    // deep nesting is refused instead of exhausting the stack of toJson
+    std::string deep(JsonBody::kMaxDepth + 1, '[');
+    deep += std::string(JsonBody::kMaxDepth + 1, ']');
+    BOOST_CHECK(!JsonBody(deep).valid());
+
+    deep = std::string(JsonBody::kMaxDepth, '[') + std::string(JsonBody::kMaxDepth, ']');
+    BOOST_CHECK(JsonBody(deep).valid());
+}
+
+BOOST_AUTO_TEST_CASE(binaryFormats)
+{
+    const nlohmann::json document = nlohmann::json::parse(kDocument);
+    const std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(document);
+    const std::vector<std::uint8_t> msgpack = nlohmann::json::to_msgpack(document);
+
+    JsonBody cborBody(std::string_view(reinterpret_cast<const char*>(cbor.data()), cbor.size()),
+                      std::pmr::get_default_resource(), JsonCodec::Format::Cbor);
+    BOOST_REQUIRE(cborBody.valid());
+    BOOST_CHECK_EQUAL(*cborBody.at("/user/name").string(), "caf\xC3\xA9");
+    BOOST_CHECK(cborBody.at("/items/1/count").type() == JsonBody::Type::Unsigned);
+    BOOST_CHECK_EQUAL(cborBody.root().toJson(), document);
+
+    JsonBody msgpackBody(std::string_view(reinterpret_cast<const char*>(msgpack.data()), msgpack.size()),
+                         std::pmr::get_default_resource(), JsonCodec::Format::MessagePack);
+    BOOST_REQUIRE(msgpackBody.valid());
+    BOOST_CHECK_EQUAL(*msgpackBody.at("/user/score").number(), 9.5);
+    BOOST_CHECK_EQUAL(msgpackBody.root().toJson(), document);
+
+    // truncated documents and text that is read as CBOR are refused
+    BOOST_CHECK(!JsonBody(std::string_view(reinterpret_cast<const char*>(cbor.data()), cbor.size() - 1),
+                          std::pmr::get_default_resource(), JsonCodec::Format::Cbor)
+                     .valid());
+    BOOST_CHECK(!JsonBody(kDocument, std::pmr::get_default_resource(), JsonCodec::Format::Cbor).valid());
+}
+
+BOOST_AUTO_TEST_CASE(arena)
+{
+    SessionArena arena;
+    std::size_t blocks = arena.blockAllocations();
+
+    std::string text = "[";
+    for (int i = 0; i < 100; ++i) text += "{\"id\": " + std::to_string(i) + ", \"name\": \"item\"},";
+    text.back() = ']';
+
+    // the values are allocated from the arena
+    JsonBody body(text, &arena);
+    BOOST_CHECK(body.valid());
+    BOOST_CHECK_EQUAL(*body.at("/99/id").integer(), 99);
+    BOOST_CHECK(arena.blockAllocations() > blocks);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
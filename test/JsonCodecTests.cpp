@@ -0,0 +1,88 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPJsonCodec"
+
+#include <rgpaul/JsonCodec.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+BOOST_AUTO_TEST_SUITE(RGPJsonCodec)
+
+BOOST_AUTO_TEST_CASE(contentTypes)
+{
+    BOOST_CHECK_EQUAL(JsonCodec::contentType(JsonCodec::Format::Json), "application/json");
+    BOOST_CHECK_EQUAL(JsonCodec::contentType(JsonCodec::Format::Cbor), "application/cbor");
+    BOOST_CHECK_EQUAL(JsonCodec::contentType(JsonCodec::Format::MessagePack), "application/msgpack");
+
+    BOOST_CHECK(JsonCodec::fromContentType("application/cbor") == JsonCodec::Format::Cbor);
+    BOOST_CHECK(JsonCodec::fromContentType(" Application/CBOR ; foo=bar") == JsonCodec::Format::Cbor);
+    BOOST_CHECK(JsonCodec::fromContentType("application/msgpack") == JsonCodec::Format::MessagePack);
+    BOOST_CHECK(JsonCodec::fromContentType("application/x-msgpack") == JsonCodec::Format::MessagePack);
+    BOOST_CHECK(JsonCodec::fromContentType("application/vnd.msgpack") == JsonCodec::Format::MessagePack);
+
+    // everything else is read as text
+    BOOST_CHECK(JsonCodec::fromContentType("application/json; charset=utf-8") == JsonCodec::Format::Json);
+    BOOST_CHECK(JsonCodec::fromContentType("text/cbor") == JsonCodec::Format::Json);
+    BOOST_CHECK(JsonCodec::fromContentType("") == JsonCodec::Format::Json);
+}
+
+BOOST_AUTO_TEST_CASE(quality)
+{
+    BOOST_CHECK_EQUAL(JsonCodec::quality("", JsonCodec::Format::Cbor), 1000);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/cbor", JsonCodec::Format::Cbor), 1000);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/cbor", JsonCodec::Format::Json), 0);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/cbor;q=0.5", JsonCodec::Format::Cbor), 500);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/cbor; Q=0.125", JsonCodec::Format::Cbor), 125);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/cbor;q=0", JsonCodec::Format::Cbor), 0);
+
+    // the most specific range counts, not the highest quality
+    BOOST_CHECK_EQUAL(JsonCodec::quality("*/*, application/cbor;q=0.2", JsonCodec::Format::Cbor), 200);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/*;q=0.4, */*;q=0.9", JsonCodec::Format::Cbor), 400);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/*;q=0.4, */*;q=0.9", JsonCodec::Format::Json), 400);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("text/*, */*;q=0.1", JsonCodec::Format::MessagePack), 100);
+
+    // media type parameters before the weight and invalid weights
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/json;charset=utf-8;q=0.7", JsonCodec::Format::Json), 700);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/json;q=2, */*;q=0.1", JsonCodec::Format::Json), 100);
+    BOOST_CHECK_EQUAL(JsonCodec::quality("application/json;q=abc", JsonCodec::Format::Json), 0);
+}
+
+BOOST_AUTO_TEST_CASE(negotiate)
+{
+    BOOST_CHECK(JsonCodec::negotiate("") == JsonCodec::Format::Json);
+    BOOST_CHECK(JsonCodec::negotiate("*/*") == JsonCodec::Format::Json);
+    BOOST_CHECK(JsonCodec::negotiate("application/cbor") == JsonCodec::Format::Cbor);
+    BOOST_CHECK(JsonCodec::negotiate("application/x-msgpack") == JsonCodec::Format::MessagePack);
+    BOOST_CHECK(JsonCodec::negotiate("application/json;q=0.8, application/cbor") == JsonCodec::Format::Cbor);
+    BOOST_CHECK(JsonCodec::negotiate("application/cbor;q=0.5, application/json") == JsonCodec::Format::Json);
+    BOOST_CHECK(JsonCodec::negotiate("application/cbor, application/msgpack") == JsonCodec::Format::Cbor);
+
+    // JSON if none of the formats is acceptable
+    BOOST_CHECK(JsonCodec::negotiate("text/html") == JsonCodec::Format::Json);
+    BOOST_CHECK(JsonCodec::negotiate("application/json;q=0") == JsonCodec::Format::Json);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPJsonOutput"
+
+#include <rgpaul/JsonOutput.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <rgpaul/SessionArena.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+BOOST_AUTO_TEST_SUITE(RGPJsonOutput)
+
+BOOST_AUTO_TEST_CASE(sameAsDump)
+{
+    nlohmann::json data = {{"id", 42},
+                           {"price", 9.95},
+                           {"name", "caf\xC3\xA9 \"quoted\"\n"},
+                           {"tags", {"a", "b", nullptr, true, false}},
+                           {"nested", {{"empty", nlohmann::json::object()}, {"list", nlohmann::json::array()}}}};
+
+    for (const nlohmann::json& value : {data, nlohmann::json(), nlohmann::json(1), nlohmann::json("text")})
+    {
+        std::string output;
+        JsonOutput<std::string>::serialize(value, output);
+        BOOST_CHECK_EQUAL(output, value.dump());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(growth)
+{
+    nlohmann::json items = nlohmann::json::array();
+    for (int i = 0; i < 5000; ++i) items.push_back({{"id", i}, {"name", std::string(i % 300, 'x')}});
+    const std::string expected = items.dump();
+
+    // the string grows while it is written - the arena strings are what sendResponse uses
+    SessionArena arena;
+    {
+        ArenaStringBody::value_type output {ArenaAllocator(&arena)};
+        JsonOutput<ArenaStringBody::value_type>::serialize(items, output);
+        BOOST_CHECK(std::string_view(output.data(), output.size()) == expected);
+
+        // the serialization is appended to existing content, a reserved string is trimmed to it
+        ArenaStringBody::value_type appended {"prefix:", ArenaAllocator(&arena)};
+        appended.reserve(expected.size() * 2);
+        JsonOutput<ArenaStringBody::value_type>::serialize(items, appended);
+        BOOST_CHECK_EQUAL(appended.size(), expected.size() + 7);
+        BOOST_CHECK(std::string_view(appended.data(), appended.size()) == "prefix:" + expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(binaryFormats)
+{
+    nlohmann::json data = {{"id", -42}, {"big", UINT64_MAX}, {"price", 9.95}, {"tags", {"a", nullptr, true}}};
+    data["blob"] = nlohmann::json::binary({1, 2, 3});
+
+    std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(data);
+    std::vector<std::uint8_t> msgpack = nlohmann::json::to_msgpack(data);
+
+    std::string output;
+    JsonOutput<std::string>::serialize(data, output, JsonCodec::Format::Cbor);
+    BOOST_CHECK(output == std::string(cbor.begin(), cbor.end()));
+
+    output.clear();
+    JsonOutput<std::string>::serialize(data, output, JsonCodec::Format::MessagePack);
+    BOOST_CHECK(output == std::string(msgpack.begin(), msgpack.end()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
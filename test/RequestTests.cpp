@@ -0,0 +1,129 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPRequest"
+
+#include <rgpaul/Request.hpp>
+
+#include <string>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+BOOST_AUTO_TEST_SUITE(RGPRequest)
+
+BOOST_AUTO_TEST_CASE(query)
+{
+    QueryParameters query("/search?q=rest+server&page=2&tag=a&tag=b&empty=&flag&&x%5B%5D=%2Fy#fragment");
+
+    BOOST_REQUIRE_EQUAL(query.size(), 7);
+    BOOST_CHECK_EQUAL(query[0].key, "q");
+    BOOST_CHECK_EQUAL(query[0].value, "rest+server");
+    BOOST_CHECK(query[0].valueEncoded);
+    BOOST_CHECK(!query[1].valueEncoded);
+
+    // values without escapes are returned as views into the target
+    std::string buffer;
+    BOOST_CHECK_EQUAL(*query.value("page", buffer), "2");
+    BOOST_CHECK(buffer.empty());
+    BOOST_CHECK_EQUAL(*query.value("q", buffer), "rest server");
+    BOOST_CHECK_EQUAL(*query.get("q"), "rest+server");
+
+    // repeated keys
+    BOOST_CHECK_EQUAL(query.count("tag"), 2);
+    BOOST_CHECK_EQUAL(*query.get("tag"), "a");
+    BOOST_CHECK_EQUAL(*query.get("tag", 1), "b");
+    BOOST_CHECK(!query.get("tag", 2));
+
+    // keys without value and unknown keys
+    BOOST_CHECK(query.contains("flag"));
+    BOOST_CHECK(query.get("flag")->empty());
+    BOOST_CHECK(query.get("empty")->empty());
+    BOOST_CHECK(!query.contains("unknown"));
+    BOOST_CHECK(!query.value("unknown", buffer));
+
+    // encoded keys are compared decoded
+    BOOST_CHECK_EQUAL(*query.value("x[]", buffer), "/y");
+    BOOST_CHECK(!query.contains("x[]]"));
+    BOOST_CHECK(!query.contains("x["));
+    BOOST_CHECK_EQUAL(query[6].decodedKey(buffer), "x[]");
+}
+
+BOOST_AUTO_TEST_CASE(queryEdgeCases)
+{
+    BOOST_CHECK(QueryParameters("/path").empty());
+    BOOST_CHECK(QueryParameters("/path?").empty());
+    BOOST_CHECK(QueryParameters("").empty());
+    BOOST_CHECK_EQUAL(QueryParameters("a=1&b=2").size(), 2);
+    BOOST_CHECK_EQUAL(*QueryParameters("/p?a=1=2").get("a"), "1=2");
+
+    // invalid escapes are kept
+    std::string buffer;
+    QueryParameters::decode("100%+%zz%4", buffer);
+    BOOST_CHECK_EQUAL(buffer, "100% %zz%4");
+
+    // more parameters than fit inline
+    std::string target = "/p?";
+    for (int i = 0; i < 40; ++i) target += "k" + std::to_string(i) + "=" + std::to_string(i) + "&";
+
+    QueryParameters query(target);
+    BOOST_REQUIRE_EQUAL(query.size(), 40);
+    BOOST_CHECK_EQUAL(*query.get("k0"), "0");
+    BOOST_CHECK_EQUAL(*query.get("k39"), "39");
+    BOOST_CHECK_EQUAL(query[20].key, "k20");
+}
+
+BOOST_AUTO_TEST_CASE(lazyQueryParameters)
+{
+    Request request;
+    request.target("/search?q=1&q=2");
+
+    const QueryParameters& query = request.queryParameters();
+    BOOST_CHECK_EQUAL(query.count("q"), 2);
+
+    // the target is only tokenized once
+    BOOST_CHECK_EQUAL(&query, &request.queryParameters());
+    BOOST_CHECK(request.pathParameters().empty());
+}
+
+BOOST_AUTO_TEST_CASE(lazyJson)
+{
+    Request request;
+    request.body() = "{\"user\": {\"name\": \"test\", \"roles\": [\"admin\", \"dev\"]}}";
+
+    const JsonBody& json = request.json();
+    BOOST_CHECK(json.valid());
+    BOOST_CHECK_EQUAL(*json.at("/user/name").string(), "test");
+    BOOST_CHECK_EQUAL(*json.at("/user/roles/1").string(), "dev");
+
+    // the body is only parsed once
+    BOOST_CHECK_EQUAL(&json, &request.json());
+
+    Request invalid;
+    invalid.body() = "{\"user\":";
+    BOOST_CHECK(!invalid.json().valid());
+    BOOST_CHECK(!invalid.json().error().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,15 +24,64 @@
 
 #include <rgpaul/RestServer.hpp>
 
+#include <chrono>
 #include <memory>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <rgpaul/UrlCodec.hpp>
+
 // include this last
 #include <boost/test/included/unit_test.hpp>
 
 using namespace rgpaul;
 
+namespace
+{
+// creates random strings with runs of safe characters, escapes (some of them invalid) and arbitrary bytes
+std::vector<std::string> randomInputs()
+{
+    std::mt19937 random(4711);
+    std::vector<std::string> inputs {"", "%", "%4", "%41", "a%", "%%41", "%zz%41%4"};
+
+    const std::string alphanum = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    const std::string hex = "0123456789abcdefABCDEFgG";
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string input;
+        std::size_t length = random() % 300;
+
+        while (input.size() < length)
+        {
+            switch (random() % 8)
+            {
+                case 0:
+                    input += static_cast<char>(random() % 256);
+                    break;
+                case 1:
+                    input += '%';
+                    input += hex[random() % hex.size()];
+                    input += hex[random() % hex.size()];
+                    break;
+                case 2:
+                    input += '%';
+                    break;
+                default:
+                    for (std::size_t run = random() % 40; run > 0; --run) input += alphanum[random() % alphanum.size()];
+                    break;
+            }
+        }
+
+        inputs.push_back(input);
+    }
+
+    return inputs;
+}
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(RGPRestServer)
 
 BOOST_AUTO_TEST_CASE(constructor)
@@ -44,6 +93,117 @@ BOOST_AUTO_TEST_CASE(constructor)
     BOOST_REQUIRE(restServer);
 }
 
+BOOST_AUTO_TEST_CASE(endpoints)
+{
+    std::shared_ptr<RestServer> restServer = std::make_shared<RestServer>("127.0.0.1", 8080);
+
+    restServer->registerEndpoint("/test/{id}", [](auto, const auto&) {});
+    restServer->registerEndpoint("/test/{id}/", [](auto, const auto&) {});
+
+    BOOST_CHECK(restServer->unregisterEndpoint("/test/{id}"));
+    BOOST_CHECK(!restServer->unregisterEndpoint("/test/{id}"));
+    BOOST_CHECK(!restServer->unregisterEndpoint("/unknown"));
+}
+
+BOOST_AUTO_TEST_CASE(executionModels)
+{
+    for (auto model : {RestServer::ExecutionModel::SharedContext, RestServer::ExecutionModel::ContextPerThread})
+    {
+        auto restServer = std::make_shared<RestServer>("127.0.0.1", 0);
+        restServer->setExecutionModel(model);
+        restServer->setThreadPlacement(ThreadPlacement::onPhysicalCores());
+        restServer->registerEndpoint("/ping", [](auto session, const auto&) { session->sendResponse({{"pong", true}}); });
+        restServer->startListening(4);
+
+        BOOST_CHECK(restServer->executionModel() == model);
+        BOOST_REQUIRE_NE(restServer->port(), 0);
+
+        // every connection is answered - no matter which thread accepted it
+        boost::asio::io_context ioc;
+        for (int i = 0; i < 16; ++i)
+        {
+            boost::beast::tcp_stream stream(ioc);
+            stream.connect({boost::asio::ip::make_address("127.0.0.1"), restServer->port()});
+
+            boost::beast::http::request<boost::beast::http::empty_body> request {boost::beast::http::verb::get,
+                                                                                "/ping", 11};
+            request.set(boost::beast::http::field::host, "127.0.0.1");
+            boost::beast::http::write(stream, request);
+
+            boost::beast::flat_buffer buffer;
+            boost::beast::http::response<boost::beast::http::string_body> response;
+            boost::beast::http::read(stream, buffer, response);
+
+            BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+            BOOST_CHECK_EQUAL(response.body(), "{\"pong\":true}");
+        }
+
+        restServer->stop();
+
+        // the model can't be changed while listening
+        restServer->setExecutionModel(RestServer::ExecutionModel::SharedContext);
+        BOOST_CHECK(restServer->executionModel() == model);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(connectionLimits)
+{
+    auto restServer = std::make_shared<RestServer>("127.0.0.1", 0);
+    restServer->setConnectionLimits({1, 0});
+    restServer->registerEndpoint("/ping", [](auto session, const auto&) { session->sendResponse({{"pong", true}}); });
+    restServer->startListening(2);
+
+    boost::asio::io_context ioc;
+    const std::string ping = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    auto connect = [&] {
+        auto socket = std::make_unique<boost::asio::ip::tcp::socket>(ioc);
+        socket->connect({boost::asio::ip::make_address("127.0.0.1"), restServer->port()});
+        boost::asio::write(*socket, boost::asio::buffer(ping));
+        return socket;
+    };
+    auto receive = [](boost::asio::ip::tcp::socket& socket) {
+        boost::beast::flat_buffer buffer;
+        boost::beast::http::response<boost::beast::http::string_body> response;
+        boost::beast::error_code ec;
+        boost::beast::http::read(socket, buffer, response, ec);
+        return ec ? std::string() : response.body();
+    };
+
+    auto first = connect();
+    BOOST_CHECK_EQUAL(receive(*first), "{\"pong\":true}");
+
+    // the second connection waits in the backlog while the first one is open
+    auto second = connect();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    BOOST_CHECK_EQUAL(second->available(), 0);
+    BOOST_CHECK_EQUAL(restServer->connectionMetrics().connections, 1);
+    BOOST_CHECK_GE(restServer->connectionMetrics().deferred, 1);
+
+    first.reset();
+    BOOST_CHECK_EQUAL(receive(*second), "{\"pong\":true}");
+    second.reset();
+    restServer->stop();
+
+    // connections beyond the limit of an address are closed without an answer
+    restServer = std::make_shared<RestServer>("127.0.0.1", 0);
+    restServer->setConnectionLimits({0, 1});
+    restServer->registerEndpoint("/ping", [](auto session, const auto&) { session->sendResponse({{"pong", true}}); });
+    restServer->startListening(2);
+
+    first = connect();
+    BOOST_CHECK_EQUAL(receive(*first), "{\"pong\":true}");
+    second = connect();
+    BOOST_CHECK(receive(*second).empty());
+    BOOST_CHECK_EQUAL(restServer->connectionMetrics().rejected, 1);
+    BOOST_CHECK_EQUAL(restServer->connectionLimits().connectionsPerAddress, 1);
+
+    restServer->stop();
+
+    // the limits can't be changed while listening
+    restServer->setConnectionLimits({});
+    BOOST_CHECK_EQUAL(restServer->connectionLimits().connectionsPerAddress, 1);
+}
+
 BOOST_AUTO_TEST_CASE(urlencode)
 {
     std::string input1 = " @\\%";
@@ -52,6 +212,38 @@ BOOST_AUTO_TEST_CASE(urlencode)
 
     std::string input2 = "abcdegfhijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
     BOOST_CHECK_EQUAL(RestServer::urlEncode(input2), input2);
+
+    // caller provided buffers
+    std::string output;
+    RestServer::urlEncode(input1, output);
+    BOOST_CHECK_EQUAL(output, output1);
+
+    char buffer[64];
+    std::size_t length = RestServer::urlEncode(input1, buffer);
+    BOOST_CHECK_EQUAL(std::string(buffer, length), output1);
+}
+
+BOOST_AUTO_TEST_CASE(urlencodeKernels)
+{
+    // every kernel must produce the same result as the scalar one
+    for (const auto& input : randomInputs())
+    {
+        std::string expected(input.size() * 3, '\0');
+        expected.resize(UrlCodec::encode(input.data(), input.size(), expected.data(), UrlCodec::Kernel::scalar));
+
+        for (auto kernel : {UrlCodec::Kernel::sse2, UrlCodec::Kernel::avx2})
+        {
+            if (!UrlCodec::isSupported(kernel))
+                continue;
+
+            std::string output(input.size() * 3, '\0');
+            output.resize(UrlCodec::encode(input.data(), input.size(), output.data(), kernel));
+            BOOST_REQUIRE_EQUAL(output, expected);
+        }
+
+        BOOST_REQUIRE_EQUAL(RestServer::urlEncode(input), expected);
+        BOOST_REQUIRE_EQUAL(RestServer::urlDecode(expected), input);
+    }
 }
 
 BOOST_AUTO_TEST_CASE(urldecode)
@@ -63,6 +255,45 @@ BOOST_AUTO_TEST_CASE(urldecode)
 
     std::string input2 = "abcdegfhijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
     BOOST_CHECK_EQUAL(RestServer::urlDecode(input2), input2);
+
+    // caller provided buffers
+    std::string output;
+    RestServer::urlDecode(input1, output);
+    BOOST_CHECK_EQUAL(output, output1);
+
+    char buffer[64];
+    std::size_t length = RestServer::urlDecode(input1, buffer);
+    BOOST_CHECK_EQUAL(std::string(buffer, length), output1);
+
+    std::string inPlace = input1;
+    RestServer::urlDecodeInPlace(inPlace);
+    BOOST_CHECK_EQUAL(inPlace, output1);
+}
+
+BOOST_AUTO_TEST_CASE(urldecodeKernels)
+{
+    // every kernel must produce the same result as the scalar one - also when decoding in place
+    for (const auto& input : randomInputs())
+    {
+        std::string expected(input.size(), '\0');
+        expected.resize(UrlCodec::decode(input.data(), input.size(), expected.data(), UrlCodec::Kernel::scalar));
+
+        for (auto kernel : {UrlCodec::Kernel::sse2, UrlCodec::Kernel::avx2})
+        {
+            if (!UrlCodec::isSupported(kernel))
+                continue;
+
+            std::string output(input.size(), '\0');
+            output.resize(UrlCodec::decode(input.data(), input.size(), output.data(), kernel));
+            BOOST_REQUIRE_EQUAL(output, expected);
+
+            std::string inPlace = input;
+            inPlace.resize(UrlCodec::decode(inPlace.data(), inPlace.size(), inPlace.data(), kernel));
+            BOOST_REQUIRE_EQUAL(inPlace, expected);
+        }
+
+        BOOST_REQUIRE_EQUAL(RestServer::urlDecode(input), expected);
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
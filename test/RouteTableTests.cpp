@@ -0,0 +1,194 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPRouteTable"
+
+#include <rgpaul/RouteTable.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rgpaul/EpochReclaimer.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// counts the living instances to check that retired values get deleted
+struct Tracked
+{
+    static std::atomic<int> instances;
+
+    explicit Tracked(int value) : value(value) { ++instances; }
+    ~Tracked() { --instances; }
+
+    int value;
+};
+
+std::atomic<int> Tracked::instances {0};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPRouteTable)
+
+BOOST_AUTO_TEST_CASE(find)
+{
+    int called = 0;
+    RouteTable table({{"/", [&called](auto, const auto&) { called = 1; }},
+                      {"/users/{id}", [&called](auto, const auto&) { called = 2; }},
+                      {"/empty", nullptr}});
+
+    PathParameters parameters;
+    const Endpoint* endpoint = table.findEndpoint("/users/42", parameters);
+    BOOST_REQUIRE(endpoint);
+    BOOST_CHECK_EQUAL(endpoint->target, "/users/{id}");
+    BOOST_CHECK_EQUAL(*parameters.get("id"), "42");
+
+    endpoint->callback(nullptr, Request());
+    BOOST_CHECK_EQUAL(called, 2);
+
+    // endpoints without a callback can't be found
+    BOOST_CHECK(!table.findEndpoint("/empty", parameters));
+    BOOST_CHECK(!table.findEndpoint("/unknown", parameters));
+    BOOST_CHECK_EQUAL(table.endpoints().size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(parametersOutliveTable)
+{
+    PathParameters parameters;
+
+    // a request keeps its parameters while the table is replaced and reclaimed
+    {
+        auto table = std::make_unique<RouteTable>(
+            std::vector<Endpoint> {{"/users/{id}/posts/{post}", [](auto, const auto&) {}}});
+        BOOST_REQUIRE(table->findEndpoint("/users/42/posts/7", parameters));
+    }
+
+    BOOST_REQUIRE_EQUAL(parameters.size(), 2);
+    BOOST_CHECK_EQUAL(parameters.name(0), "id");
+    BOOST_CHECK_EQUAL(parameters.name(1), "post");
+    BOOST_CHECK_EQUAL(*parameters.get("post"), "7");
+}
+
+BOOST_AUTO_TEST_CASE(reclaim)
+{
+    {
+        RcuPointer<Tracked> pointer(std::make_unique<const Tracked>(1));
+        BOOST_CHECK_EQUAL(Tracked::instances, 1);
+
+        {
+            EpochReclaimer::ReadGuard guard;
+            const Tracked* value = pointer.load(guard);
+
+            // the reader still sees the old value after it was replaced
+            pointer.store(std::make_unique<const Tracked>(2));
+            BOOST_CHECK_EQUAL(value->value, 1);
+            BOOST_CHECK_EQUAL(Tracked::instances, 2);
+
+            // nested guards are fine
+            EpochReclaimer::ReadGuard nested;
+            BOOST_CHECK_EQUAL(pointer.load(nested)->value, 2);
+        }
+
+        // the reader has left - the old value can be deleted now
+        EpochReclaimer::instance().collect();
+        BOOST_CHECK_EQUAL(Tracked::instances, 1);
+
+        EpochReclaimer::ReadGuard guard;
+        BOOST_CHECK_EQUAL(pointer.load(guard)->value, 2);
+    }
+
+    BOOST_CHECK_EQUAL(Tracked::instances, 0);
+}
+
+BOOST_AUTO_TEST_CASE(stress)
+{
+    std::atomic<int> stableCalls {0};
+    std::vector<Endpoint> endpoints {{"/stable/{id}", [&stableCalls](auto, const auto&) { ++stableCalls; }}};
+
+    RcuPointer<RouteTable> routeTable(std::make_unique<const RouteTable>(endpoints));
+
+    std::atomic<bool> running {true};
+    std::atomic<int> misses {0};
+    std::atomic<long> lookups {0};
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&] {
+            Request request;
+            PathParameters parameters;
+
+            while (running)
+            {
+                EpochReclaimer::ReadGuard guard;
+                const RouteTable* table = routeTable.load(guard);
+
+                const Endpoint* endpoint = table->findEndpoint("/stable/7", parameters);
+                if (!endpoint || parameters[0] != "7")
+                {
+                    ++misses;
+                    continue;
+                }
+
+                endpoint->callback(nullptr, request);
+
+                // a churning endpoint is either there or not - but if it is there, it must be intact
+                const Endpoint* churn = table->findEndpoint("/churn/1", parameters);
+                if (churn && churn->target != "/churn/{n}")
+                    ++misses;
+
+                ++lookups;
+            }
+        });
+    }
+
+    // add and remove endpoints while the readers are running
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::vector<Endpoint> changed = endpoints;
+
+        if (i % 2 == 0)
+            changed.push_back({"/churn/{n}", [](auto, const auto&) {}});
+
+        for (int j = 0; j < i % 10; ++j) changed.push_back({"/extra/" + std::to_string(j), [](auto, const auto&) {}});
+
+        routeTable.store(std::make_unique<const RouteTable>(std::move(changed)));
+    }
+
+    running = false;
+    for (auto& reader : readers) reader.join();
+
+    BOOST_CHECK_EQUAL(misses, 0);
+    BOOST_CHECK_EQUAL(stableCalls, lookups);
+
+    // no reader is left, so all replaced tables must be deleted now
+    EpochReclaimer::instance().collect();
+    BOOST_CHECK_EQUAL(EpochReclaimer::instance().pendingCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
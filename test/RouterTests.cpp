@@ -0,0 +1,227 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPRouter"
+
+#include <rgpaul/Router.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rgpaul/UriNode.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+BOOST_AUTO_TEST_SUITE(RGPRouter)
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    Router router;
+    BOOST_CHECK_EQUAL(router.findRoute("/"), Router::npos);
+
+    Router router2(std::vector<std::string> {});
+    BOOST_CHECK_EQUAL(router2.findRoute("/"), Router::npos);
+    BOOST_CHECK_EQUAL(router2.findRoute("/test"), Router::npos);
+}
+
+BOOST_AUTO_TEST_CASE(find)
+{
+    Router router({"/", "/test1", "/test1/test2/test3", "/test1/test3", "fail", "/test/$/detail", "/$/t1"});
+
+    BOOST_CHECK_EQUAL(router.findRoute("/"), 0);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1"), 1);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1/test2/test3"), 2);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1/test3"), 3);
+    BOOST_CHECK_EQUAL(router.findRoute("/test/123/detail"), 5);
+    BOOST_CHECK_EQUAL(router.findRoute("/123/t1"), 6);
+
+    // intermediate nodes without a route and unknown paths
+    BOOST_CHECK_EQUAL(router.findRoute("/test1/test2"), Router::npos);
+    BOOST_CHECK_EQUAL(router.findRoute("/test2"), Router::npos);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1/test"), Router::npos);
+    BOOST_CHECK_EQUAL(router.findRoute("/test/123"), Router::npos);
+    BOOST_CHECK_EQUAL(router.findRoute("/test/123/detail/more"), Router::npos);
+
+    // patterns and targets must be absolute
+    BOOST_CHECK_EQUAL(router.findRoute("fail"), Router::npos);
+    BOOST_CHECK_EQUAL(router.findRoute(""), Router::npos);
+}
+
+BOOST_AUTO_TEST_CASE(normalization)
+{
+    Router router({"/", "/test1/", "/test/$/detail"});
+
+    BOOST_CHECK_EQUAL(router.findRoute("/?a=b"), 0);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1"), 1);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1/"), 1);
+    BOOST_CHECK_EQUAL(router.findRoute("/test1?x=/y"), 1);
+    BOOST_CHECK_EQUAL(router.findRoute("/test/abc/detail/?id=5"), 2);
+
+    BOOST_CHECK_EQUAL(Router::normalizePath("/a/b/?c"), "/a/b");
+    BOOST_CHECK_EQUAL(Router::normalizePath("/"), "/");
+}
+
+BOOST_AUTO_TEST_CASE(placeholder)
+{
+    Router router({"/users/$", "/users/me", "/users/me/settings", "/users/$/posts", "/$"});
+
+    // static segments take precedence over the placeholder
+    BOOST_CHECK_EQUAL(router.findRoute("/users/me"), 1);
+    BOOST_CHECK_EQUAL(router.findRoute("/users/you"), 0);
+    BOOST_CHECK_EQUAL(router.findRoute("/users/me/settings"), 2);
+
+    // the placeholder is used if the static segment doesn't lead to a route
+    BOOST_CHECK_EQUAL(router.findRoute("/users/me/posts"), 3);
+    BOOST_CHECK_EQUAL(router.findRoute("/users/m"), 0);
+    BOOST_CHECK_EQUAL(router.findRoute("/users/mex"), 0);
+
+    // the placeholder matches whole segments only
+    BOOST_CHECK_EQUAL(router.findRoute("/users"), 4);
+    BOOST_CHECK_EQUAL(router.findRoute("/users/1/2"), Router::npos);
+
+    // the root has no segment that could be matched by "/$"
+    BOOST_CHECK_EQUAL(router.findRoute("/"), Router::npos);
+
+    // a "$" inside of a segment is no placeholder
+    Router router2({"/a$b"});
+    BOOST_CHECK_EQUAL(router2.findRoute("/a$b"), 0);
+    BOOST_CHECK_EQUAL(router2.findRoute("/axb"), Router::npos);
+}
+
+BOOST_AUTO_TEST_CASE(parameters)
+{
+    Router router({"/users/{id}", "/users/{id}/posts/$", "/users/me", "/files/{name}/", "/"});
+    PathParameters parameters;
+
+    BOOST_CHECK_EQUAL(router.findRoute("/users/42", parameters), 0);
+    BOOST_REQUIRE_EQUAL(parameters.size(), 1);
+    BOOST_CHECK_EQUAL(parameters[0], "42");
+    BOOST_CHECK_EQUAL(parameters.name(0), "id");
+    BOOST_REQUIRE(parameters.get("id"));
+    BOOST_CHECK_EQUAL(*parameters.get("id"), "42");
+    BOOST_CHECK(!parameters.get("name"));
+
+    // unnamed placeholders are only accessible by position
+    BOOST_CHECK_EQUAL(router.findRoute("/users/me/posts/7?sort=asc", parameters), 1);
+    BOOST_REQUIRE_EQUAL(parameters.size(), 2);
+    BOOST_CHECK_EQUAL(parameters[0], "me");
+    BOOST_CHECK_EQUAL(parameters[1], "7");
+    BOOST_CHECK_EQUAL(*parameters.get("id"), "me");
+    BOOST_CHECK(parameters.name(1).empty());
+    BOOST_CHECK(parameters[2].empty());
+
+    // static endpoints don't have parameters
+    BOOST_CHECK_EQUAL(router.findRoute("/users/me", parameters), 2);
+    BOOST_CHECK(parameters.empty());
+    BOOST_CHECK(!parameters.get("id"));
+
+    BOOST_CHECK_EQUAL(router.findRoute("/files/index.html/", parameters), 3);
+    BOOST_CHECK_EQUAL(*parameters.get("name"), "index.html");
+
+    // a failed lookup leaves no parameters behind
+    BOOST_CHECK_EQUAL(router.findRoute("/users/42/comments", parameters), Router::npos);
+    BOOST_CHECK(parameters.empty());
+}
+
+BOOST_AUTO_TEST_CASE(invalidPatterns)
+{
+    std::string tooManyPlaceholders;
+    for (std::size_t i = 0; i <= PathParameters::kCapacity; ++i) tooManyPlaceholders += "/$";
+
+    BOOST_CHECK(!Router::isValidPattern(tooManyPlaceholders));
+    BOOST_CHECK(!Router::isValidPattern("test"));
+    BOOST_CHECK(!Router::isValidPattern(""));
+    BOOST_CHECK(Router::isValidPattern("/"));
+    BOOST_CHECK(Router::isValidPattern("/a/{b}/$"));
+
+    // the names are copied into the parameters
+    BOOST_CHECK(!Router::isValidPattern("/{" + std::string(PathParameters::kNameCapacity + 1, 'n') + "}"));
+    BOOST_CHECK(Router::isValidPattern("/{" + std::string(PathParameters::kNameCapacity, 'n') + "}"));
+
+    Router router({tooManyPlaceholders, "/ok"});
+    BOOST_CHECK_EQUAL(router.findRoute(tooManyPlaceholders), Router::npos);
+    BOOST_CHECK_EQUAL(router.findRoute("/ok"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(duplicates)
+{
+    Router router({"/test", "/test/"});
+    BOOST_CHECK_EQUAL(router.findRoute("/test"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(compareWithUriNode)
+{
+    std::vector<std::string> patterns;
+    std::vector<std::string> targets;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        std::string id = std::to_string(i);
+        switch (i % 4)
+        {
+            case 0:
+                patterns.push_back("/api/r" + id);
+                break;
+            case 1:
+                patterns.push_back("/api/r" + id + "/$");
+                break;
+            case 2:
+                patterns.push_back("/api/r" + id + "/$/items");
+                break;
+            default:
+                patterns.push_back("/s" + std::to_string(i % 7) + "/r" + id + "/x/$");
+                break;
+        }
+
+        targets.push_back("/api/r" + id);
+        targets.push_back("/api/r" + id + "/42");
+        targets.push_back("/api/r" + id + "/42/items");
+        targets.push_back("/api/r" + id + "/42/items/");
+        targets.push_back("/s" + std::to_string(i % 7) + "/r" + id + "/x/abc");
+        targets.push_back("/s" + std::to_string(i % 7) + "/r" + id + "/x");
+    }
+
+    std::shared_ptr<UriNode> rootNode = UriNode::createRootNode();
+    for (std::size_t i = 0; i < patterns.size(); ++i)
+    {
+        std::shared_ptr<UriNode> node = rootNode->createNodeForPath(RestServer::splitUri(patterns[i]));
+        BOOST_REQUIRE(node);
+        node->setCallback([i](auto, const auto&) {});
+    }
+
+    Router router(patterns);
+
+    // both implementations must agree whether there is an endpoint for a target
+    for (const auto& target : targets)
+    {
+        std::shared_ptr<UriNode> node = rootNode->findNodeForPath(RestServer::splitUri(target));
+        bool uriNodeFound = node && node->callback();
+
+        BOOST_CHECK_MESSAGE(uriNodeFound == (router.findRoute(target) != Router::npos), target);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,1152 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPSession"
+
+#include <rgpaul/Session.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/version.hpp>
+
+#include <rgpaul/EpochReclaimer.hpp>
+#include <rgpaul/HeaderTemplates.hpp>
+#include <rgpaul/RestServer.hpp>
+
+#include "Decompress.hpp"
+#include "TemporaryDirectory.hpp"
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// a session on a loopback connection - the server is only used for routing, the session runs on its own io_context
+class Connection
+{
+  public:
+    explicit Connection(std::shared_ptr<RestServer> server) : _acceptor(_ioc, {boost::asio::ip::make_address("127.0.0.1"), 0})
+    {
+        _client.connect(_acceptor.local_endpoint());
+        std::make_shared<Session>(_acceptor.accept(), server)->run();
+        _thread = std::thread([this] { _ioc.run(); });
+    }
+
+    ~Connection()
+    {
+        boost::system::error_code ec;
+        _client.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        _client.close(ec);
+        _thread.join();
+    }
+
+    void send(const std::string& data) { boost::asio::write(_client, boost::asio::buffer(data)); }
+
+    boost::beast::http::response<boost::beast::http::string_body> receive()
+    {
+        boost::beast::http::response<boost::beast::http::string_body> response;
+        boost::beast::http::read(_client, _buffer, response);
+        return response;
+    }
+
+    //! reads a response in two steps - e.g. to check that the header arrives before the body is complete
+    void receiveHeader(boost::beast::http::response_parser<boost::beast::http::string_body>& parser)
+    {
+        boost::beast::http::read_header(_client, _buffer, parser);
+    }
+
+    void receive(boost::beast::http::response_parser<boost::beast::http::string_body>& parser)
+    {
+        boost::beast::http::read(_client, _buffer, parser);
+    }
+
+    //! true if the server closed the connection without sending anything else
+    bool closedByServer()
+    {
+        boost::system::error_code ec;
+        char byte;
+        std::size_t size = _buffer.size() + boost::asio::read(_client, boost::asio::buffer(&byte, 1), ec);
+        return size == 0 && ec == boost::asio::error::eof;
+    }
+
+  private:
+    boost::asio::io_context _ioc;
+    boost::asio::ip::tcp::acceptor _acceptor;
+    boost::asio::ip::tcp::socket _client {_ioc};
+    boost::beast::flat_buffer _buffer;
+    std::thread _thread;
+};
+
+std::shared_ptr<RestServer> makeServer(std::size_t pipelineDepth)
+{
+    auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+    server->setMaxPipelineDepth(pipelineDepth);
+    server->registerEndpoint("/echo/{id}", [](std::shared_ptr<Session> session, const Request& request) {
+        session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+    });
+
+    // publishes the endpoints - without threads the server itself never accepts a connection
+    server->startListening(0);
+
+    return server;
+}
+
+std::string request(const std::string& target, bool keepAlive = true)
+{
+    return "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n" + (keepAlive ? "" : "Connection: close\r\n") + "\r\n";
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPSession)
+
+BOOST_AUTO_TEST_CASE(keepAlive)
+{
+    Connection connection(makeServer(16));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        connection.send(request("/echo/" + std::to_string(i)));
+        auto response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+        BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"" + std::to_string(i) + "\"}");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pipelining)
+{
+    // more requests than the pipeline holds, so they are processed in several batches
+    for (std::size_t depth : {1, 4, 16})
+    {
+        Connection connection(makeServer(depth));
+
+        std::string requests;
+        for (int i = 0; i < 50; ++i) requests += request(i % 7 == 3 ? "/unknown" : "/echo/" + std::to_string(i));
+        connection.send(requests);
+
+        // the responses arrive in the order of the requests
+        for (int i = 0; i < 50; ++i)
+        {
+            auto response = connection.receive();
+
+            if (i % 7 == 3)
+                BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::not_found);
+            else
+                BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"" + std::to_string(i) + "\"}");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pipeliningSplitRequest)
+{
+    Connection connection(makeServer(16));
+
+    // the second request is incomplete - it has to be finished by the next read
+    std::string second = request("/echo/2");
+    connection.send(request("/echo/1") + second.substr(0, 10));
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+
+    connection.send(second.substr(10));
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"2\"}");
+}
+
+BOOST_AUTO_TEST_CASE(pipeliningClose)
+{
+    Connection connection(makeServer(16));
+
+    // nothing is answered after the request that closes the connection
+    connection.send(request("/echo/1") + request("/echo/2", false) + request("/echo/3"));
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"2\"}");
+    BOOST_CHECK(!response.keep_alive());
+    BOOST_CHECK(connection.closedByServer());
+}
+
+BOOST_AUTO_TEST_CASE(headerTemplates)
+{
+    Connection connection(makeServer(16));
+
+    connection.send(request("/echo/1") + request("/unknown"));
+
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::server], BOOST_BEAST_VERSION_STRING);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_length], "10");
+    BOOST_CHECK(StaticFileCache::parseHttpDate(std::string(response[boost::beast::http::field::date])) > 0);
+    BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"1\"}");
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::not_found);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_length], std::to_string(response.body().size()));
+
+    // HTTP/1.0 clients are answered with 1.0 - keep-alive has to be confirmed
+    connection.send("GET /echo/2 HTTP/1.0\r\nConnection: keep-alive\r\n\r\nGET /echo/3 HTTP/1.0\r\n\r\n");
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.version(), 10);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::connection], "keep-alive");
+    BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"2\"}");
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"3\"}");
+    BOOST_CHECK(connection.closedByServer());
+}
+
+BOOST_AUTO_TEST_CASE(serializedBody)
+{
+    nlohmann::json items = nlohmann::json::array();
+    for (int i = 0; i < 20000; ++i) items.push_back({{"id", i}, {"name", "item \"" + std::to_string(i) + "\""}});
+    const std::string cached = items.dump();
+
+    auto server = makeServer(16);
+    server->registerEndpoint("/items", [&items](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse(items);
+    });
+    server->registerEndpoint("/cached", [&cached](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse(cached, "application/json");
+    });
+    server->registerEndpoint(
+        "/text", [](std::shared_ptr<Session> session, const Request&) { session->sendResponse("plain", "text/plain"); },
+        EndpointOptions {true});
+
+    Connection connection(server);
+    connection.send(request("/items") + request("/cached") + request("/text") + request("/echo/1"));
+
+    // the body that was serialized into the memory of the session is the same as the one of dump
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_length], std::to_string(cached.size()));
+    BOOST_CHECK(response.body() == cached);
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+    BOOST_CHECK(response.body() == cached);
+
+    // answered by a worker thread - the body is copied before it is passed to the session
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "text/plain");
+    BOOST_CHECK_EQUAL(response.body(), "plain");
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+}
+
+BOOST_AUTO_TEST_CASE(dynamicContentTypes)
+{
+    auto server = makeServer(16);
+    server->registerEndpoint("/typed/{type}", [](std::shared_ptr<Session> session, const Request& request) {
+        std::string type(request.pathParameters().get("type").value_or(""));
+        session->sendResponse(type, "text/x-" + type);
+    });
+
+    // more content types than HeaderTemplates keeps - the others get a prefix of their own
+    Connection connection(server);
+    for (std::size_t i = 0; i < HeaderTemplates::kMaxPrefixes + 8; ++i)
+    {
+        std::string type = "dynamic" + std::to_string(i);
+        connection.send(request("/typed/" + type));
+
+        auto response = connection.receive();
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "text/x-" + type);
+        BOOST_CHECK_EQUAL(response.body(), type);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(binaryJson)
+{
+    const nlohmann::json data = {{"id", 42}, {"names", {"a", "b"}}, {"price", 9.5}};
+
+    // the negotiation is opted into
+    auto server = makeServer(16);
+    BOOST_CHECK(!server->binaryJson());
+    server->setBinaryJson(true);
+    server->registerEndpoint("/data", [&data](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse(data);
+    });
+    server->registerEndpoint("/sum", [](std::shared_ptr<Session> session, const Request& request) {
+        const JsonBody& body = request.json();
+        if (!body.valid())
+            return session->sendBadRequest(body.error());
+        session->sendResponse({{"sum", *body.at("/a").integer() + *body.at("/b").integer()}});
+    });
+
+    Connection connection(server);
+    auto get = [](const std::string& target, const std::string& accept) {
+        return "GET " + target + " HTTP/1.1\r\nAccept: " + accept + "\r\n\r\n";
+    };
+
+    connection.send(get("/data", "application/cbor") + get("/data", "application/json, application/msgpack;q=0.5")
+                    + get("/data", "application/x-msgpack, application/json;q=0.9") + get("/data", "*/*")
+                    + get("/data", "text/html"));
+
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/cbor");
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::vary], "Accept");
+    BOOST_CHECK_EQUAL(nlohmann::json::from_cbor(response.body()), data);
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+    BOOST_CHECK(response.body() == data.dump());
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/msgpack");
+    BOOST_CHECK_EQUAL(nlohmann::json::from_msgpack(response.body()), data);
+
+    // JSON if the client doesn't prefer a format or accepts none of them
+    for (int i = 0; i < 2; ++i)
+    {
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+        BOOST_CHECK(response.body() == data.dump());
+    }
+
+    // request bodies are decoded according to their Content-Type
+    auto post = [](const std::string& contentType, const std::vector<std::uint8_t>& body) {
+        return "POST /sum HTTP/1.1\r\nContent-Type: " + contentType + "\r\nContent-Length: "
+               + std::to_string(body.size()) + "\r\n\r\n" + std::string(body.begin(), body.end());
+    };
+    const nlohmann::json summands = {{"a", 40}, {"b", 2}};
+    const std::string text = summands.dump();
+
+    connection.send(post("application/cbor", nlohmann::json::to_cbor(summands))
+                    + post("application/msgpack", nlohmann::json::to_msgpack(summands))
+                    + post("application/json; charset=utf-8", std::vector<std::uint8_t>(text.begin(), text.end()))
+                    + post("application/cbor", std::vector<std::uint8_t>(text.begin(), text.end())));
+
+    for (int i = 0; i < 3; ++i) BOOST_CHECK_EQUAL(connection.receive().body(), "{\"sum\":42}");
+    BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::bad_request);
+
+    // without the negotiation the responses don't depend on Accept
+    server->setBinaryJson(false);
+    Connection textConnection(server);
+    textConnection.send(get("/data", "application/cbor"));
+
+    response = textConnection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/json");
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::vary), 0);
+    BOOST_CHECK(response.body() == data.dump());
+}
+
+BOOST_AUTO_TEST_CASE(offload)
+{
+    std::mutex threadsMutex;
+    std::thread::id sessionThread;
+    std::set<std::thread::id> workerThreads;
+
+    auto server = makeServer(16);
+    server->setWorkerThreads(2);
+    server->registerEndpoint("/inline/{id}", [&](std::shared_ptr<Session> session, const Request& request) {
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            sessionThread = std::this_thread::get_id();
+        }
+
+        session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+    });
+    server->registerEndpoint(
+        "/offload/{id}",
+        [&](std::shared_ptr<Session> session, const Request& request) {
+            {
+                std::lock_guard<std::mutex> lock(threadsMutex);
+                workerThreads.insert(std::this_thread::get_id());
+            }
+
+            // the slow handler must not delay the inline handlers of other sessions and mustn't reorder responses
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+        },
+        EndpointOptions {true});
+
+    Connection connection(server);
+
+    std::string requests;
+    for (int i = 0; i < 20; ++i) requests += request((i % 2 ? "/offload/" : "/inline/") + std::to_string(i));
+    connection.send(requests);
+
+    for (int i = 0; i < 20; ++i)
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"" + std::to_string(i) + "\"}");
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    BOOST_CHECK(!workerThreads.empty());
+    BOOST_CHECK(workerThreads.find(sessionThread) == workerThreads.end());
+    BOOST_CHECK_EQUAL(server->workerMetrics().queueDepths.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(offloadRouteChange)
+{
+    std::promise<void> entered;
+    std::promise<void> republished;
+
+    auto server = makeServer(16);
+    server->setWorkerThreads(1);
+    server->registerEndpoint(
+        "/offload/{id}",
+        [&](std::shared_ptr<Session> session, const Request& request) {
+            entered.set_value();
+            republished.get_future().wait();
+
+            // the route table that matched the request may be gone by now
+            session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))},
+                                   {"name", std::string(request.pathParameters().name(0))}});
+        },
+        EndpointOptions {true});
+
+    Connection connection(server);
+    connection.send(request("/offload/42"));
+    entered.get_future().wait();
+
+    // the old table is retired and reclaimed while the worker still answers its request
+    server->registerEndpoint("/other", [](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse({});
+    });
+    EpochReclaimer::instance().collect();
+    republished.set_value();
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"42\",\"name\":\"id\"}");
+}
+
+BOOST_AUTO_TEST_CASE(offloadThrows)
+{
+    auto server = makeServer(16);
+    server->setWorkerThreads(1);
+    server->registerEndpoint(
+        "/offload/{id}",
+        [](std::shared_ptr<Session> session, const Request& request) {
+            std::string id(request.pathParameters().get("id").value_or(""));
+
+            if (id != "fails")
+                session->sendResponse({{"id", id}});
+
+            if (id == "answered" || id == "fails")
+                throw std::runtime_error("failed");
+        },
+        EndpointOptions {true});
+
+    Connection connection(server);
+
+    // the single worker answers the second request only after the first one threw - the error mustn't answer it
+    connection.send(request("/offload/answered") + request("/offload/next") + request("/offload/fails"));
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"answered\"}");
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"next\"}");
+    BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::internal_server_error);
+}
+
+BOOST_AUTO_TEST_CASE(streamBody)
+{
+    std::mutex chunksMutex;
+    std::size_t chunks = 0;
+    std::string received;
+
+    auto server = makeServer(16);
+    server->setBodyLimit(1024);
+
+    StreamCallbacks callbacks;
+    callbacks.body = [&](std::shared_ptr<Session> session, const Request&, std::string_view chunk, bool last) {
+        std::lock_guard<std::mutex> lock(chunksMutex);
+        ++chunks;
+        received += chunk;
+
+        if (last)
+            session->sendResponse({{"size", received.size()}});
+    };
+    server->registerStreamingEndpoint("/upload", callbacks, EndpointOptions {false, 1024 * 1024});
+
+    Connection connection(server);
+
+    // the body is larger than the chunks and the server wide limit
+    std::string body(200 * 1024, 'x');
+    connection.send("POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: " + std::to_string(body.size())
+                    + "\r\n\r\n" + body);
+
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+    BOOST_CHECK_EQUAL(response.body(), "{\"size\":" + std::to_string(body.size()) + "}");
+
+    {
+        std::lock_guard<std::mutex> lock(chunksMutex);
+        BOOST_CHECK(chunks > 1);
+        BOOST_CHECK(received == body);
+        received.clear();
+    }
+
+    // chunked transfer encoding - the connection is still usable
+    connection.send("POST /upload HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+                    "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n");
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"size\":11}");
+
+    connection.send(request("/echo/1"));
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    BOOST_CHECK_EQUAL(received, "hello world");
+}
+
+BOOST_AUTO_TEST_CASE(bodyLimit)
+{
+    auto server = makeServer(16);
+    server->setBodyLimit(16);
+    server->registerEndpoint(
+        "/large", [](std::shared_ptr<Session> session, const Request& request) {
+            session->sendResponse({{"size", request.body().size()}});
+        },
+        EndpointOptions {false, 64});
+
+    std::string body(32, 'x');
+    auto post = [&](const std::string& target) {
+        return "POST " + target + " HTTP/1.1\r\nHost: localhost\r\nContent-Length: " + std::to_string(body.size())
+               + "\r\n\r\n" + body;
+    };
+
+    // the route has a larger limit than the server
+    {
+        Connection connection(server);
+        connection.send(post("/large") + post("/large"));
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"size\":32}");
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"size\":32}");
+    }
+
+    // the body isn't read - the connection is closed
+    {
+        Connection connection(server);
+        connection.send(post("/echo/1"));
+        auto response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::payload_too_large);
+        BOOST_CHECK(!response.keep_alive());
+    }
+
+    // the size of a chunked body is only known while it is read
+    {
+        Connection connection(server);
+        connection.send("POST /echo/1 HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n20\r\n" + body
+                        + "\r\n0\r\n\r\n");
+        BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::payload_too_large);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(timeouts)
+{
+    using namespace std::chrono_literals;
+
+    auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+    server->setTimeouts({300ms, 300ms, 3s, 3s});
+    server->registerEndpoint("/echo", [](std::shared_ptr<Session> session, const Request& request) {
+        session->sendResponse({{"size", request.body().size()}});
+    });
+    server->registerEndpoint(
+        "/slow", [](std::shared_ptr<Session> session, const Request& request) {
+            session->sendResponse({{"size", request.body().size()}});
+        },
+        EndpointOptions {false, 0, true, 300ms});
+    server->startListening(0);
+
+    // a keep-alive connection is closed once it was idle for too long
+    {
+        Connection connection(server);
+        connection.send(request("/echo"));
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"size\":0}");
+
+        auto start = std::chrono::steady_clock::now();
+        BOOST_CHECK(connection.closedByServer());
+        BOOST_CHECK(std::chrono::steady_clock::now() - start >= 300ms);
+    }
+
+    // the header doesn't arrive in time
+    {
+        Connection connection(server);
+        connection.send("GET /echo HTTP/1.1\r\nHost: loc");
+        BOOST_CHECK(connection.closedByServer());
+    }
+
+    // the body timeout of the route is shorter than the one of the server
+    {
+        Connection connection(server);
+        connection.send("POST /slow HTTP/1.1\r\nHost: localhost\r\nContent-Length: 8\r\n\r\n1234");
+        BOOST_CHECK(connection.closedByServer());
+    }
+
+    {
+        Connection connection(server);
+        auto start = std::chrono::steady_clock::now();
+        connection.send("POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 8\r\n\r\n1234");
+        std::this_thread::sleep_for(500ms);
+        connection.send("5678");
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"size\":8}");
+        BOOST_CHECK(std::chrono::steady_clock::now() - start >= 500ms);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(accessLog)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.path("access.log");
+    auto log = std::make_shared<AccessLog>(path);
+
+    auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+    server->setAccessLog(log);
+    server->registerEndpoint("/echo/{id}", [](std::shared_ptr<Session> session, const Request& request) {
+        session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+    });
+    server->startListening(0);
+
+    // pipelined responses that are written together are recorded one by one - the last one closes the connection
+    {
+        Connection connection(server);
+        connection.send(request("/echo/1") + request("/unknown") + request("/echo/2", false));
+        BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::ok);
+        BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::not_found);
+        BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::ok);
+        BOOST_CHECK(connection.closedByServer());
+    }
+
+    log->flush();
+    std::vector<AccessLog::Record> records = AccessLog::read(path);
+
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_CHECK_EQUAL(records[0].status, 200);
+    BOOST_CHECK_EQUAL(records[0].route, 0);
+    BOOST_CHECK_EQUAL(records[1].status, 404);
+    BOOST_CHECK_EQUAL(records[1].route, Request::kNoRoute);
+    BOOST_CHECK_EQUAL(records[2].status, 200);
+
+    for (const auto& record : records)
+    {
+        BOOST_CHECK_EQUAL(AccessLog::address(record), boost::asio::ip::make_address("127.0.0.1"));
+        BOOST_CHECK_EQUAL(record.method, static_cast<std::uint8_t>(boost::beast::http::verb::get));
+        BOOST_CHECK(record.bytes > 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(expectContinue)
+{
+    auto server = makeServer(16);
+
+    StreamCallbacks callbacks;
+    callbacks.header = [](std::shared_ptr<Session> session, const Request& request) {
+        if (request.find(boost::beast::http::field::authorization) != request.end())
+            return true;
+
+        session->sendBadRequest("unauthorized");
+        return false;
+    };
+    callbacks.body = [](std::shared_ptr<Session> session, const Request&, std::string_view chunk, bool last) {
+        if (last)
+            session->sendResponse({{"last", std::string(chunk)}});
+    };
+    server->registerStreamingEndpoint("/upload", callbacks);
+
+    std::string header = "POST /upload HTTP/1.1\r\nHost: localhost\r\nExpect: 100-continue\r\nContent-Length: 4\r\n";
+
+    // the client only sends the body after the interim response
+    {
+        Connection connection(server);
+        connection.send(header + "Authorization: x\r\n\r\n");
+        BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::continue_);
+
+        connection.send("data");
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"last\":\"data\"}");
+    }
+
+    // rejected before the body was sent
+    {
+        Connection connection(server);
+        connection.send(header + "\r\n");
+        auto response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::bad_request);
+        BOOST_CHECK(!response.keep_alive());
+        BOOST_CHECK(connection.closedByServer());
+    }
+
+    // buffered endpoints get the interim response as well
+    {
+        Connection connection(server);
+        connection.send("POST /echo/1 HTTP/1.1\r\nHost: localhost\r\nExpect: 100-continue\r\n"
+                        "Content-Length: 2\r\n\r\n");
+        BOOST_CHECK_EQUAL(connection.receive().result(), boost::beast::http::status::continue_);
+
+        connection.send("{}");
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pauseBody)
+{
+    std::mutex chunksMutex;
+    std::size_t received = 0;
+    std::thread resumer;
+
+    auto server = makeServer(16);
+
+    // every chunk is acknowledged by another thread before the next one is read
+    StreamCallbacks callbacks;
+    callbacks.body = [&](std::shared_ptr<Session> session, const Request&, std::string_view chunk, bool last) {
+        std::lock_guard<std::mutex> lock(chunksMutex);
+        received += chunk.size();
+
+        if (last)
+            return session->sendResponse({{"size", received}});
+
+        session->pauseBody();
+        if (resumer.joinable())
+            resumer.join();
+        resumer = std::thread([session] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            session->resumeBody();
+        });
+    };
+    server->registerStreamingEndpoint("/upload", callbacks, EndpointOptions {false, 1024 * 1024});
+
+    Connection connection(server);
+
+    std::string body(512 * 1024, 'x');
+    connection.send("POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: " + std::to_string(body.size())
+                    + "\r\n\r\n" + body);
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"size\":" + std::to_string(body.size()) + "}");
+
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    if (resumer.joinable())
+        resumer.join();
+}
+
+BOOST_AUTO_TEST_CASE(streamResponse)
+{
+    std::thread producer;
+    std::promise<void> headerReceived;
+
+    auto server = makeServer(16);
+
+    // the producer waits for the drained callback whenever the queue of the session is full
+    server->registerEndpoint("/export", [&](std::shared_ptr<Session> session, const Request&) {
+        auto state = std::make_shared<std::pair<std::mutex, std::condition_variable>>();
+        auto drained = std::make_shared<bool>(false);
+
+        session->beginStream(boost::beast::http::status::ok, "application/json", [state, drained] {
+            std::lock_guard<std::mutex> lock(state->first);
+            *drained = true;
+            state->second.notify_one();
+        });
+
+        producer = std::thread([session, state, drained, future = headerReceived.get_future()]() mutable {
+            future.wait();
+
+            std::string chunk(10000, 'x');
+            for (int i = 0; i < 100; ++i)
+            {
+                if (session->writeChunk(chunk))
+                    continue;
+
+                std::unique_lock<std::mutex> lock(state->first);
+                state->second.wait(lock, [&] { return *drained; });
+                *drained = false;
+            }
+
+            session->endStream();
+        });
+    });
+
+    Connection connection(server);
+    connection.send(request("/export") + request("/echo/1"));
+
+    // the header is sent before the first chunk was produced
+    boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+    connection.receiveHeader(parser);
+    BOOST_CHECK(parser.get().chunked());
+    headerReceived.set_value();
+
+    connection.receive(parser);
+    BOOST_CHECK_EQUAL(parser.get().body().size(), 1000000);
+    BOOST_CHECK(parser.get().body().find_first_not_of('x') == std::string::npos);
+
+    // the pipelined request is answered after the stream
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+
+    producer.join();
+}
+
+BOOST_AUTO_TEST_CASE(streamResponseHttp10)
+{
+    auto server = makeServer(16);
+    server->registerEndpoint("/export", [](std::shared_ptr<Session> session, const Request&) {
+        session->beginStream(boost::beast::http::status::ok, "text/plain");
+        session->writeChunk("hello");
+        session->writeChunk(" world");
+        session->endStream();
+
+        // the stream was answered already
+        session->sendResponse({});
+    });
+
+    // without chunks the end of the body is the end of the connection
+    Connection connection(server);
+    connection.send("GET /export HTTP/1.0\r\n\r\n");
+    auto response = connection.receive();
+    BOOST_CHECK(!response.chunked());
+    BOOST_CHECK_EQUAL(response.body(), "hello world");
+    BOOST_CHECK(connection.closedByServer());
+}
+
+BOOST_AUTO_TEST_CASE(sendFile)
+{
+    std::string content;
+    for (int i = 0; i < 100000; ++i) content += std::to_string(i) + "\n";
+
+    TemporaryDirectory directory;
+    std::string path = directory.write("content.json", content);
+
+    // the body is sent by the kernel or read by the session - the responses around it are the same
+    for (bool zeroCopy : {true, false})
+    {
+        auto server = makeServer(16);
+        server->setZeroCopyFiles(zeroCopy);
+        server->registerEndpoint("/file", [&path](std::shared_ptr<Session> session, const Request&) {
+            session->sendFile(path);
+        });
+
+        Connection connection(server);
+        connection.send(request("/echo/1") + request("/file") + request("/file") + request("/echo/2"));
+
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+
+        for (int i = 0; i < 2; ++i)
+        {
+            boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+            connection.receive(parser);
+            BOOST_CHECK_EQUAL(parser.get()[boost::beast::http::field::content_type], "application/json");
+            BOOST_CHECK(parser.get().body() == content);
+        }
+
+        BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"2\"}");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cachedFile)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("index.html", "<html></html>");
+
+    auto cache = std::make_shared<StaticFileCache>();
+    auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+    server->setStaticFileCache(cache);
+    server->registerEndpoint("/file", [&path](std::shared_ptr<Session> session, const Request&) {
+        session->sendFile(path);
+    });
+    server->registerEndpoint("/echo/{id}", [](std::shared_ptr<Session> session, const Request& request) {
+        session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+    });
+    server->startListening(0);
+
+    Connection connection(server);
+    connection.send(request("/file"));
+
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "text/html");
+    BOOST_CHECK_EQUAL(response.body(), "<html></html>");
+    BOOST_CHECK(StaticFileCache::parseHttpDate(std::string(response[boost::beast::http::field::date])) > 0);
+
+    std::string etag(response[boost::beast::http::field::etag]);
+    std::string lastModified(response[boost::beast::http::field::last_modified]);
+    BOOST_CHECK(!etag.empty());
+    BOOST_CHECK(!lastModified.empty());
+
+    // conditional requests are answered without a body - the next request of the pipeline follows right after
+    connection.send("GET /file HTTP/1.1\r\nIf-None-Match: " + etag + "\r\n\r\n" +
+                    "GET /file HTTP/1.1\r\nIf-Modified-Since: " + lastModified + "\r\n\r\n" + request("/echo/1"));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::not_modified);
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::etag], etag);
+        BOOST_CHECK(response.body().empty());
+    }
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"1\"}");
+
+    // a HEAD request gets the header of the cached response
+    connection.send("HEAD /file HTTP/1.1\r\n\r\n" + request("/echo/2"));
+    boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+    parser.skip(true);
+    connection.receive(parser);
+    BOOST_CHECK_EQUAL(parser.get()[boost::beast::http::field::content_length], "13");
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"2\"}");
+
+    BOOST_CHECK_EQUAL(cache->metrics().misses, 1);
+    BOOST_CHECK_EQUAL(cache->metrics().hits, 3);
+
+    // HTTP/1.0 clients without keep-alive are answered and disconnected
+    connection.send("GET /file HTTP/1.0\r\n\r\n");
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.body(), "<html></html>");
+    BOOST_CHECK(connection.closedByServer());
+}
+
+BOOST_AUTO_TEST_CASE(compression)
+{
+    nlohmann::json items = nlohmann::json::array();
+    for (int i = 0; i < 1000; ++i) items.push_back({{"id", i}, {"name", "item"}});
+
+    // the second endpoint produces a body that is compressed by a worker
+    nlohmann::json largeItems = nlohmann::json::array();
+    for (int i = 0; i < 20000; ++i) largeItems.push_back({{"id", i}, {"name", "item"}});
+
+    auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+    server->setCompression({6, 64, 256 * 1024, true});
+    server->registerEndpoint("/items", [&items](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse(items);
+    });
+    server->registerEndpoint("/large", [&largeItems](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse(largeItems);
+    });
+    server->registerEndpoint(
+        "/raw", [&items](std::shared_ptr<Session> session, const Request&) { session->sendResponse(items); },
+        EndpointOptions {false, 0, false});
+    server->registerEndpoint("/echo/{id}", [](std::shared_ptr<Session> session, const Request& request) {
+        session->sendResponse({{"id", std::string(request.pathParameters().get("id").value_or(""))}});
+    });
+    server->startListening(0);
+
+    Connection connection(server);
+    auto get = [](const std::string& target, const std::string& acceptEncoding) {
+        return "GET " + target + " HTTP/1.1\r\nAccept-Encoding: " + acceptEncoding + "\r\n\r\n";
+    };
+
+    connection.send(get("/items", "gzip, deflate") + get("/items", "deflate") + get("/items", "br") + request("/echo/1")
+                    + get("/raw", "gzip"));
+
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_encoding], "gzip");
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::vary], "Accept-Encoding");
+    BOOST_CHECK(response.body().size() < items.dump().size() / 4);
+    BOOST_CHECK(decompress(response.body()) == items.dump());
+
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_encoding], "deflate");
+    BOOST_CHECK(decompress(response.body()) == items.dump());
+
+    // an encoding we can't produce
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::content_encoding), 0);
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::vary], "Accept-Encoding");
+    BOOST_CHECK(response.body() == items.dump());
+
+    // too small to be compressed - without binary JSON the response doesn't depend on the request headers
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::vary), 0);
+    BOOST_CHECK_EQUAL(response.body(), "{\"id\":\"1\"}");
+
+    // the endpoint opted out
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::content_encoding), 0);
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::vary), 0);
+    BOOST_CHECK(response.body() == items.dump());
+
+    // the responses after a body that is compressed by a worker keep their order
+    connection.send(request("/echo/2") + get("/large", "gzip") + request("/echo/3"));
+
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"2\"}");
+    response = connection.receive();
+    BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_encoding], "gzip");
+    BOOST_CHECK(decompress(response.body()) == largeItems.dump());
+    BOOST_CHECK_EQUAL(connection.receive().body(), "{\"id\":\"3\"}");
+}
+
+BOOST_AUTO_TEST_CASE(compressionOptIn)
+{
+    nlohmann::json items = nlohmann::json::array();
+    for (int i = 0; i < 1000; ++i) items.push_back({{"id", i}, {"name", "item"}});
+
+    // without setCompression the responses are sent as they are
+    auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+    BOOST_CHECK_EQUAL(server->compression().level, 0);
+    server->registerEndpoint("/items", [&items](std::shared_ptr<Session> session, const Request&) {
+        session->sendResponse(items);
+    });
+    server->startListening(0);
+
+    Connection connection(server);
+    connection.send("GET /items HTTP/1.1\r\nAccept-Encoding: gzip, deflate\r\n\r\n");
+
+    auto response = connection.receive();
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::content_encoding), 0);
+    BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::vary), 0);
+    BOOST_CHECK(response.body() == items.dump());
+}
+
+BOOST_AUTO_TEST_CASE(precompressedFile)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("app.js", "var a = 1;");
+    directory.write("app.js.gz", "gzip bytes");
+    directory.write("app.js.br", "brotli bytes");
+
+    // the same answers from the file system and from the cache
+    for (bool cached : {false, true})
+    {
+        auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+        if (cached)
+            server->setStaticFileCache(std::make_shared<StaticFileCache>());
+        server->registerEndpoint("/app.js", [&path](std::shared_ptr<Session> session, const Request&) {
+            session->sendFile(path);
+        });
+        server->startListening(0);
+
+        Connection connection(server);
+        auto get = [](const std::string& acceptEncoding) {
+            return "GET /app.js HTTP/1.1\r\nAccept-Encoding: " + acceptEncoding + "\r\n\r\n";
+        };
+
+        connection.send(get("gzip, br") + get("gzip, br;q=0.5") + get("gzip;q=0.1, identity") + get("deflate")
+                        + request("/app.js"));
+
+        auto response = connection.receive();
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_encoding], "br");
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_type], "application/javascript");
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::vary], "Accept-Encoding");
+        BOOST_CHECK_EQUAL(response.body(), "brotli bytes");
+
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_encoding], "gzip");
+        BOOST_CHECK_EQUAL(response.body(), "gzip bytes");
+
+        // the file itself depends on Accept-Encoding as well
+        for (int i = 0; i < 3; ++i)
+        {
+            response = connection.receive();
+            BOOST_CHECK_EQUAL(response.count(boost::beast::http::field::content_encoding), 0);
+            BOOST_CHECK_EQUAL(response[boost::beast::http::field::vary], "Accept-Encoding");
+            BOOST_CHECK_EQUAL(response.body(), "var a = 1;");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ranges)
+{
+    std::string content;
+    for (int i = 0; content.size() < 100000; ++i) content += std::to_string(i) + "\n";
+
+    TemporaryDirectory directory;
+    std::string path = directory.write("content.txt", content);
+
+    auto get = [](const std::string& headers) { return "GET /file HTTP/1.1\r\n" + headers + "\r\n"; };
+
+    // sent by the kernel, read by the session and copied from the cache
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        auto server = std::make_shared<RestServer>("127.0.0.1", 0);
+        server->setZeroCopyFiles(mode == 0);
+        if (mode == 2)
+            server->setStaticFileCache(std::make_shared<StaticFileCache>(1024 * 1024, 1024 * 1024));
+        server->registerEndpoint("/file", [&path](std::shared_ptr<Session> session, const Request&) {
+            session->sendFile(path);
+        });
+        server->startListening(0);
+
+        Connection connection(server);
+
+        // the validators of the whole file are needed for If-Range
+        connection.send(get(""));
+        auto response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::accept_ranges], "bytes");
+        BOOST_CHECK(response.body() == content);
+        std::string etag(response[boost::beast::http::field::etag]);
+        std::string lastModified(response[boost::beast::http::field::last_modified]);
+
+        connection.send(get("Range: bytes=10-19\r\n") + get("Range: bytes=-5\r\n") + get("Range: bytes=99990-\r\n")
+                        + get("Range: bytes=" + std::to_string(content.size()) + "-\r\n")
+                        + get("Range: bytes=0-4\r\nIf-Range: " + etag + "\r\n")
+                        + get("Range: bytes=0-4\r\nIf-Range: \"other\"\r\n")
+                        + get("Range: bytes=0-4\r\nIf-Range: " + lastModified + "\r\n"));
+
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::partial_content);
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_range],
+                          "bytes 10-19/" + std::to_string(content.size()));
+        BOOST_CHECK_EQUAL(response.body(), content.substr(10, 10));
+
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.body(), content.substr(content.size() - 5));
+
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.body(), content.substr(99990));
+
+        // the range starts behind the file
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::range_not_satisfiable);
+        BOOST_CHECK_EQUAL(response[boost::beast::http::field::content_range],
+                          "bytes */" + std::to_string(content.size()));
+        BOOST_CHECK(response.body().empty());
+
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::partial_content);
+        BOOST_CHECK_EQUAL(response.body(), content.substr(0, 5));
+
+        // the file changed - it is sent completely
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::ok);
+        BOOST_CHECK(response.body() == content);
+
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::partial_content);
+        BOOST_CHECK_EQUAL(response.body(), content.substr(0, 5));
+
+        // several ranges are sent as multipart/byteranges
+        connection.send(get("Range: bytes=0-4, 100-109,-3\r\n"));
+        response = connection.receive();
+        BOOST_CHECK_EQUAL(response.result(), boost::beast::http::status::partial_content);
+
+        std::string contentType(response[boost::beast::http::field::content_type]);
+        std::string prefix = "multipart/byteranges; boundary=";
+        BOOST_REQUIRE(contentType.substr(0, prefix.size()) == prefix);
+        std::string boundary = contentType.substr(prefix.size());
+
+        std::string expected;
+        std::string size = std::to_string(content.size());
+        for (auto [first, last] : {std::pair<std::size_t, std::size_t> {0, 4}, {100, 109},
+                                   {content.size() - 3, content.size() - 1}})
+            expected += "\r\n--" + boundary + "\r\nContent-Type: text/plain\r\nContent-Range: bytes "
+                        + std::to_string(first) + "-" + std::to_string(last) + "/" + size + "\r\n\r\n"
+                        + content.substr(first, last - first + 1);
+        expected += "\r\n--" + boundary + "--\r\n";
+        BOOST_CHECK_EQUAL(response.body(), expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
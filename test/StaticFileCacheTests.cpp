@@ -0,0 +1,246 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPStaticFileCache"
+
+#include <rgpaul/StaticFileCache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/beast/core/file.hpp>
+#include <boost/filesystem.hpp>
+
+#include "TemporaryDirectory.hpp"
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// the watcher runs on a thread of its own
+bool waitForCount(const StaticFileCache& cache, std::size_t count)
+{
+    for (int i = 0; i < 200 && cache.count() != count; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return cache.count() == count;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPStaticFileCache)
+
+BOOST_AUTO_TEST_CASE(httpDates)
+{
+    BOOST_CHECK_EQUAL(StaticFileCache::formatHttpDate(784111777), "Sun, 06 Nov 1994 08:49:37 GMT");
+    BOOST_CHECK_EQUAL(StaticFileCache::formatHttpDate(0), "Thu, 01 Jan 1970 00:00:00 GMT");
+    BOOST_CHECK_EQUAL(StaticFileCache::formatHttpDate(951782400), "Tue, 29 Feb 2000 00:00:00 GMT");
+
+    BOOST_CHECK_EQUAL(StaticFileCache::parseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT"), 784111777);
+    BOOST_CHECK_EQUAL(StaticFileCache::parseHttpDate("Tue, 29 Feb 2000 00:00:00 GMT"), 951782400);
+
+    // only the fixed format is accepted
+    BOOST_CHECK_EQUAL(StaticFileCache::parseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT"), -1);
+    BOOST_CHECK_EQUAL(StaticFileCache::parseHttpDate("Sun, 06 Foo 1994 08:49:37 GMT"), -1);
+    BOOST_CHECK_EQUAL(StaticFileCache::parseHttpDate(""), -1);
+}
+
+BOOST_AUTO_TEST_CASE(get)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("index.html", "<html></html>");
+
+    StaticFileCache cache;
+    auto entry = cache.get(path);
+    BOOST_REQUIRE(entry);
+    BOOST_CHECK_EQUAL(entry->body, "<html></html>");
+    BOOST_CHECK(entry->fields.find("Content-Type: text/html\r\n") != std::string::npos);
+    BOOST_CHECK(entry->fields.find("Content-Length: 13\r\n") != std::string::npos);
+    BOOST_CHECK(entry->fields.find("ETag: " + entry->etag + "\r\n") != std::string::npos);
+    BOOST_CHECK(entry->notModifiedFields.find("Content-Length") == std::string::npos);
+    BOOST_CHECK_EQUAL(entry->etag.front(), '"');
+
+    // the second request is a hit
+    BOOST_CHECK(cache.get(path) == entry);
+    BOOST_CHECK_EQUAL(cache.metrics().hits, 1);
+    BOOST_CHECK_EQUAL(cache.metrics().misses, 1);
+
+    // missing and too large files are not cached
+    BOOST_CHECK(!cache.get(path + ".missing"));
+    StaticFileCache smallCache(1024, 4);
+    BOOST_CHECK(!smallCache.get(path));
+    BOOST_CHECK_EQUAL(smallCache.count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(notModified)
+{
+    StaticFileCache::Entry entry;
+    entry.etag = "\"d-1234\"";
+    entry.modified = 784111777;
+
+    BOOST_CHECK(StaticFileCache::notModified(entry, "\"d-1234\"", ""));
+    BOOST_CHECK(StaticFileCache::notModified(entry, "\"a\", W/\"d-1234\"", ""));
+    BOOST_CHECK(StaticFileCache::notModified(entry, "*", ""));
+    BOOST_CHECK(!StaticFileCache::notModified(entry, "\"a\"", ""));
+
+    BOOST_CHECK(StaticFileCache::notModified(entry, "", "Sun, 06 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(StaticFileCache::notModified(entry, "", "Mon, 07 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(!StaticFileCache::notModified(entry, "", "Sat, 05 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(!StaticFileCache::notModified(entry, "", "yesterday"));
+
+    // If-Modified-Since is ignored if there is an If-None-Match
+    BOOST_CHECK(!StaticFileCache::notModified(entry, "\"a\"", "Sun, 06 Nov 1994 08:49:37 GMT"));
+    BOOST_CHECK(!StaticFileCache::notModified(entry, "", ""));
+}
+
+BOOST_AUTO_TEST_CASE(eviction)
+{
+    TemporaryDirectory directory;
+    std::string content(1000, 'x');
+    std::string a = directory.write("a.txt", content);
+    std::string b = directory.write("b.txt", content);
+    std::string c = directory.write("c.txt", content);
+
+    // room for two files with their header fields
+    StaticFileCache cache(2 * 1000 + 1000, 1000);
+    BOOST_REQUIRE(cache.get(a));
+    BOOST_REQUIRE(cache.get(b));
+
+    // a becomes the most recently used file, so b is evicted
+    cache.get(a);
+    cache.get(c);
+
+    BOOST_CHECK_EQUAL(cache.count(), 2);
+    BOOST_CHECK(cache.size() <= cache.capacity());
+    BOOST_CHECK_EQUAL(cache.metrics().evictions, 1);
+
+    cache.get(a);
+    BOOST_CHECK_EQUAL(cache.metrics().misses, 3);
+    cache.get(b);
+    BOOST_CHECK_EQUAL(cache.metrics().misses, 4);
+
+    cache.invalidate(a);
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.count(), 0);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+#if defined(__linux__)
+BOOST_AUTO_TEST_CASE(invalidation)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("app.js", "var a = 1;");
+    std::string other = directory.write("app.css", "body {}");
+
+    StaticFileCache cache;
+    auto entry = cache.get(path);
+    BOOST_REQUIRE(entry);
+    BOOST_REQUIRE(cache.get(other));
+
+    // only the changed file is dropped
+    directory.write("app.js", "var a = 2;");
+    BOOST_CHECK(waitForCount(cache, 1));
+    BOOST_CHECK(cache.metrics().invalidations >= 1);
+
+    auto changed = cache.get(path);
+    BOOST_REQUIRE(changed);
+    BOOST_CHECK_EQUAL(changed->body, "var a = 2;");
+    BOOST_CHECK(changed->etag != entry->etag);
+
+    // the old entry is still valid for the responses that use it
+    BOOST_CHECK_EQUAL(entry->body, "var a = 1;");
+
+    boost::filesystem::remove(other);
+    BOOST_CHECK(waitForCount(cache, 1));
+    BOOST_CHECK(!cache.get(other));
+}
+#endif
+
+#if defined(__linux__)
+BOOST_AUTO_TEST_CASE(unrelatedChanges)
+{
+    TemporaryDirectory directory;
+    std::vector<std::string> paths;
+    for (int i = 0; i < 20; ++i) paths.push_back(directory.write("file" + std::to_string(i) + ".txt", "content"));
+
+    StaticFileCache cache;
+    BOOST_REQUIRE(cache.get(paths[0]));
+
+    // a file next to the cached ones that changes all the time (e.g. a log) neither drops them nor keeps new files out
+    // of the cache
+    std::atomic<bool> stop {false};
+    std::thread writer([&] {
+        for (int i = 0; !stop; ++i) directory.write("access.log", std::to_string(i));
+    });
+
+    for (const auto& path : paths)
+    {
+        BOOST_CHECK(cache.get(path));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    stop = true;
+    writer.join();
+
+    BOOST_CHECK_EQUAL(cache.count(), paths.size());
+    BOOST_CHECK_EQUAL(cache.metrics().invalidations, 0);
+
+    // the cached files themselves are still watched
+    directory.write("file3.txt", "changed");
+    BOOST_CHECK(waitForCount(cache, paths.size() - 1));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(precompressed)
+{
+    TemporaryDirectory directory;
+    std::string path = directory.write("app.css", "body {}");
+    directory.write("app.css.gz", "gzip");
+    directory.write("app.css.zst", "zstd");
+
+    StaticFileCache cache;
+    auto entry = cache.get(path);
+    BOOST_REQUIRE(entry);
+    BOOST_REQUIRE_EQUAL(entry->variants.size(), 2);
+    BOOST_CHECK(entry->fields.find("Vary: Accept-Encoding\r\n") != std::string::npos);
+
+    // in the order of Compression::kPrecompressed - with the content type of the file
+    const auto& zstd = *entry->variants[0];
+    BOOST_CHECK(zstd.encoding == Compression::Encoding::Zstd);
+    BOOST_CHECK_EQUAL(zstd.body, "zstd");
+    BOOST_CHECK(zstd.fields.find("Content-Type: text/css\r\n") != std::string::npos);
+    BOOST_CHECK(zstd.fields.find("Content-Encoding: zstd\r\n") != std::string::npos);
+    BOOST_CHECK(zstd.etag != entry->etag);
+    BOOST_CHECK(entry->variants[1]->encoding == Compression::Encoding::Gzip);
+
+#if defined(__linux__)
+    // a new sibling drops the file
+    directory.write("app.css.br", "brotli");
+    BOOST_CHECK(waitForCount(cache, 0));
+    BOOST_CHECK_EQUAL(cache.get(path)->variants.size(), 3);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,64 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <string>
+
+#include <boost/beast/core/file.hpp>
+#include <boost/filesystem.hpp>
+
+namespace
+{
+// a temporary directory that is removed with all files in it
+class TemporaryDirectory
+{
+  public:
+    TemporaryDirectory() : _path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+    {
+        boost::filesystem::create_directory(_path);
+    }
+
+    ~TemporaryDirectory()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(_path, ec);
+    }
+
+    // the path of a file in the directory - it isn't created
+    std::string path(const std::string& name) const { return (_path / name).string(); }
+
+    std::string write(const std::string& name, const std::string& content) const
+    {
+        std::string path = this->path(name);
+
+        boost::beast::error_code ec;
+        boost::beast::file file;
+        file.open(path.c_str(), boost::beast::file_mode::write, ec);
+        file.write(content.data(), content.size(), ec);
+
+        return path;
+    }
+
+  private:
+    boost::filesystem::path _path;
+};
+}  // namespace
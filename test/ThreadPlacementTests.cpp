@@ -0,0 +1,118 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPThreadPlacement"
+
+#include <rgpaul/ThreadPlacement.hpp>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+BOOST_AUTO_TEST_SUITE(RGPThreadPlacement)
+
+BOOST_AUTO_TEST_CASE(none)
+{
+    ThreadPlacement placement;
+
+    BOOST_CHECK(placement.policy() == ThreadPlacement::Policy::None);
+    BOOST_CHECK(placement.cpus().empty());
+    BOOST_CHECK_EQUAL(placement.cpuForThread(0), -1);
+}
+
+BOOST_AUTO_TEST_CASE(cpus)
+{
+    ThreadPlacement placement = ThreadPlacement::onCpus({2, 5}).bindMemory(false);
+
+    BOOST_CHECK(placement.policy() == ThreadPlacement::Policy::Cpus);
+    BOOST_CHECK(!placement.bindsMemory());
+
+    // the threads are distributed round robin
+    BOOST_CHECK_EQUAL(placement.cpuForThread(0), 2);
+    BOOST_CHECK_EQUAL(placement.cpuForThread(1), 5);
+    BOOST_CHECK_EQUAL(placement.cpuForThread(2), 2);
+}
+
+BOOST_AUTO_TEST_CASE(topology)
+{
+    std::vector<unsigned> available = ThreadPlacement::availableCpus();
+    BOOST_REQUIRE(!available.empty());
+
+    // every physical core is represented by one of the available cpus
+    ThreadPlacement placement = ThreadPlacement::onPhysicalCores();
+    BOOST_CHECK(!placement.cpus().empty());
+    BOOST_CHECK_LE(placement.cpus().size(), available.size());
+
+    for (unsigned cpu : placement.cpus())
+        BOOST_CHECK(std::find(available.begin(), available.end(), cpu) != available.end());
+
+    BOOST_CHECK(ThreadPlacement::nicQueueCpus("rgp-does-not-exist").empty());
+    BOOST_CHECK(ThreadPlacement::onNicQueues("rgp-does-not-exist").cpus().empty());
+}
+
+#if defined(__linux__)
+BOOST_AUTO_TEST_CASE(apply)
+{
+    unsigned cpu = ThreadPlacement::availableCpus().back();
+    ThreadPlacement placement = ThreadPlacement::onCpus({cpu});
+
+    std::vector<unsigned> pinned;
+    char name[16] {};
+
+    std::thread thread([&] {
+        placement.apply(0, "rgp-test-thread-name");
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+
+        for (unsigned i = 0; i < CPU_SETSIZE; ++i)
+        {
+            if (CPU_ISSET(i, &set))
+                pinned.push_back(i);
+        }
+
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+    });
+
+    thread.join();
+
+    BOOST_REQUIRE_EQUAL(pinned.size(), 1);
+    BOOST_CHECK_EQUAL(pinned.front(), cpu);
+
+    // names are truncated to the 15 characters Linux allows
+    BOOST_CHECK_EQUAL(std::string(name), "rgp-test-thread");
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPTimingWheel"
+
+#include <rgpaul/TimingWheel.hpp>
+
+#include <chrono>
+#include <memory>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_SUITE(RGPTimingWheel)
+
+BOOST_AUTO_TEST_CASE(expires)
+{
+    boost::asio::io_context context;
+    TimingWheel::Deadline deadline;
+    int calls = 0;
+    deadline.setHandler([&] { ++calls; });
+
+    auto start = std::chrono::steady_clock::now();
+    deadline.expiresAfter(context, 200ms);
+    BOOST_CHECK(deadline.armed());
+    BOOST_CHECK(!deadline.expired());
+
+    // the wheel stops ticking once its last deadline expired
+    context.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK_EQUAL(calls, 1);
+    BOOST_CHECK(deadline.expired());
+    BOOST_CHECK(elapsed >= 200ms);
+    BOOST_CHECK(elapsed < 200ms + 3 * TimingWheel::kTick);
+}
+
+BOOST_AUTO_TEST_CASE(later)
+{
+    boost::asio::io_context context;
+    TimingWheel::Deadline deadline;
+    int calls = 0;
+    deadline.setHandler([&] { ++calls; });
+
+    auto start = std::chrono::steady_clock::now();
+    deadline.expiresAfter(context, 100ms);
+
+    // a keep-alive connection moves its deadline with every request
+    boost::asio::steady_timer timer(context, 50ms);
+    timer.async_wait([&](auto) { deadline.expiresAfter(context, 400ms); });
+
+    context.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK_EQUAL(calls, 1);
+    BOOST_CHECK(elapsed >= 450ms);
+}
+
+BOOST_AUTO_TEST_CASE(earlier)
+{
+    boost::asio::io_context context;
+    TimingWheel::Deadline deadline;
+    int calls = 0;
+    deadline.setHandler([&] { ++calls; });
+
+    auto start = std::chrono::steady_clock::now();
+    deadline.expiresAfter(context, 10s);
+    deadline.expiresAfter(context, 100ms);
+
+    context.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    BOOST_CHECK_EQUAL(calls, 1);
+    BOOST_CHECK(elapsed < 1s);
+}
+
+BOOST_AUTO_TEST_CASE(disarmed)
+{
+    boost::asio::io_context context;
+    TimingWheel::Deadline deadline;
+    int calls = 0;
+    deadline.setHandler([&] { ++calls; });
+
+    deadline.expiresAfter(context, 100ms);
+    deadline.expiresNever();
+    BOOST_CHECK(!deadline.armed());
+
+    // the wheel drops the deadline when it visits its slot
+    context.run();
+    BOOST_CHECK_EQUAL(calls, 0);
+    BOOST_CHECK(!deadline.expired());
+
+    // disarmed and armed again before the wheel noticed
+    context.restart();
+    deadline.expiresAfter(context, 100ms);
+    deadline.expiresNever();
+    deadline.expiresAfter(context, 200ms);
+
+    context.run();
+    BOOST_CHECK_EQUAL(calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE(destroyed)
+{
+    boost::asio::io_context context;
+    std::shared_ptr<TimingWheel> wheel = TimingWheel::local(context);
+    int calls = 0;
+
+    {
+        TimingWheel::Deadline deadline;
+        deadline.setHandler([&] { ++calls; });
+        deadline.expiresAfter(context, 10s);
+
+        BOOST_CHECK_EQUAL(wheel->size(), 1);
+        BOOST_CHECK(TimingWheel::local(context) == wheel);
+    }
+
+    // nothing keeps the context busy anymore
+    BOOST_CHECK_EQUAL(wheel->size(), 0);
+    context.run();
+    BOOST_CHECK_EQUAL(calls, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+/*
+ -----------------------------------------------------------------------------------------------------------------------
+ The MIT License (MIT)
+
+ Copyright (c) 2020 Ralph-Gordon Paul. All rights reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ -----------------------------------------------------------------------------------------------------------------------
+*/
+
+// define the module name (prints at testing)
+#define BOOST_TEST_MODULE "RGPWorkStealingPool"
+
+#include <rgpaul/WorkStealingPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+// include this last
+#include <boost/test/included/unit_test.hpp>
+
+using namespace rgpaul;
+
+namespace
+{
+// blocks the workers until it is opened
+class Gate
+{
+  public:
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _open; });
+    }
+
+    void open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _open = true;
+        }
+
+        _condition.notify_all();
+    }
+
+  private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _open {false};
+};
+
+void waitFor(const std::atomic<int>& value, int expected)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (value < expected && std::chrono::steady_clock::now() < end) std::this_thread::yield();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RGPWorkStealingPool)
+
+BOOST_AUTO_TEST_CASE(execute)
+{
+    std::atomic<int> executed {0};
+
+    {
+        WorkStealingPool pool(4);
+        BOOST_CHECK_EQUAL(pool.threadCount(), 4);
+
+        for (int i = 0; i < 1000; ++i) BOOST_CHECK(pool.submit([&executed] { ++executed; }));
+
+        waitFor(executed, 1000);
+        BOOST_CHECK_EQUAL(pool.metrics().executed, 1000);
+        BOOST_CHECK_EQUAL(pool.metrics().queueDepths.size(), 4);
+    }
+
+    // the destructor joins the workers - nothing is left behind
+    BOOST_CHECK_EQUAL(executed, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(steal)
+{
+    WorkStealingPool pool(4);
+    std::atomic<int> executed {0};
+    std::mutex threadsMutex;
+    std::set<std::thread::id> threads;
+
+    // tasks that are submitted by a worker end up in its own deque - the others have to steal them
+    pool.submit([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            pool.submit([&] {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+                std::lock_guard<std::mutex> lock(threadsMutex);
+                threads.insert(std::this_thread::get_id());
+                ++executed;
+            });
+        }
+    });
+
+    waitFor(executed, 200);
+    BOOST_CHECK_EQUAL(executed, 200);
+    BOOST_CHECK_GT(pool.metrics().stolen, 0);
+    BOOST_CHECK_GT(threads.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(order)
+{
+    Gate gate;
+    std::atomic<int> executed {0};
+    std::mutex orderMutex;
+    std::vector<int> order;
+
+    WorkStealingPool pool(1);
+
+    auto record = [&](int value) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(value);
+        ++executed;
+    };
+
+    pool.submit([&] { gate.wait(); });
+
+    // tasks from outside run in the order they were submitted - the tasks of the worker itself newest first
+    for (int i = 0; i < 3; ++i)
+    {
+        pool.submit([&, i] {
+            record(i);
+
+            if (i == 0)
+                for (int j = 10; j < 13; ++j) pool.submit([&, j] { record(j); });
+        });
+    }
+
+    gate.open();
+    waitFor(executed, 6);
+
+    std::lock_guard<std::mutex> lock(orderMutex);
+    BOOST_CHECK((order == std::vector<int> {0, 12, 11, 10, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(boundedQueues)
+{
+    Gate gate;
+    std::atomic<int> started {0};
+    std::atomic<int> executed {0};
+
+    WorkStealingPool pool(2, 4);
+
+    // occupy both workers
+    for (int i = 0; i < 2; ++i)
+    {
+        pool.submit([&] {
+            ++started;
+            gate.wait();
+        });
+    }
+
+    waitFor(started, 2);
+
+    // two deques with four tasks each
+    for (int i = 0; i < 8; ++i) BOOST_CHECK(pool.submit([&executed] { ++executed; }));
+    BOOST_CHECK(!pool.submit([&executed] { ++executed; }));
+
+    WorkStealingPool::Metrics metrics = pool.metrics();
+    BOOST_CHECK_EQUAL(metrics.queueDepths[0] + metrics.queueDepths[1], 8);
+    BOOST_CHECK_EQUAL(metrics.rejected, 1);
+
+    gate.open();
+    waitFor(executed, 8);
+    BOOST_CHECK_EQUAL(executed, 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()